@@ -2,9 +2,9 @@
 
 #include <vector>
 #include <sstream>
-#include <thread>
-#include <atomic>
 #include <string>
+#include <stdexcept>
+#include <tuple>
 #include <iomanip>
 #include "ReportServerInterface.h"
 #include <rapidjson/document.h>
@@ -13,8 +13,27 @@
 #include "utils/Utils.h"
 #include "structures/ValidationResult.h"
 #include "validators/RequestValidator.h"
+#include "filters/LogFilters.h"
+#include "cache/DayCache.h"
+#include "sessions/Sessionizer.h"
+#include "anomalies/RateAnomalyDetector.h"
+#include "collapse/LogCollapser.h"
+#include "exporters/LogExporter.h"
+#include "fetch/FetchScheduler.h"
+#include "pipeline/ReportPipeline.h"
+#include "sampling/Sampling.h"
+#include "sketches/HyperLogLog.h"
+#include "records/CompactLogStore.h"
+#include "memory/RequestArena.h"
+#include "logging/AsyncLogger.h"
+#include "tracing/Tracer.h"
+#include "snapshots/LogSnapshot.h"
+#include "capture/CaptureWriter.h"
+#include "metrics/MetricsRegistry.h"
+#include "runtime/PluginRuntime.h"
 #include "structures/ReportStructures.h"
 #include "structures/ReportType.h"
+#include "structures/LogFilter.h"
 
 using namespace ast;
 
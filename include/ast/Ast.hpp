@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <variant>
@@ -18,6 +20,7 @@ namespace ast {
     struct JSONValue;
     using JSONArray  = std::vector<JSONValue>;
     using JSONObject = std::map<std::string, JSONValue>;
+    using JSONIntArray = std::vector<int64_t>;
 
     /**
      * Represents a dynamic JSON-like value that can store:
@@ -26,17 +29,43 @@ namespace ast {
      * - bool
      * - array (JSONArray)
      * - object (JSONObject)
+     * - array of integers (JSONIntArray), serialized without a fractional part
      */
     struct JSONValue {
-        std::variant<std::string, double, bool, JSONArray, JSONObject> value;
+        std::variant<std::string, double, bool, JSONArray, JSONObject, JSONIntArray> value;
 
         JSONValue() = default;
         JSONValue(const char* s) : value(std::string(s)) {}
         JSONValue(const std::string& s) : value(s) {}
+        JSONValue(std::string&& s) : value(std::move(s)) {}
+        JSONValue(std::string_view s) : value(std::string(s)) {}
         JSONValue(double d) : value(d) {}
         JSONValue(bool b) : value(b) {}
         JSONValue(const JSONArray& arr) : value(arr) {}
+        JSONValue(JSONArray&& arr) : value(std::move(arr)) {}
         JSONValue(const JSONObject& obj) : value(obj) {}
+        JSONValue(JSONObject&& obj) : value(std::move(obj)) {}
+        JSONValue(JSONIntArray ints) : value(std::move(ints)) {}
+    };
+
+    // ====================== Node type ======================
+
+    /**
+     * Node type name: a compile-time literal from TAG / TAG_WITH_TYPE, held by reference
+     * instead of an owned std::string per node. to_json copies it into the allocator, since
+     * the response belongs to the host and may outlive the plugin's .rodata.
+     */
+    class NodeType {
+    public:
+        consteval NodeType(const char* name) : _name(name) {}
+
+        const char*      c_str() const { return _name.data(); }
+        std::string_view view() const { return _name; }
+
+        friend bool operator==(NodeType lhs, NodeType rhs) { return lhs._name == rhs._name; }
+
+    private:
+        std::string_view _name;
     };
 
     // Recursive serialization for JSONValue
@@ -64,6 +93,12 @@ namespace ast {
                     to_json_value(v, val, alloc);
                     out.AddMember(key, val, alloc);
                 }
+            } else if constexpr (std::is_same_v<T, JSONIntArray>) {
+                out.SetArray();
+                out.Reserve(static_cast<SizeType>(arg.size()), alloc);
+                for (const int64_t el : arg) {
+                    out.PushBack(Value().SetInt64(el), alloc);
+                }
             }
         }, jv.value);
     }
@@ -71,7 +106,7 @@ namespace ast {
     // ====================== Node AST ======================
 
     struct Node {
-        std::string type;
+        NodeType type;
         JSONObject props;
         std::vector<Node> children;
     };
@@ -79,7 +114,7 @@ namespace ast {
     // ---------- Constructors ----------
 
     inline Node element(
-        const std::string& type,
+        NodeType type,
         std::vector<Node> children = {},
         JSONObject props = {}
     ) {
@@ -166,6 +201,7 @@ namespace ast {
     TAG_WITH_TYPE(Brush, "Recharts.Brush")
     TAG_WITH_TYPE(ReferenceLine, "Recharts.ReferenceLine")
     TAG_WITH_TYPE(ReferenceDot, "Recharts.ReferenceDot")
+    TAG_WITH_TYPE(ErrorBar, "Recharts.ErrorBar")
     TAG_WITH_TYPE(ComposedChart, "Recharts.ComposedChart")
     TAG_WITH_TYPE(ScatterChart, "Recharts.ScatterChart")
     TAG_WITH_TYPE(Scatter, "Recharts.Scatter")
@@ -189,7 +225,8 @@ namespace ast {
 
     inline void to_json(const Node& node, Value& out, Document::AllocatorType& alloc) {
         out.SetObject();
-        out.AddMember("type", Value(node.type.c_str(), alloc), alloc);
+        Value type(node.type.c_str(), static_cast<SizeType>(node.type.view().size()), alloc);
+        out.AddMember("type", type, alloc);
 
         if (!node.props.empty()) {
             Value propsObj(kObjectType);
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cmath>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <optional>
@@ -41,6 +45,20 @@ enum class FilterMode {
     Number               // Числовые значения
 };
 
+// Формат данных таблицы в ответе
+enum class TablePayload {
+    Rows,                // Массив строк, каждая - массив значений (по умолчанию)
+    Compact              // Колонки: словарь + коды, дельты целых, либо значения как есть
+};
+
+// Кодирование колонки в компактном формате
+enum class ColumnEncoding {
+    Auto,                // Словарь для повторяющихся строк, дельты для целых чисел
+    Plain,               // Значения как есть
+    Dictionary,          // Словарь уникальных значений + целочисленные коды строк
+    Delta                // Целые числа: первое значение, далее разности соседних
+};
+
 // Опция для фильтра с типом Select
 struct FilterOption {
     std::string text;   // Отображаемый текст
@@ -82,16 +100,21 @@ struct TableColumn {
     std::optional<FilterConfig> filter; // Конфигурация фильтра (может отсутствовать)
     bool is_exported = true;            // Участие в экспорте (может отсутствовать)
     bool is_sorted = true;              // Доступна ли сортировка (может отсутствовать)
+    ColumnEncoding encoding = ColumnEncoding::Auto; // Кодирование в компактном формате
 };
 
 // Основной класс для пошаговой сборки JSON-описания таблицы
 class TableBuilder {
 public:
-    explicit TableBuilder(const std::string& table_name)
-        : _table_name(table_name) {}
+    // resource - память под список строк (например, арена запроса); сами значения
+    // остаются в обычной куче, так как уходят в ответ
+    explicit TableBuilder(const std::string& table_name,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _table_name(table_name), _rows(resource) {}
 
     void AddColumn(const TableColumn& column) {
         _column_order_by_keys.push_back(column.key);
+        _column_encodings.push_back(column.encoding);
 
         JSONObject column_obj;
         column_obj["name"] = column.language_token;
@@ -117,6 +140,16 @@ public:
         _rows.push_back(std::move(json_row));
     }
 
+    void AddRow(std::vector<JSONValue>&& row_values) { _rows.push_back(std::move(row_values)); }
+
+    // Строка без промежуточного вектора: значения создаются сразу на своем месте
+    template <typename... Values>
+    void EmplaceRow(Values&&... values) {
+        JSONArray& json_row = _rows.emplace_back();
+        json_row.reserve(sizeof...(values));
+        (json_row.emplace_back(std::forward<Values>(values)), ...);
+    }
+
     void SetIdColumn(const std::string& id_column) { _id_column = id_column; }
 
     void SetOrderBy(const std::string& column, const std::string& order = "DESC") {
@@ -139,7 +172,59 @@ public:
 
     void SetTotalData(const JSONArray& total_data) { _total_data = total_data; }
 
-    [[nodiscard]] JSONObject CreateTableProps() const {
+    void SetPayloadFormat(const TablePayload payload) { _payload = payload; }
+
+    [[nodiscard]] JSONObject CreateTableProps() const& {
+        JSONArray json_rows;
+
+        if (_payload == TablePayload::Rows) {
+            json_rows.reserve(_rows.size());
+
+            for (const auto& row : _rows) {
+                json_rows.emplace_back(row);
+            }
+        }
+
+        return BuildTableProps(std::move(json_rows));
+    }
+
+    // Строки переносятся в ответ без копирования; после вызова builder пуст
+    [[nodiscard]] JSONObject CreateTableProps() && {
+        JSONArray json_rows;
+
+        if (_payload == TablePayload::Rows) {
+            json_rows.reserve(_rows.size());
+
+            for (auto& row : _rows) {
+                json_rows.emplace_back(std::move(row));
+            }
+        }
+
+        JSONObject table_props = BuildTableProps(std::move(json_rows));
+        _rows.clear();
+        return table_props;
+    }
+
+private:
+    std::string _table_name;
+    std::string _id_column;
+    std::vector<std::string> _column_order_by_keys;
+    std::vector<ColumnEncoding> _column_encodings;
+    std::pmr::vector<JSONArray> _rows;
+    JSONObject _structure;
+    std::pair<std::string, std::string> _order_by{"id", "DESC"};
+    bool _is_auto_save_enabled = false;
+    bool _is_refresh_button_enabled = true;
+    bool _is_bookmarks_button_enabled = true;
+    bool _is_export_button_enabled = true;
+    bool _is_total_row_enabled = false;
+    int _limit = 20;
+    std::string _total_data_title;
+    JSONArray _total_data;
+    TablePayload _payload = TablePayload::Rows;
+
+    // json_rows - готовые строки для формата Rows; в компактном формате не используется
+    [[nodiscard]] JSONObject BuildTableProps(JSONArray json_rows) const {
         JSONObject table_props;
         table_props["name"] = _table_name;
         table_props["idCol"] = _id_column;
@@ -157,15 +242,19 @@ public:
         }
 
         JSONObject data_obj;
-        JSONArray json_rows;
-        json_rows.reserve(_rows.size());
 
-        for (const auto& row : _rows) {
-            json_rows.emplace_back(row);
-        }
-
-        data_obj["rows"] = std::move(json_rows);
+        if (_payload == TablePayload::Compact) {
+            JSONObject columns_obj;
+            for (size_t column = 0; column < _column_order_by_keys.size(); ++column) {
+                columns_obj[_column_order_by_keys[column]] = EncodeColumn(column);
+            }
 
+            data_obj["format"] = "compact";
+            data_obj["rowCount"] = static_cast<double>(_rows.size());
+            data_obj["columns"] = std::move(columns_obj);
+        } else {
+            data_obj["rows"] = std::move(json_rows);
+        }
 
         JSONArray structure_keys;
         structure_keys.reserve(_column_order_by_keys.size());
@@ -181,21 +270,90 @@ public:
         return table_props;
     }
 
-private:
-    std::string _table_name;
-    std::string _id_column;
-    std::vector<std::string> _column_order_by_keys;
-    std::vector<JSONArray> _rows;
-    JSONObject _structure;
-    std::pair<std::string, std::string> _order_by{"id", "DESC"};
-    bool _is_auto_save_enabled = false;
-    bool _is_refresh_button_enabled = true;
-    bool _is_bookmarks_button_enabled = true;
-    bool _is_export_button_enabled = true;
-    bool _is_total_row_enabled = false;
-    int _limit = 20;
-    std::string _total_data_title;
-    JSONArray _total_data;
+    // Значение ячейки; строки короче структуры дополняются пустыми значениями
+    [[nodiscard]] const JSONValue* Cell(const size_t row, const size_t column) const {
+        return column < _rows[row].size() ? &_rows[row][column] : nullptr;
+    }
+
+    [[nodiscard]] JSONObject EncodeColumn(const size_t column) const {
+        bool is_strings = true;
+        bool is_integers = true;
+
+        for (size_t row = 0; row < _rows.size() && (is_strings || is_integers); ++row) {
+            const JSONValue* cell = Cell(row, column);
+            const auto* number = cell != nullptr ? std::get_if<double>(&cell->value) : nullptr;
+
+            is_strings = is_strings && cell != nullptr &&
+                         std::holds_alternative<std::string>(cell->value);
+            is_integers = is_integers && number != nullptr && std::abs(*number) < 9.0e15 &&
+                          std::trunc(*number) == *number;
+        }
+
+        ColumnEncoding encoding = _column_encodings[column];
+        if (encoding == ColumnEncoding::Auto) {
+            encoding = is_integers ? ColumnEncoding::Delta
+                     : is_strings  ? ColumnEncoding::Dictionary
+                                   : ColumnEncoding::Plain;
+        }
+
+        JSONObject column_obj;
+
+        if (encoding == ColumnEncoding::Delta && is_integers) {
+            JSONIntArray deltas;
+            deltas.reserve(_rows.size());
+
+            int64_t previous = 0;
+            for (size_t row = 0; row < _rows.size(); ++row) {
+                const auto value = static_cast<int64_t>(std::get<double>(Cell(row, column)->value));
+                deltas.push_back(value - previous);
+                previous = value;
+            }
+
+            column_obj["encoding"] = "delta";
+            column_obj["values"] = std::move(deltas);
+            return column_obj;
+        }
+
+        if (encoding == ColumnEncoding::Dictionary && is_strings) {
+            // В авто-режиме словарь нужен, только если значения повторяются
+            const bool is_auto = _column_encodings[column] == ColumnEncoding::Auto;
+            const size_t dictionary_limit = is_auto ? _rows.size() / 2 : _rows.size();
+
+            std::unordered_map<std::string_view, int64_t> codes_by_value;
+            JSONArray dictionary;
+            JSONIntArray codes;
+            codes.reserve(_rows.size());
+
+            for (size_t row = 0; row < _rows.size() && dictionary.size() <= dictionary_limit;
+                 ++row) {
+                const std::string& value = std::get<std::string>(Cell(row, column)->value);
+                const auto [it, inserted] =
+                    codes_by_value.try_emplace(value, static_cast<int64_t>(dictionary.size()));
+                if (inserted) {
+                    dictionary.emplace_back(value);
+                }
+                codes.push_back(it->second);
+            }
+
+            if (dictionary.size() <= dictionary_limit) {
+                column_obj["encoding"] = "dictionary";
+                column_obj["dictionary"] = std::move(dictionary);
+                column_obj["codes"] = std::move(codes);
+                return column_obj;
+            }
+        }
+
+        JSONArray values;
+        values.reserve(_rows.size());
+        for (size_t row = 0; row < _rows.size(); ++row) {
+            const JSONValue* cell = Cell(row, column);
+            values.push_back(cell != nullptr ? *cell : JSONValue(""));
+        }
+
+        column_obj["encoding"] = "plain";
+        column_obj["values"] = std::move(values);
+        return column_obj;
+    }
 
     static JSONObject ConvertFilterToJson(const FilterConfig& filter_config) {
         JSONObject json_object;
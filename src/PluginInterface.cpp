@@ -21,148 +21,217 @@ extern "C" void AboutReport(rapidjson::Value&                   request,
     response.AddMember("key", Value().SetString("DAILY_LOGS_REPORT", allocator), allocator);
 }
 
-extern "C" void DestroyReport() {}
+// Хост выгружает плагин: незавершенные отчеты отменяются, пулы и кеши освобождаются
+extern "C" void DestroyReport() {
+    runtime::PluginRuntime::Shutdown();
+}
+
+namespace {
+    void BuildReport(runtime::PluginRuntime&             plugin_runtime,
+                     rapidjson::Value&                   request,
+                     rapidjson::Value&                   response,
+                     rapidjson::Document::AllocatorType& allocator,
+                     ReportServerInterface*              server) {
+        metrics::ReportMetrics& report_metrics = plugin_runtime.ReportMetrics();
+        logging::AsyncLogger&   logger         = plugin_runtime.Logger();
+
+        // Validation
+        constexpr ReportType   report_type = ReportType::Daily;
+        std::vector<LogFilter> table_filters;
+        const ValidationResult validation_result = [&] {
+            tracing::Span        span("ValidateRequest", "report");
+            metrics::ScopedTimer timer(report_metrics.Phase(metrics::ReportPhase::Validate));
+
+            ValidationResult result =
+                RequestValidator::ValidateRequest(report_type, request, server);
+            if (!result.allowed)
+                return result;
+
+            // Фильтры таблицы проверяются вместе с запросом: ошибка в них - отказ с кодом 400
+            try {
+                table_filters = filters::ParseLogFilters(request);
+            } catch (const std::invalid_argument& e) {
+                result.allowed = false;
+                result.code    = 400;
+                result.message = e.what();
+            }
+            return result;
+        }();
+
+        if (!validation_result.allowed) {
+            report_metrics.Denied(validation_result.code).Add();
+
+            // Поток отказов ограничивается лимитом журнала и не тормозит потоки отчетов
+            logger.Log(logging::LogLevel::Warning,
+                       "%d, message: %s",
+                       validation_result.code,
+                       validation_result.message.c_str());
+
+            const Node report =
+                div({h1({text("Access Denied")},
+                        props({{"style", JSONValue(JSONObject{{"color", JSONValue("#dc2626")}})}})),
+                     h2({text("Code: " + std::to_string(validation_result.code))}),
+                     h2({text(validation_result.message)},
+                        props({{"style", JSONValue(JSONObject{{"color", JSONValue("gray")}})}}))});
+
+            utils::CreateUI(report, response, allocator);
+
+            return;
+        }
+
+        logger.Log(logging::LogLevel::Info,
+                   "%d, message: %s",
+                   validation_result.code,
+                   validation_result.message.c_str());
+
+        // Capture: ответы хоста записываются для офлайн-воспроизведения. Обертка живет, пока
+        // ее держит конвейер, и отдает запись после последнего GetLogs
+        std::shared_ptr<ReportServerInterface> server_proxy;
+        if (capture::CaptureWriter* capture_writer = plugin_runtime.Capture();
+            capture_writer != nullptr && capture_writer->ShouldCapture()) {
+            server_proxy = std::make_shared<capture::CapturingServer>(
+                server, std::make_unique<capture::ReportCapture>(request), *capture_writer);
+            server = server_proxy.get();
+        }
+
+        // Execution
+        int from          = request["from"].GetInt();
+        int to = request["to"].GetInt();
+        int from_week_ago = utils::CalculateTimestampForWeekAgo(from);
+
+        // Активные фильтры таблицы: что возможно - переносится в GetLogs, остальное - в плагин
+        const LogQuery table_query =
+            filters::PlanLogQuery(from, to, table_filters, filters::HostFilterFromEnvironment());
+
+        // Export: логи дня потоком пишутся в файл, таблица и графики не строятся
+        ExportOptions export_options;
+        if (exporters::ParseExportOptions(request, &export_options)) {
+            report_metrics.Exports().Add();
+
+            try {
+                const ExportResult export_result =
+                    exporters::ExportDayLogs(server, from, to, table_filters, export_options);
+
+                // Путь к файлу на сервере в интерфейс не выводится
+                const Node export_node =
+                    div({h2({text("Export")}),
+                         p({text("Rows: " + std::to_string(export_result.rows))}),
+                         p({text("Bytes: " + std::to_string(export_result.bytes))})});
+
+                utils::CreateUI(export_node, response, allocator);
+
+                // Машиночитаемый результат для хоста, забирающего файл; только здесь - путь
+                Value export_object(kObjectType);
+                export_object.AddMember(
+                    "path", Value().SetString(export_result.path.c_str(), allocator), allocator);
+                export_object.AddMember("rows", export_result.rows, allocator);
+                export_object.AddMember("bytes", export_result.bytes, allocator);
+                export_object.AddMember("chunks", export_result.chunks, allocator);
+                response.AddMember("export", export_object, allocator);
+            } catch (const std::exception& e) {
+                logger.Log(logging::LogLevel::Error, "%s", e.what());
+
+                const Node export_node = div({h2({text("Export failed")}), p({text(e.what())})});
+                utils::CreateUI(export_node, response, allocator);
+            }
+
+            return;
+        }
+
+        // Report pipeline: стадии выполняются на общем пуле, хост ждет не дольше дедлайна
+        pipeline::ReportInputs inputs;
+        inputs.server             = server;
+        inputs.server_proxy       = server_proxy;
+        inputs.from               = from;
+        inputs.to                 = to;
+        inputs.from_week_ago      = from_week_ago;
+        inputs.table_filters      = table_filters;
+        inputs.table_query        = table_query;
+        inputs.is_compact_payload = request.HasMember("payload") &&
+                                    std::string(request["payload"].GetString()) == "compact";
+        inputs.fetch_options = fetch::FetchOptionsFromEnvironment();
+        collapse::ParseCollapseOptions(request, &inputs.collapse_options);
+        sampling::ParseSamplingOptions(request, &inputs.sampling_options);
+
+        const auto deadline =
+            pipeline::RequestContext::Clock::now() + pipeline::ReportTimeout(request);
+
+        report_metrics.Reports().Add();
+
+        auto report_state = std::make_shared<pipeline::ReportState>(
+            std::move(inputs), deadline, plugin_runtime);
+        plugin_runtime.TrackReport(report_state);
+        pipeline::StartReport(report_state, plugin_runtime.Pipeline());
+
+        const bool is_complete = report_state->WaitUntilDeadline();
+        if (!is_complete) {
+            // Незавершенные стадии остановятся в ближайшей точке проверки
+            report_state->Context().Cancel();
+            report_metrics.Partial().Add();
+        }
+
+        // Хост гарантирует server только до возврата из CreateReport: стадии, пережившие
+        // дедлайн, больше его не вызывают
+        report_state->Server().Close();
+
+        std::vector<pipeline::ReportPanel> missing_panels;
+        std::vector<Node>                  panel_nodes =
+            report_state->TakeCompletedPanels(&missing_panels);
+
+        std::vector<Node> report_nodes = {h1({text("Server Logs")})};
+
+        if (!is_complete) {
+            std::string missing_titles;
+            for (const auto panel : missing_panels) {
+                missing_titles += (missing_titles.empty() ? "" : ", ");
+                missing_titles += pipeline::ReportPanelTitle(panel);
+            }
+
+            logger.Log(logging::LogLevel::Warning,
+                       "deadline reached, missing: %s",
+                       missing_titles.c_str());
+
+            report_nodes.push_back(
+                div({h3({text("Partial report: deadline reached")}),
+                     p({text("Not ready: " + missing_titles)})},
+                    props({{"style", JSONValue(JSONObject{{"color", JSONValue("#D0021B")}})}})));
+        }
+
+        report_nodes.insert(report_nodes.end(),
+                            std::make_move_iterator(panel_nodes.begin()),
+                            std::make_move_iterator(panel_nodes.end()));
+
+        // Total report
+        const Node report = Column(std::move(report_nodes));
+
+        {
+            metrics::ScopedTimer timer(report_metrics.Phase(metrics::ReportPhase::Render));
+            utils::CreateUI(report, response, allocator);
+        }
+
+        if (!is_complete) {
+            response.AddMember("partial", true, allocator);
+        }
+
+        // Графики и таблица посчитаны по выборке
+        if (report_state->is_sampled) {
+            response.AddMember("sampled", true, allocator);
+        }
+    }
+} // namespace
 
 extern "C" void CreateReport(rapidjson::Value&                   request,
                              rapidjson::Value&                   response,
                              rapidjson::Document::AllocatorType& allocator,
                              ReportServerInterface*              server) {
-
-    // Validation
-    constexpr ReportType   report_type = ReportType::Daily;
-    const ValidationResult validation_result =
-        RequestValidator::ValidateRequest(report_type, request, server);
-
-    if (!validation_result.allowed) {
-        std::cerr << "[DailyLogsReportInterface]: " << validation_result.code
-                  << ", message: " << validation_result.message << std::endl;
-
-        const Node report =
-            div({h1({text("Access Denied")},
-                    props({{"style", JSONValue(JSONObject{{"color", JSONValue("#dc2626")}})}})),
-                 h2({text("Code: " + std::to_string(validation_result.code))}),
-                 h2({text(validation_result.message)},
-                    props({{"style", JSONValue(JSONObject{{"color", JSONValue("gray")}})}}))});
-
-        utils::CreateUI(report, response, allocator);
-
-        return;
+    // Среда создается до спана отчета: она же включает трассировку
+    runtime::PluginRuntime& plugin_runtime = runtime::PluginRuntime::Instance();
+    {
+        tracing::Span        span("CreateReport", "report");
+        metrics::ScopedTimer timer(plugin_runtime.ReportMetrics().CreateReportDuration());
+        BuildReport(plugin_runtime, request, response, allocator, server);
     }
 
-    std::cout << "[DailyLogsReportInterface]: " << validation_result.code
-              << ", message: " << validation_result.message << std::endl;
-
-    // Execution
-    int from          = request["from"].GetInt();
-    int to = request["to"].GetInt();
-    int from_week_ago = utils::CalculateTimestampForWeekAgo(from);
-
-    std::vector<ReportServerLog> all_logs_vector;
-    std::vector<ReportServerLog> clients_logs_vector;
-    std::vector<ReportServerLog> today_logs;
-    std::vector<std::string>     colors = {"#4A90E2", "#50E3C2", "#F5A623", "#D0021B", "#9013FE"};
-    std::string                  other_color = "#B8E986";
-
-    try {
-        server->GetLogs(from_week_ago, to, "", "", &all_logs_vector);
-        server->GetLogs(from, to, "CLIENT", "", &clients_logs_vector);
-        server->GetLogs(from, to, "", "", &today_logs);
-    } catch (const std::exception& e) {
-        std::cerr << "[DailyLogsReportInterface]: " << e.what() << std::endl;
-    }
-
-    // Server logs chart
-    const JSONArray server_logs_chart_data    = utils::CreateServerLogsChartData(all_logs_vector);
-    const std::vector<std::string> line_keys  = {"client", "manager", "system", "total"};
-    std::vector<Node>              line_nodes = {// Default nodes
-                                    XAxis({}, props({{"dataKey", "day"}})),
-                                    YAxis(),
-                                    Tooltip(),
-                                    Legend()};
-
-    // Формирование Line nodes
-    for (size_t i = 0; i < line_keys.size(); ++i) {
-        std::string color = (line_keys[i] == "total") ? other_color : colors[i];
-
-        line_nodes.push_back(
-            Line({}, props({{"type", "monotone"}, {"dataKey", line_keys[i]}, {"stroke", color}})));
-    }
-
-    Node server_logs_chart_node =
-        ResponsiveContainer({LineChart(line_nodes, props({{"data", server_logs_chart_data}}))},
-                            props({{"width", "100%"}, {"height", 300.0}}));
-
-    // Top flooder chart
-    const JSONArray top_flooders_chart_data =
-        utils::CreateTopFloodersChartData(clients_logs_vector);
-
-    // Вектор Cell с цветами для каждой записи
-    std::vector<Node> top_flooders_pie_cells;
-    for (size_t i = 0; i < top_flooders_chart_data.size(); ++i) {
-        std::string color = i < colors.size() ? colors[i] : other_color;
-        top_flooders_pie_cells.push_back(Cell({}, props({{"fill", color}})));
-    }
-
-    Node top_flooders_chart =
-        ResponsiveContainer({PieChart({Tooltip(),
-                                       Legend(),
-                                       Pie(top_flooders_pie_cells,
-                                           props({{"dataKey", "value"},
-                                                  {"nameKey", "label"},
-                                                  {"data", top_flooders_chart_data},
-                                                  {"cx", "50%"},
-                                                  {"cy", "50%"},
-                                                  {"outerRadius", 100.0},
-                                                  {"label", true}}))})},
-                            props({{"width", "100%"}, {"height", 300.0}}));
-
-    // Main table
-    TableBuilder table_builder("DailyLogsReport");
-
-    // Main table props
-    table_builder.SetIdColumn("id");
-    table_builder.SetOrderBy("id", "DESC");
-    table_builder.EnableAutoSave(false);
-    table_builder.EnableRefreshButton(false);
-    table_builder.EnableBookmarksButton(false);
-    table_builder.EnableExportButton(true);
-
-    // Filters
-    FilterConfig search_filter;
-    search_filter.type = FilterType::Search;
-
-    FilterConfig date_time_filter;
-    date_time_filter.type = FilterType::DateTime;
-
-    table_builder.AddColumn({"time", "TIME", 1, date_time_filter});
-    table_builder.AddColumn({"actor_id", "ACTOR_ID", 2, search_filter});
-    table_builder.AddColumn({"actor_type", "ACTOR_TYPE", 3, search_filter});
-    table_builder.AddColumn({"action", "ACTION", 4, search_filter});
-    table_builder.AddColumn({"status", "STATUS", 5, search_filter});
-    table_builder.AddColumn({"source", "SOURCE", 6, search_filter});
-    table_builder.AddColumn({"detail", "DETAIL", 7, search_filter});
-
-    for (auto& today_log : today_logs) {
-        table_builder.AddRow({utils::NormalizeLogTime(today_log.time),
-                              today_log.actor_id,
-                              today_log.actor_type,
-                              today_log.action,
-                              today_log.status,
-                              today_log.source,
-                              today_log.detail});
-    }
-
-    const JSONObject logs_table_props = table_builder.CreateTableProps();
-    const Node       logs_table_node  = Table({}, logs_table_props);
-
-    // Total report
-    const Node report = Column({h1({text("Server Logs")}),
-                                h2({text("Server Messages (last 2 weeks)")}),
-                                server_logs_chart_node,
-                                h2({text("Top flooders (24h, %)")}),
-                                top_flooders_chart,
-                                h2({text("All Logs")}),
-                                logs_table_node});
-
-    utils::CreateUI(report, response, allocator);
-}
\ No newline at end of file
+    // Спаны отчета, включая потоки пулов, попадают в файл сразу после ответа
+    tracing::Flush();
+}
@@ -0,0 +1,180 @@
+#include "RateAnomalyDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "utils/Utils.h"
+
+namespace anomalies {
+    RateAnomalyDetector::RateAnomalyDetector(time_t from, time_t to, RateAnomalyOptions options)
+        : _from(from), _to(to), _options(options),
+          _decay(std::pow(0.5, 1.0 / std::max(options.half_life_minutes, 1.0))),
+          _table(1024) {}
+
+    void RateAnomalyDetector::Add(const CompactLog& log) {
+        const int64_t timestamp = log.time;
+        if (timestamp < 0 || timestamp > _to)
+            return;
+
+        const int64_t minute = timestamp / 60;
+
+        if (!log.actor_id.empty()) {
+            Observe(Lookup(0, log.actor_id), minute);
+        }
+        if (!log.source.empty()) {
+            Observe(Lookup(1, log.source), minute);
+        }
+    }
+
+    std::vector<RateAnomaly> RateAnomalyDetector::Finish() {
+        std::vector<const State*> flagged;
+
+        for (auto& state : _table) {
+            if (!state.used)
+                continue;
+
+            CloseMinute(state);
+            state.count = 0;
+
+            if (state.best_minute >= 0) {
+                flagged.push_back(&state);
+            }
+        }
+
+        std::sort(flagged.begin(), flagged.end(), [](const State* a, const State* b) {
+            return a->best_z > b->best_z;
+        });
+
+        if (flagged.size() > _options.max_anomalies) {
+            flagged.resize(_options.max_anomalies);
+        }
+
+        std::vector<RateAnomaly> result;
+        result.reserve(flagged.size());
+
+        for (const State* state : flagged) {
+            RateAnomaly anomaly;
+            anomaly.kind     = state->kind == 0 ? "actor" : "source";
+            anomaly.key      = state->key;
+            anomaly.minute   = static_cast<time_t>(state->best_minute * 60);
+            anomaly.count    = state->best_count;
+            anomaly.baseline = state->best_baseline;
+            anomaly.z_score  = state->best_z;
+            result.push_back(std::move(anomaly));
+        }
+
+        return result;
+    }
+
+    RateAnomalyDetector::State& RateAnomalyDetector::Lookup(uint8_t kind, std::string_view key) {
+        if ((_size + 1) * 2 > _table.size()) {
+            Grow();
+        }
+
+        const uint64_t hash = std::hash<std::string_view>{}(key) ^ (kind * 0x9E3779B97F4A7C15ULL);
+        const size_t   mask = _table.size() - 1;
+
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            State& state = _table[i];
+
+            if (!state.used) {
+                state.used = true;
+                state.key  = key;
+                state.hash = hash;
+                state.kind = kind;
+                ++_size;
+                return state;
+            }
+
+            if (state.hash == hash && state.kind == kind && state.key == key)
+                return state;
+        }
+    }
+
+    void RateAnomalyDetector::Grow() {
+        std::vector<State> old_table(_table.size() * 2);
+        old_table.swap(_table);
+
+        const size_t mask = _table.size() - 1;
+        for (auto& state : old_table) {
+            if (!state.used)
+                continue;
+            size_t i = state.hash & mask;
+            while (_table[i].used) {
+                i = (i + 1) & mask;
+            }
+            _table[i] = std::move(state);
+        }
+    }
+
+    void RateAnomalyDetector::Observe(State& state, int64_t minute) {
+        if (state.minute < 0) {
+            state.minute = minute;
+            state.count  = 1;
+            return;
+        }
+
+        if (minute <= state.minute) {
+            state.count++;
+            return;
+        }
+
+        CloseMinute(state);
+        SkipMinutes(state, minute - state.minute - 1);
+
+        state.minute = minute;
+        state.count  = 1;
+    }
+
+    void RateAnomalyDetector::CloseMinute(State& state) {
+        if (state.count == 0)
+            return;
+
+        const double  count       = state.count;
+        const int64_t minute_time = state.minute * 60;
+
+        // До начала суток - пополнение базы
+        if (minute_time < _from) {
+            state.mean   = _decay * state.mean + (1.0 - _decay) * count;
+            state.square = _decay * state.square + (1.0 - _decay) * count * count;
+            state.weight = _decay * state.weight + (1.0 - _decay);
+            return;
+        }
+
+        if (state.count < _options.min_count)
+            return;
+
+        // Поправка на смещение EWMA к нулю при малом числе наблюдений
+        double mean     = 0.0;
+        double variance = 0.0;
+        if (state.weight > 0.0) {
+            mean     = state.mean / state.weight;
+            variance = state.square / state.weight - mean * mean;
+        }
+
+        // Нижняя граница дисперсии - пуассоновская, иначе редкие акторы дают бесконечный z
+        const double sigma = std::sqrt(std::max({variance, mean, 1.0}));
+        const double z     = (count - mean) / sigma;
+
+        if (z >= _options.z_threshold && z > state.best_z) {
+            state.best_z        = z;
+            state.best_baseline = mean;
+            state.best_minute   = state.minute;
+            state.best_count    = state.count;
+        }
+    }
+
+    void RateAnomalyDetector::SkipMinutes(State& state, int64_t minutes) {
+        // В базу идут только пропуски до начала суток; нулевая минута не бывает всплеском
+        const int64_t from_minute = _from / 60;
+        const int64_t base_skip   = std::min(minutes, from_minute - state.minute - 1);
+        if (base_skip <= 0)
+            return;
+
+        const double factor = std::pow(_decay, static_cast<double>(base_skip));
+        state.mean *= factor;
+        state.square *= factor;
+        state.weight = state.weight * factor + (1.0 - factor);
+    }
+} // namespace anomalies
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "structures/CompactLog.h"
+#include "structures/RateAnomaly.h"
+
+namespace anomalies {
+    struct RateAnomalyOptions {
+        double   half_life_minutes = 24 * 60; // полураспад веса EWMA
+        double   z_threshold       = 6.0;
+        uint32_t min_count         = 30; // минимум сообщений за минуту для сигнала
+        size_t   max_anomalies     = 20;
+    };
+
+    // Потоковый детектор всплесков: для каждого actor_id и source хранит EWMA первого
+    // и второго моментов поминутной частоты. Минуты до from формируют базу, минуты
+    // [from, to] сравниваются с замороженной базой. Один проход, память - O(активных ключей).
+    // Строки должны поступать по возрастанию времени (конвейер сортирует каждый интервал):
+    // запаздывающая строка засчитывается в текущую минуту ключа.
+    // Ключ копируется один раз при первом появлении, строки логов после Add() не нужны
+    class RateAnomalyDetector {
+    public:
+        RateAnomalyDetector(time_t from, time_t to, RateAnomalyOptions options = {});
+
+        void Add(const CompactLog& log);
+
+        // Закрывает незавершенные минуты и возвращает самые сильные отклонения
+        std::vector<RateAnomaly> Finish();
+
+    private:
+        struct State {
+            std::string      key;
+            uint64_t         hash   = 0;
+            int64_t          minute = -1; // текущая минута (UNIX-время / 60)
+            uint32_t         count  = 0;
+            uint8_t          kind   = 0; // 0 - actor, 1 - source
+            bool             used   = false;
+            double           mean          = 0.0; // EWMA x
+            double           square        = 0.0; // EWMA x^2
+            double           weight        = 0.0; // накопленный вес наблюдений базы
+            double           best_z        = 0.0;
+            double           best_baseline = 0.0;
+            int64_t          best_minute   = -1;
+            uint32_t         best_count    = 0;
+        };
+
+        time_t             _from;
+        time_t             _to;
+        RateAnomalyOptions _options;
+        double             _decay; // множитель веса за минуту
+
+        std::vector<State> _table; // открытая адресация, линейное пробирование
+        size_t             _size = 0;
+
+        State& Lookup(uint8_t kind, std::string_view key);
+
+        void Grow();
+
+        void Observe(State& state, int64_t minute);
+
+        void CloseMinute(State& state);
+
+        // Пустые минуты между событиями: k нулевых наблюдений за раз
+        void SkipMinutes(State& state, int64_t minutes);
+    };
+} // namespace anomalies
@@ -0,0 +1,354 @@
+#include "DayCache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "snapshots/LogSnapshot.h"
+
+namespace {
+    constexpr std::string_view SNAPSHOT_PREFIX    = "day-";
+    constexpr std::string_view SNAPSHOT_EXTENSION = ".dlsnap";
+
+    // Проверка остановки при записи снимка - раз в столько строк
+    constexpr size_t STOP_CHECK_ROWS = 1 << 14;
+
+    // Память строки вне объекта: короткие строки хранятся в нем самом
+    size_t HeapBytes(const std::string& value) {
+        static const size_t inline_capacity = std::string().capacity();
+        return value.capacity() > inline_capacity ? value.capacity() + 1 : 0;
+    }
+
+    size_t HeapBytes(const ReportServerLog& log) {
+        return HeapBytes(log.time) + HeapBytes(log.actor_type) + HeapBytes(log.actor_id) +
+               HeapBytes(log.action) + HeapBytes(log.status) + HeapBytes(log.source) +
+               HeapBytes(log.detail);
+    }
+
+    // Неотрицательное число из переменной окружения; false - не задано или не число
+    bool ReadEnvironmentNumber(const char* name, long long* number) {
+        const char* value = std::getenv(name);
+        if (value == nullptr || *value == '\0')
+            return false;
+
+        char*           end    = nullptr;
+        const long long result = std::strtoll(value, &end, 10);
+        if (*end != '\0' || result < 0)
+            return false;
+
+        *number = result;
+        return true;
+    }
+
+    records::CompactLogStore ViewLogs(const std::vector<ReportServerLog>& logs) {
+        records::CompactLogStore store;
+        store.AppendView(logs);
+        return store;
+    }
+
+    // Канонический текст времени строк блоков без TimeText, по HOST_TIME_SIZE байт подряд
+    std::string CanonicalTimeText(const snapshots::LogSnapshot& snapshot) {
+        size_t rows = 0;
+        for (const snapshots::SnapshotBlock& block : snapshot.Blocks()) {
+            rows += block.HasTimeText() ? 0 : block.Rows();
+        }
+
+        std::string text(rows * snapshots::HOST_TIME_SIZE, '\0');
+        char*       cursor = text.data();
+        for (const snapshots::SnapshotBlock& block : snapshot.Blocks()) {
+            if (block.HasTimeText())
+                continue;
+            for (const int64_t time : block.Times()) {
+                snapshots::FormatHostTime(time, cursor);
+                cursor += snapshots::HOST_TIME_SIZE;
+            }
+        }
+        return text;
+    }
+
+    records::CompactLogStore ViewSnapshot(const snapshots::LogSnapshot& snapshot,
+                                          std::string_view              time_text) {
+        records::CompactLogStore store;
+        store.Reserve(snapshot.Rows());
+
+        for (const snapshots::SnapshotBlock& block : snapshot.Blocks()) {
+            for (size_t row = 0; row < block.Rows(); ++row) {
+                CompactLog log = block.Log(row);
+                if (!block.HasTimeText()) {
+                    log.time_text = time_text.substr(0, snapshots::HOST_TIME_SIZE);
+                    time_text.remove_prefix(snapshots::HOST_TIME_SIZE);
+                }
+                store.AppendView(log);
+            }
+        }
+        return store;
+    }
+} // namespace
+
+DayCacheOptions DayCacheOptionsFromEnvironment() {
+    DayCacheOptions options;
+
+    if (const char* directory = std::getenv("DAILY_LOGS_DAY_CACHE_DIR")) {
+        options.directory = directory;
+    }
+
+    long long number = 0;
+    if (ReadEnvironmentNumber("DAILY_LOGS_DAY_CACHE_MB", &number)) {
+        options.memory_bytes = static_cast<size_t>(number) * 1024 * 1024;
+    }
+    if (ReadEnvironmentNumber("DAILY_LOGS_DAY_CACHE_IDLE_SEC", &number)) {
+        options.idle_ttl = static_cast<time_t>(number);
+    }
+
+    return options;
+}
+
+LogSlice::LogSlice(time_t from, time_t to, std::vector<ReportServerLog>&& logs)
+    : _from(from), _to(to), _loaded_at(std::time(nullptr)), _logs(std::move(logs)),
+      _compact(ViewLogs(_logs)), _columns(_compact.Logs()) {
+    _bytes = _logs.capacity() * sizeof(ReportServerLog) + _compact.Size() * sizeof(CompactLog);
+    for (const ReportServerLog& log : _logs) {
+        _bytes += HeapBytes(log);
+    }
+}
+
+LogSlice::LogSlice(time_t from, time_t to, snapshots::LogSnapshot&& snapshot)
+    : _from(from), _to(to), _loaded_at(std::time(nullptr)),
+      _snapshot(std::make_unique<snapshots::LogSnapshot>(std::move(snapshot))),
+      _time_text(CanonicalTimeText(*_snapshot)), _compact(ViewSnapshot(*_snapshot, _time_text)),
+      _columns(_compact.Logs()) {
+    _bytes = _snapshot->Bytes() + _time_text.capacity() + _compact.Size() * sizeof(CompactLog);
+}
+
+const filters::TokenIndex& LogSlice::Index() const {
+    std::call_once(_index_once, [this] {
+        _index = std::make_unique<filters::TokenIndex>(_columns);
+        _index_bytes.store(_index->MemoryUsage(), std::memory_order_relaxed);
+    });
+    return *_index;
+}
+
+size_t LogSlice::MemoryUsage() const {
+    return _bytes + _index_bytes.load(std::memory_order_relaxed);
+}
+
+DayCache::DayCache(DayCacheOptions options) : _options(std::move(options)) {
+    if (!_options.directory.empty()) {
+        _writer = std::thread([this] { RunWriter(); });
+    }
+}
+
+DayCache::~DayCache() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _write_wakeup.notify_all();
+    if (_writer.joinable()) {
+        _writer.join();
+    }
+}
+
+std::shared_ptr<const LogSlice> DayCache::Find(time_t from, time_t to) {
+    const time_t now = std::time(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Evict(now);
+
+        for (auto it = _slices.begin(); it != _slices.end(); ++it) {
+            if (it->slice->From() != from || it->slice->To() != to)
+                continue;
+
+            // Перемещение в начало списка
+            it->used_at = now;
+            _slices.splice(_slices.begin(), _slices, it);
+            return _slices.front().slice;
+        }
+    }
+
+    // Завершенный день мог остаться на диске от прошлого запуска; файл читается без мьютекса
+    if (_options.directory.empty() || to >= now)
+        return nullptr;
+
+    auto slice = LoadSnapshot(from, to);
+    if (slice != nullptr) {
+        Insert(slice);
+    }
+    return slice;
+}
+
+std::shared_ptr<const LogSlice> DayCache::Store(time_t                         from,
+                                                time_t                         to,
+                                                std::vector<ReportServerLog>&& logs) {
+    auto slice = std::make_shared<const LogSlice>(from, to, std::move(logs));
+    Insert(slice);
+
+    if (!_options.directory.empty() && slice->To() < slice->LoadedAt()) {
+        SubmitSnapshot(slice);
+    }
+
+    return slice;
+}
+
+std::shared_ptr<const DayUniques> DayCache::FindRollup(const std::string& day) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto it = _rollups.find(day);
+    return it == _rollups.end() ? nullptr : it->second;
+}
+
+void DayCache::StoreRollup(const std::string& day, const DayUniques& uniques) {
+    auto rollup       = std::make_shared<DayUniques>(uniques);
+    rollup->is_rollup = true;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _rollups[day] = std::move(rollup);
+
+    while (_rollups.size() > ROLLUP_CAPACITY) {
+        _rollups.erase(_rollups.begin());
+    }
+}
+
+void DayCache::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _slices.clear();
+    _rollups.clear();
+}
+
+bool DayCache::IsExpired(const CachedSlice& cached, time_t now) const {
+    const LogSlice& slice = *cached.slice;
+    if (slice.To() >= slice.LoadedAt())
+        return now - slice.LoadedAt() > OPEN_SLICE_TTL;
+    return now - cached.used_at > _options.idle_ttl;
+}
+
+void DayCache::Evict(time_t now) {
+    _slices.remove_if([&](const CachedSlice& cached) { return IsExpired(cached, now); });
+
+    // Индекс строится после сохранения среза, поэтому размер пересчитывается при каждом вызове
+    size_t bytes = 0;
+    for (const CachedSlice& cached : _slices) {
+        bytes += cached.slice->MemoryUsage();
+    }
+
+    // Индекс мог достроиться после подсчета: вычитание не уходит ниже нуля
+    while (bytes > _options.memory_bytes) {
+        bytes -= std::min(bytes, _slices.back().slice->MemoryUsage());
+        _slices.pop_back();
+    }
+}
+
+std::string DayCache::SnapshotPath(time_t from, time_t to) const {
+    return _options.directory + "/" + std::string(SNAPSHOT_PREFIX) + std::to_string(from) + "-" +
+           std::to_string(to) + std::string(SNAPSHOT_EXTENSION);
+}
+
+std::shared_ptr<const LogSlice> DayCache::LoadSnapshot(time_t from, time_t to) {
+    const std::string path = SnapshotPath(from, to);
+
+    std::error_code error;
+    if (!std::filesystem::exists(path, error))
+        return nullptr;
+
+    // Проверка контрольных сумм остается: записи среза ссылаются прямо в файл, и смещения
+    // поврежденного снимка не должны выводить string_view за отображение
+    try {
+        return std::make_shared<const LogSlice>(from, to, snapshots::LogSnapshot::Open(path));
+    } catch (const std::exception&) {
+        std::filesystem::remove(path, error);
+        return nullptr;
+    }
+}
+
+void DayCache::SubmitSnapshot(std::shared_ptr<const LogSlice> slice) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_write_queue.size() >= WRITE_QUEUE ||
+            !_writing.insert(SnapshotPath(slice->From(), slice->To())).second)
+            return;
+        _write_queue.push_back(std::move(slice));
+    }
+    _write_wakeup.notify_one();
+}
+
+void DayCache::RunWriter() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true) {
+        _write_wakeup.wait(lock, [this] { return _stopping || !_write_queue.empty(); });
+        if (_stopping)
+            return;
+
+        const std::shared_ptr<const LogSlice> slice = std::move(_write_queue.front());
+        _write_queue.pop_front();
+
+        lock.unlock();
+        WriteSnapshot(*slice);
+        lock.lock();
+
+        _writing.erase(SnapshotPath(slice->From(), slice->To()));
+    }
+}
+
+void DayCache::WriteSnapshot(const LogSlice& slice) {
+    const std::string path = SnapshotPath(slice.From(), slice.To());
+
+    try {
+        std::error_code error;
+        if (std::filesystem::exists(path, error))
+            return;
+        std::filesystem::create_directories(_options.directory, error);
+
+        // Без Finish временный файл удаляется
+        snapshots::LogSnapshotWriter writer(path);
+        const CompactLogSpan         logs = slice.Compact();
+        for (size_t row = 0; row < logs.size(); ++row) {
+            if (row % STOP_CHECK_ROWS == 0 && _stopping.load(std::memory_order_relaxed))
+                return;
+            writer.Add(logs[row]);
+        }
+        writer.Finish();
+
+        PruneSnapshots();
+    } catch (const std::exception&) {
+        // День остается в памяти; следующий промах попробует записать его снова
+    }
+}
+
+void DayCache::PruneSnapshots() {
+    std::vector<std::pair<long long, std::filesystem::path>> days;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(_options.directory, error)) {
+        const std::string name = entry.path().filename().string();
+        if (!name.starts_with(SNAPSHOT_PREFIX) || !name.ends_with(SNAPSHOT_EXTENSION))
+            continue;
+        days.emplace_back(std::strtoll(name.c_str() + SNAPSHOT_PREFIX.size(), nullptr, 10),
+                          entry.path());
+    }
+
+    if (days.size() <= DISK_CAPACITY)
+        return;
+
+    std::sort(days.begin(), days.end());
+    for (size_t i = 0; i + DISK_CAPACITY < days.size(); ++i) {
+        std::filesystem::remove(days[i].second, error);
+    }
+}
+
+void DayCache::Insert(const std::shared_ptr<const LogSlice>& slice) {
+    const time_t now = std::time(nullptr);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _slices.remove_if([&](const CachedSlice& cached) {
+        return cached.slice->From() == slice->From() && cached.slice->To() == slice->To();
+    });
+    _slices.push_front({slice, now});
+
+    Evict(now);
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "filters/LogColumns.h"
+#include "filters/TokenIndex.h"
+#include "records/CompactLogStore.h"
+#include "snapshots/LogSnapshot.h"
+#include "structures/DayUniques.h"
+
+// Загруженный срез логов [from, to] с колоночным представлением и индексом токенов
+class LogSlice {
+public:
+    LogSlice(time_t from, time_t to, std::vector<ReportServerLog>&& logs);
+
+    // Срез над отображенным снимком: строки не копируются, записи ссылаются прямо в файл.
+    // Отдельно хранится только текст времени строк без TimeText (20 байт на строку)
+    LogSlice(time_t from, time_t to, snapshots::LogSnapshot&& snapshot);
+
+    LogSlice(const LogSlice&)            = delete;
+    LogSlice& operator=(const LogSlice&) = delete;
+
+    [[nodiscard]] time_t From() const { return _from; }
+    [[nodiscard]] time_t To() const { return _to; }
+    [[nodiscard]] time_t LoadedAt() const { return _loaded_at; }
+
+    [[nodiscard]] size_t                     Size() const { return _compact.Size(); }
+    [[nodiscard]] const filters::LogColumns& Columns() const { return _columns; }
+
+    // Строки среза без копирования, время разобрано
+    [[nodiscard]] CompactLogSpan Compact() const { return _compact.Logs(); }
+
+    // Индекс строится при первом поиске по срезу
+    [[nodiscard]] const filters::TokenIndex& Index() const;
+
+    // Оценка памяти: строки и записи (у снимка - отображение) и индекс, если построен
+    [[nodiscard]] size_t MemoryUsage() const;
+
+private:
+    time_t _from;
+    time_t _to;
+    time_t _loaded_at;
+
+    // Источник строк: логи сервера либо снимок
+    std::vector<ReportServerLog>            _logs;
+    std::unique_ptr<snapshots::LogSnapshot> _snapshot;
+    std::string                             _time_text;
+
+    records::CompactLogStore _compact;
+    filters::LogColumns      _columns;
+    size_t                   _bytes = 0; // MemoryUsage без индекса
+
+    mutable std::once_flag                       _index_once;
+    mutable std::unique_ptr<filters::TokenIndex> _index;
+    mutable std::atomic<size_t>                  _index_bytes{0};
+};
+
+// Настройки из окружения: DAILY_LOGS_DAY_CACHE_DIR - каталог дискового уровня (пустой -
+// уровень выключен), DAILY_LOGS_DAY_CACHE_MB - предел памяти срезов (по умолчанию 1024),
+// DAILY_LOGS_DAY_CACHE_IDLE_SEC - сколько завершенный день живет без обращений (по умолчанию 1800)
+struct DayCacheOptions {
+    std::string directory;
+    size_t      memory_bytes = size_t{1024} * 1024 * 1024;
+    time_t      idle_ttl     = 30 * 60;
+};
+
+DayCacheOptions DayCacheOptionsFromEnvironment();
+
+// Кеш загруженных дней. Срезы, захватывающие текущее время, еще пополняются на сервере,
+// поэтому живут недолго; завершенные дни живут, пока к ним обращаются чаще idle_ttl.
+// Сверх memory_bytes вытесняются давно не использованные срезы, в том числе только что
+// сохраненный, если он один больше предела (отчет, загрузивший его, держит свою ссылку).
+// Общий экземпляр принадлежит runtime::PluginRuntime и освобождается в DestroyReport.
+//
+// С каталогом завершенные дни еще и сохраняются снимками snapshots::LogSnapshot: они
+// переживают DestroyReport и перезапуск хоста, промах в памяти читает день с диска вместо
+// GetLogs. Снимки пишет фоновый поток - Store не ждет диска; при полной очереди день не
+// сохраняется (попробует следующий промах). Ошибки диска не мешают отчету - день просто
+// загружается с сервера
+class DayCache {
+public:
+    explicit DayCache(DayCacheOptions options = {});
+
+    DayCache(const DayCache&)            = delete;
+    DayCache& operator=(const DayCache&) = delete;
+
+    // Останавливает запись: снимок, который пишется, бросается, очередь не дописывается
+    ~DayCache();
+
+    std::shared_ptr<const LogSlice> Find(time_t from, time_t to);
+
+    std::shared_ptr<const LogSlice>
+    Store(time_t from, time_t to, std::vector<ReportServerLog>&& logs);
+
+    // Свертки завершенных дней ("YYYY-MM-DD"): эскизы уникальных клиентов и IP.
+    // Хранятся дольше срезов - десятки килобайт на день вместо всех строк
+    std::shared_ptr<const DayUniques> FindRollup(const std::string& day);
+
+    void StoreRollup(const std::string& day, const DayUniques& uniques);
+
+    void Clear();
+
+private:
+    static constexpr size_t ROLLUP_CAPACITY = 62;
+    static constexpr time_t OPEN_SLICE_TTL  = 60;
+    static constexpr size_t DISK_CAPACITY   = 62;
+    static constexpr size_t WRITE_QUEUE     = 2;
+
+    struct CachedSlice {
+        std::shared_ptr<const LogSlice> slice;
+        time_t                          used_at;
+    };
+
+    DayCacheOptions _options;
+
+    std::mutex             _mutex;
+    std::list<CachedSlice> _slices; // от недавно использованных к старым
+
+    // Вытесняются самые старые дни
+    std::map<std::string, std::shared_ptr<const DayUniques>> _rollups;
+
+    // Запись снимков
+    std::set<std::string>                       _writing; // в очереди и пишутся
+    std::deque<std::shared_ptr<const LogSlice>> _write_queue;
+    std::condition_variable                     _write_wakeup;
+    std::atomic<bool>                           _stopping{false};
+    std::thread                                 _writer;
+
+    bool IsExpired(const CachedSlice& cached, time_t now) const;
+
+    // Под _mutex: убирает устаревшие срезы и давно не использованные сверх memory_bytes
+    void Evict(time_t now);
+
+    std::string SnapshotPath(time_t from, time_t to) const;
+
+    // nullptr - снимка нет или он поврежден (тогда удаляется)
+    std::shared_ptr<const LogSlice> LoadSnapshot(time_t from, time_t to);
+
+    // Ставит день в очередь записи без ожидания
+    void SubmitSnapshot(std::shared_ptr<const LogSlice> slice);
+
+    void RunWriter();
+
+    void WriteSnapshot(const LogSlice& slice);
+
+    // Оставляет DISK_CAPACITY самых поздних дней
+    void PruneSnapshots();
+
+    void Insert(const std::shared_ptr<const LogSlice>& slice);
+};
@@ -0,0 +1,187 @@
+#include "CaptureWriter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+
+#include "snapshots/LogSnapshot.h"
+
+namespace capture {
+    namespace {
+        constexpr int MANIFEST_VERSION = 1;
+
+        // Временный файл рядом и rename: читатель не увидит половину манифеста
+        void WriteFileAtomically(const std::string& path, const char* data, size_t size) {
+            const std::string temporary = path + ".tmp";
+
+            bool       is_written = false;
+            std::FILE* file       = std::fopen(temporary.c_str(), "w");
+            if (file != nullptr) {
+                is_written = std::fwrite(data, 1, size, file) == size;
+                is_written = std::fclose(file) == 0 && is_written;
+                is_written = is_written && std::rename(temporary.c_str(), path.c_str()) == 0;
+            }
+
+            if (!is_written) {
+                const int error = errno;
+                std::remove(temporary.c_str());
+                throw std::runtime_error("capture " + path + ": " + std::strerror(error));
+            }
+        }
+    } // namespace
+
+    CaptureOptions CaptureOptionsFromEnvironment() {
+        CaptureOptions options;
+
+        if (const char* directory = std::getenv("DAILY_LOGS_CAPTURE_DIR")) {
+            options.directory = directory;
+        }
+
+        if (const char* every = std::getenv("DAILY_LOGS_CAPTURE_EVERY")) {
+            char*      end   = nullptr;
+            const long value = std::strtol(every, &end, 10);
+            if (*every != '\0' && *end == '\0' && value > 0) {
+                options.every = static_cast<uint32_t>(value);
+            }
+        }
+
+        return options;
+    }
+
+    CaptureWriter::CaptureWriter(CaptureOptions            options,
+                                 logging::AsyncLogger&     logger,
+                                 metrics::MetricsRegistry& metrics)
+        : _options(std::move(options)), _logger(logger),
+          _written(metrics.GetCounter("daily_logs_captures_written_total",
+                                      "Reports captured for offline replay")),
+          _dropped(metrics.GetCounter("daily_logs_captures_dropped_total",
+                                      "Captures dropped because the write queue was full")),
+          _failed(metrics.GetCounter("daily_logs_captures_failed_total",
+                                     "Captures that could not be written")) {
+        _thread = std::thread([this] { Run(); });
+    }
+
+    CaptureWriter::~CaptureWriter() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+    }
+
+    bool CaptureWriter::ShouldCapture() {
+        return _reports.fetch_add(1, std::memory_order_relaxed) % _options.every == 0;
+    }
+
+    void CaptureWriter::Submit(std::unique_ptr<ReportCapture> capture) {
+        if (capture == nullptr)
+            return;
+
+        {
+            std::lock_guard lock(_mutex);
+            if (_queue.size() < QUEUE_CAPACITY) {
+                _queue.push_back(std::move(capture));
+                capture = nullptr;
+            }
+        }
+
+        if (capture != nullptr) {
+            _dropped.Add();
+            return;
+        }
+        _wakeup.notify_one();
+    }
+
+    void CaptureWriter::Run() {
+        std::unique_lock lock(_mutex);
+
+        while (true) {
+            _wakeup.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_queue.empty())
+                return;
+
+            std::unique_ptr<ReportCapture> capture = std::move(_queue.front());
+            _queue.pop_front();
+
+            // Запись и освобождение арен - без мьютекса: Submit не ждет диска
+            lock.unlock();
+            try {
+                Write(*capture);
+                _written.Add();
+            } catch (const std::exception& e) {
+                _failed.Add();
+                _logger.Log(logging::LogLevel::Error, "%s", e.what());
+            }
+            capture.reset();
+            lock.lock();
+        }
+    }
+
+    void CaptureWriter::Write(const ReportCapture& capture) {
+        std::filesystem::create_directories(_options.directory);
+
+        const std::string name = "capture-" + std::to_string(capture.CapturedAt()) + "-" +
+                                 std::to_string(::getpid()) + "-" + std::to_string(++_sequence);
+        const std::string base = _options.directory + "/" + name;
+
+        snapshots::LogSnapshotWriter snapshot(base + ".dlsnap");
+
+        rapidjson::StringBuffer                    buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+        writer.Key("version");
+        writer.Int(MANIFEST_VERSION);
+        writer.Key("captured_at");
+        writer.Int64(capture.CapturedAt());
+        writer.Key("snapshot");
+        writer.String((name + ".dlsnap").c_str());
+        writer.Key("request");
+        capture.Request().Accept(writer);
+
+        writer.Key("calls");
+        writer.StartArray();
+
+        uint64_t first_row = 0;
+        for (const CapturedCall& call : capture.Calls()) {
+            for (const CompactLog& log : call.logs.Logs()) {
+                snapshot.Add(log);
+            }
+
+            writer.StartObject();
+            writer.Key("from");
+            writer.Int64(call.from);
+            writer.Key("to");
+            writer.Int64(call.to);
+            writer.Key("type");
+            writer.String(call.type.c_str());
+            writer.Key("filter");
+            writer.String(call.filter.c_str());
+            writer.Key("result");
+            writer.Int(call.result);
+            writer.Key("elapsed_ms");
+            writer.Double(call.elapsed_ms);
+            writer.Key("first_row");
+            writer.Uint64(first_row);
+            writer.Key("rows");
+            writer.Uint64(call.logs.Size());
+            writer.EndObject();
+
+            first_row += call.logs.Size();
+        }
+
+        writer.EndArray();
+        writer.EndObject();
+
+        snapshot.Finish();
+        WriteFileAtomically(base + ".json", buffer.GetString(), buffer.GetSize());
+    }
+} // namespace capture
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "capture/ReportCapture.h"
+#include "logging/AsyncLogger.h"
+#include "metrics/MetricsRegistry.h"
+
+namespace capture {
+    // Настройки из окружения: DAILY_LOGS_CAPTURE_DIR - каталог записей (пустой - запись
+    // выключена) и DAILY_LOGS_CAPTURE_EVERY - записывается каждый N-й отчет (по умолчанию 1)
+    struct CaptureOptions {
+        std::string directory;
+        uint32_t    every = 1;
+    };
+
+    CaptureOptions CaptureOptionsFromEnvironment();
+
+    // Фоновая запись отчетов для воспроизведения. Каждая запись - два файла в каталоге:
+    //   capture-<время>-<pid>-<номер>.dlsnap - строки всех GetLogs подряд (snapshots::LogSnapshot);
+    //   capture-<время>-<pid>-<номер>.json   - манифест: version, captured_at, snapshot, request
+    //     и calls - from, to, type, filter, result, elapsed_ms, first_row, rows по вызовам.
+    // Манифест пишется последним и атомарно: его наличие означает, что запись целая
+    class CaptureWriter {
+    public:
+        CaptureWriter(CaptureOptions            options,
+                      logging::AsyncLogger&     logger,
+                      metrics::MetricsRegistry& metrics);
+
+        CaptureWriter(const CaptureWriter&)            = delete;
+        CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+        // Дописывает очередь и останавливает поток
+        ~CaptureWriter();
+
+        // true - очередной отчет записывается
+        bool ShouldCapture();
+
+        // Без ожидания: при полной очереди запись отбрасывается
+        void Submit(std::unique_ptr<ReportCapture> capture);
+
+    private:
+        static constexpr size_t QUEUE_CAPACITY = 4;
+
+        CaptureOptions        _options;
+        logging::AsyncLogger& _logger;
+        metrics::Counter&     _written;
+        metrics::Counter&     _dropped;
+        metrics::Counter&     _failed;
+
+        std::atomic<uint64_t> _reports{0};
+        uint64_t              _sequence = 0; // только поток записи
+
+        std::mutex                                 _mutex;
+        std::condition_variable                    _wakeup;
+        std::deque<std::unique_ptr<ReportCapture>> _queue;
+        bool                                       _stopping = false;
+        std::thread                                _thread;
+
+        void Run();
+
+        void Write(const ReportCapture& capture);
+    };
+} // namespace capture
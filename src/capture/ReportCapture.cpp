@@ -0,0 +1,79 @@
+#include "ReportCapture.h"
+
+#include <chrono>
+#include <utility>
+
+#include "capture/CaptureWriter.h"
+
+namespace capture {
+    namespace {
+        void Redact(rapidjson::Value& value, rapidjson::Document::AllocatorType& allocator) {
+            if (value.IsString()) {
+                value.SetString("<redacted>", allocator);
+            } else if (value.IsNumber()) {
+                value.SetInt(0);
+            } else if (value.IsObject()) {
+                for (auto& member : value.GetObject()) {
+                    Redact(member.value, allocator);
+                }
+            } else if (value.IsArray()) {
+                for (auto& element : value.GetArray()) {
+                    Redact(element, allocator);
+                }
+            }
+        }
+    } // namespace
+
+    void RedactAccess(rapidjson::Value& request, rapidjson::Document::AllocatorType& allocator) {
+        if (!request.IsObject())
+            return;
+
+        const auto access = request.FindMember("__access");
+        if (access != request.MemberEnd()) {
+            Redact(access->value, allocator);
+        }
+    }
+
+    ReportCapture::ReportCapture(const rapidjson::Value& request)
+        : _captured_at(std::time(nullptr)) {
+        _request.CopyFrom(request, _request.GetAllocator());
+        RedactAccess(_request, _request.GetAllocator());
+    }
+
+    void ReportCapture::AddCall(CapturedCall call, std::span<const ReportServerLog> logs) {
+        // Копия в арену - вне мьютекса: параллельные загрузки не ждут друг друга
+        call.logs.Append(logs);
+
+        std::lock_guard lock(_mutex);
+        _calls.push_back(std::move(call));
+    }
+
+    CapturingServer::CapturingServer(ReportServerInterface*         server,
+                                     std::unique_ptr<ReportCapture> capture,
+                                     CaptureWriter&                 writer)
+        : _server(server), _capture(std::move(capture)), _writer(writer) {}
+
+    CapturingServer::~CapturingServer() { _writer.Submit(std::move(_capture)); }
+
+    int CapturingServer::GetLogs(time_t                        from,
+                                 time_t                        to,
+                                 const std::string&            type,
+                                 const std::string&            filter,
+                                 std::vector<ReportServerLog>* logs) {
+        const size_t first   = logs->size();
+        const auto   started = std::chrono::steady_clock::now();
+        const int    result  = _server->GetLogs(from, to, type, filter, logs);
+
+        CapturedCall call;
+        call.from       = from;
+        call.to         = to;
+        call.type       = type;
+        call.filter     = filter;
+        call.result     = result;
+        call.elapsed_ms = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - started)
+                              .count();
+        _capture->AddCall(std::move(call), std::span(*logs).subspan(first));
+        return result;
+    }
+} // namespace capture
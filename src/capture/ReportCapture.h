@@ -0,0 +1,213 @@
+#pragma once
+
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <rapidjson/document.h>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "records/CompactLogStore.h"
+
+namespace capture {
+    class CaptureWriter;
+
+    // Вызов GetLogs и строки, которые добавил хост
+    struct CapturedCall {
+        time_t                   from = 0;
+        time_t                   to   = 0;
+        std::string              type;
+        std::string              filter;
+        int                      result     = 0;
+        double                   elapsed_ms = 0; // время хоста
+        records::CompactLogStore logs;
+    };
+
+    // Запись одного CreateReport для офлайн-воспроизведения: запрос с обезличенным
+    // __access и точные ответы GetLogs в порядке вызовов. Строки копируются в арены при
+    // вызове, файлы пишет CaptureWriter в фоне
+    class ReportCapture {
+    public:
+        explicit ReportCapture(const rapidjson::Value& request);
+
+        ReportCapture(const ReportCapture&)            = delete;
+        ReportCapture& operator=(const ReportCapture&) = delete;
+
+        // Безопасен из нескольких потоков загрузки
+        void AddCall(CapturedCall call, std::span<const ReportServerLog> logs);
+
+        [[nodiscard]] const rapidjson::Document& Request() const { return _request; }
+        [[nodiscard]] time_t                     CapturedAt() const { return _captured_at; }
+
+        // Только после завершения отчета: вызовы больше не добавляются
+        [[nodiscard]] const std::vector<CapturedCall>& Calls() const { return _calls; }
+
+    private:
+        rapidjson::Document _request;
+        time_t              _captured_at;
+
+        std::mutex                _mutex;
+        std::vector<CapturedCall> _calls;
+    };
+
+    // Строковые значения __access заменяются на "<redacted>", числа - на 0; ключи
+    // и структура сохраняются, чтобы запрос оставался допустимым для валидатора
+    void RedactAccess(rapidjson::Value& request, rapidjson::Document::AllocatorType& allocator);
+
+    // Хост для конвейера в режиме записи: вызовы уходят к настоящему хосту, ответы GetLogs
+    // копируются в запись. При разрушении - после последнего GetLogs отчета, в том числе
+    // пережившего дедлайн, - запись передается writer
+    class CapturingServer : public ReportServerInterface {
+    public:
+        CapturingServer(ReportServerInterface*         server,
+                        std::unique_ptr<ReportCapture> capture,
+                        CaptureWriter&                 writer);
+
+        CapturingServer(const CapturingServer&)            = delete;
+        CapturingServer& operator=(const CapturingServer&) = delete;
+
+        ~CapturingServer() override;
+
+        int GetLogs(time_t                        from,
+                    time_t                        to,
+                    const std::string&            type,
+                    const std::string&            filter,
+                    std::vector<ReportServerLog>* logs) override;
+
+        int GetAccountsByGroup(const std::string&                group,
+                               std::vector<ReportAccountRecord>* accounts) override {
+            return _server->GetAccountsByGroup(group, accounts);
+        }
+        int GetAccountByLogin(int login, ReportAccountRecord* account) override {
+            return _server->GetAccountByLogin(login, account);
+        }
+        int GetAccountBalanceByLogin(int login, ReportMarginLevel* margin) override {
+            return _server->GetAccountBalanceByLogin(login, margin);
+        }
+        int GetMarginLevelByGroup(const std::string&              group,
+                                  std::vector<ReportMarginLevel>* margins) override {
+            return _server->GetMarginLevelByGroup(group, margins);
+        }
+        int GetAccountsEquitiesByGroup(time_t                           from,
+                                       time_t                           to,
+                                       const std::string&               group_filter,
+                                       std::vector<ReportEquityRecord>* equities) override {
+            return _server->GetAccountsEquitiesByGroup(from, to, group_filter, equities);
+        }
+        int GetAccountsEquitiesByLogin(time_t                           from,
+                                       time_t                           to,
+                                       int                              login,
+                                       std::vector<ReportEquityRecord>* equities) override {
+            return _server->GetAccountsEquitiesByLogin(from, to, login, equities);
+        }
+
+        int GetOpenTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetOpenTradesByLogin(login, trades);
+        }
+        int GetPendingTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetPendingTradesByLogin(login, trades);
+        }
+        int GetOpenTradesByMagic(int magic, std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetOpenTradesByMagic(magic, trades);
+        }
+        int GetOpenTradeByOrder(int order, ReportTradeRecord* trade) override {
+            return _server->GetOpenTradeByOrder(order, trade);
+        }
+        int GetOpenTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override {
+            return _server->GetOpenTradeByGwUUID(gw_uuid, trade);
+        }
+        int GetCloseTradeByGwUUID(const std::string& gw_uuid, ReportTradeRecord* trade) override {
+            return _server->GetCloseTradeByGwUUID(gw_uuid, trade);
+        }
+        int GetOpenTradeByGwOrder(const std::string& gw_order, ReportTradeRecord* trade) override {
+            return _server->GetOpenTradeByGwOrder(gw_order, trade);
+        }
+        int GetCloseTradeByGwOrder(const std::string& gw_order,
+                                   ReportTradeRecord* trade) override {
+            return _server->GetCloseTradeByGwOrder(gw_order, trade);
+        }
+        int GetCloseTradesByLogin(int login, std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetCloseTradesByLogin(login, trades);
+        }
+        int GetCloseTradesByGroup(const std::string&              filter_group,
+                                  time_t                          from,
+                                  time_t                          to,
+                                  std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetCloseTradesByGroup(filter_group, from, to, trades);
+        }
+        int GetPendingTradesByGroup(const std::string&              filter_group,
+                                    time_t                          from,
+                                    time_t                          to,
+                                    std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetPendingTradesByGroup(filter_group, from, to, trades);
+        }
+        int GetOpenTradesByGroup(const std::string&              filter_group,
+                                 time_t                          from,
+                                 time_t                          to,
+                                 std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetOpenTradesByGroup(filter_group, from, to, trades);
+        }
+        int GetAllOpenTrades(std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetAllOpenTrades(trades);
+        }
+        int GetTransactionsByGroup(const std::string&              filter_group,
+                                   time_t                          from,
+                                   time_t                          to,
+                                   std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetTransactionsByGroup(filter_group, from, to, trades);
+        }
+        int GetTransactionsByLogin(int                             login,
+                                   time_t                          from,
+                                   time_t                          to,
+                                   std::vector<ReportTradeRecord>* trades) override {
+            return _server->GetTransactionsByLogin(login, from, to, trades);
+        }
+
+        int CalculateCommission(const ReportTradeRecord& trade, double* commission) override {
+            return _server->CalculateCommission(trade, commission);
+        }
+        int CalculateSwap(const ReportTradeRecord& trade, double* swap) override {
+            return _server->CalculateSwap(trade, swap);
+        }
+        int CalculateProfit(const ReportTradeRecord& trade, double* profit) override {
+            return _server->CalculateProfit(trade, profit);
+        }
+        int CalculateMargin(const ReportTradeRecord& trade, double* margin) override {
+            return _server->CalculateMargin(trade, margin);
+        }
+        int CalculateConvertRateByCurrency(const std::string& from_cur,
+                                           const std::string& to_cur,
+                                           int                cmd,
+                                           double*            multiplier) override {
+            return _server->CalculateConvertRateByCurrency(from_cur, to_cur, cmd, multiplier);
+        }
+
+        int GetSymbol(const std::string& symbol, ReportSymbolRecord* cs) override {
+            return _server->GetSymbol(symbol, cs);
+        }
+        int MatchWildCardGroup(const std::string& mask, const std::string& group) override {
+            return _server->MatchWildCardGroup(mask, group);
+        }
+        int GetGroup(const std::string& group_name, ReportGroupRecord* group) override {
+            return _server->GetGroup(group_name, group);
+        }
+        int GetAllGroups(std::vector<ReportGroupRecord>* groups) override {
+            return _server->GetAllGroups(groups);
+        }
+
+        int GetCandles(const std::string&               symbol,
+                       const std::string&               frame,
+                       time_t                           from,
+                       time_t                           to,
+                       std::vector<ReportCandleRecord>* candles) override {
+            return _server->GetCandles(symbol, frame, from, to, candles);
+        }
+
+    private:
+        ReportServerInterface*         _server;
+        std::unique_ptr<ReportCapture> _capture;
+        CaptureWriter&                 _writer;
+    };
+} // namespace capture
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Structures.h"
+
+// Важность записи журнала
+enum class LogSeverity : uint8_t {
+    Unknown,  // статус не распознан
+    Normal,   // штатное сообщение
+    Warning,  // предупреждение
+    Error,    // ошибка
+    Critical  // критическая ошибка
+};
+
+namespace classifiers {
+    struct SeverityToken {
+        std::string_view token; // регистр не важен
+        LogSeverity      severity;
+    };
+
+    // Код ReturnCodes по имени: ссылка на перечислитель не даст записать в таблицу код,
+    // которого нет в Structures.h
+    consteval SeverityToken ReturnCodeToken(std::string_view name,
+                                            ReturnCodes      code,
+                                            LogSeverity      severity) {
+        static_cast<void>(code);
+        return {name, severity};
+    }
+
+#define RETURN_CODE(code, severity) ReturnCodeToken(#code, code, LogSeverity::severity)
+
+    // Известные статусы: общие слова и все коды ReturnCodes из Structures.h
+    inline constexpr SeverityToken SEVERITY_TOKENS[] = {
+        {"ok", LogSeverity::Normal},
+        {"success", LogSeverity::Normal},
+        {"successful", LogSeverity::Normal},
+        {"done", LogSeverity::Normal},
+        {"completed", LogSeverity::Normal},
+        {"accepted", LogSeverity::Normal},
+        {"info", LogSeverity::Normal},
+        {"connected", LogSeverity::Normal},
+        {"disconnected", LogSeverity::Normal},
+
+        {"warning", LogSeverity::Warning},
+        {"warn", LogSeverity::Warning},
+        {"timeout", LogSeverity::Warning},
+        {"retry", LogSeverity::Warning},
+        {"partial", LogSeverity::Warning},
+
+        {"error", LogSeverity::Error},
+        {"err", LogSeverity::Error},
+        {"fail", LogSeverity::Error},
+        {"failed", LogSeverity::Error},
+        {"failure", LogSeverity::Error},
+        {"denied", LogSeverity::Error},
+        {"rejected", LogSeverity::Error},
+        {"invalid", LogSeverity::Error},
+        {"exception", LogSeverity::Error},
+
+        {"critical", LogSeverity::Critical},
+        {"crit", LogSeverity::Critical},
+        {"fatal", LogSeverity::Critical},
+        {"panic", LogSeverity::Critical},
+        {"crash", LogSeverity::Critical},
+        {"emergency", LogSeverity::Critical},
+        {"alert", LogSeverity::Critical},
+
+        // В порядке объявления в ReturnCodes
+        RETURN_CODE(RET_OK, Normal),
+        RETURN_CODE(RET_OK_NONE, Normal),
+        RETURN_CODE(RET_ERROR, Error),
+        RETURN_CODE(RET_INVALID_DATA, Error),
+        RETURN_CODE(RET_TECH_PROBLEM, Critical),
+        RETURN_CODE(RET_OLD_VERSION, Warning),
+        RETURN_CODE(RET_NO_CONNECT, Critical),
+        RETURN_CODE(RET_NOT_ENOUGH_RIGHTS, Error),
+        RETURN_CODE(RET_TOO_FREQUENT, Warning),
+        RETURN_CODE(RET_MALFUNCTION, Critical),
+        RETURN_CODE(RET_GENERATE_KEY, Normal),
+        RETURN_CODE(RET_SECURITY_SESSION, Normal),
+        RETURN_CODE(RET_INVALID_PASSWORD, Error),
+        RETURN_CODE(RET_ERR_PARAMS, Error),
+        RETURN_CODE(RET_ERR_DATA, Error),
+        RETURN_CODE(RET_ERR_DISK, Critical),
+        RETURN_CODE(RET_ERR_MEM, Critical),
+        RETURN_CODE(RET_ERR_NETWORK, Critical),
+        RETURN_CODE(RET_ERR_PERMISSIONS, Error),
+        RETURN_CODE(RET_ERR_TIMEOUT, Warning),
+        RETURN_CODE(RET_ERR_CONNECTION, Critical),
+        RETURN_CODE(RET_ERR_NOSERVICE, Critical),
+        RETURN_CODE(RET_ERR_FREQUENT, Warning),
+        RETURN_CODE(RET_ERR_NOTFOUND, Error),
+        RETURN_CODE(RET_ERR_SHUTDOWN, Critical),
+        RETURN_CODE(RET_ERR_CANCEL, Warning),
+        RETURN_CODE(RET_ERR_DUPLICATE, Warning),
+        RETURN_CODE(RET_OK_CHANGE, Normal),
+        RETURN_CODE(RET_GROUP_NOT_FOUND, Error),
+        RETURN_CODE(RET_GROUP_USE_BY_USER, Error),
+        RETURN_CODE(RET_SEC_USE_BY_SYMBOL, Error),
+        RETURN_CODE(RET_SYMBOL_USE_BY_TRADE, Error),
+        RETURN_CODE(RET_SYMBOL_NOT_FOUND, Error),
+        RETURN_CODE(RET_SEC_NOT_FOUND, Error),
+        RETURN_CODE(RET_USER_NOT_FOUND, Error),
+        RETURN_CODE(RET_USR_LAST_ADMIN, Error),
+        RETURN_CODE(RET_USR_LOGIN_EXHAUSTED, Error),
+        RETURN_CODE(RET_USR_LOGIN_PROHIBITED, Error),
+        RETURN_CODE(RET_USR_LOGIN_EXIST, Error),
+        RETURN_CODE(RET_USR_SUICIDE, Error),
+        RETURN_CODE(RET_USR_INVALID_PASSWORD, Error),
+        RETURN_CODE(RET_USR_LIMIT_REACHED, Error),
+        RETURN_CODE(RET_USR_HAS_TRADES, Error),
+        RETURN_CODE(RET_USR_DIFFERENT_SERVERS, Error),
+        RETURN_CODE(RET_USR_DIFFERENT_CURRENCY, Error),
+        RETURN_CODE(RET_USR_IMPORT_BALANCE, Error),
+        RETURN_CODE(RET_USR_IMPORT_GROUP, Error),
+        RETURN_CODE(RET_USR_ACCOUNT_EXIST, Error),
+        RETURN_CODE(RET_ACCOUNT_DISABLED, Error),
+        RETURN_CODE(RET_BAD_ACCOUNT_INFO, Error),
+        RETURN_CODE(RET_PUBLIC_KEY_MISSING, Error),
+        RETURN_CODE(RET_TRADE_TIMEOUT, Warning),
+        RETURN_CODE(RET_TRADE_BAD_PRICES, Error),
+        RETURN_CODE(RET_TRADE_BAD_STOPS, Error),
+        RETURN_CODE(RET_TRADE_BAD_VOLUME, Error),
+        RETURN_CODE(RET_TRADE_MARKET_CLOSED, Warning),
+        RETURN_CODE(RET_TRADE_DISABLE, Error),
+        RETURN_CODE(RET_TRADE_NO_MONEY, Error),
+        RETURN_CODE(RET_TRADE_PRICE_CHANGED, Warning),
+        RETURN_CODE(RET_TRADE_OFFQUOTES, Warning),
+        RETURN_CODE(RET_TRADE_BROKER_BUSY, Warning),
+        RETURN_CODE(RET_TRADE_REQUOTE, Warning),
+        RETURN_CODE(RET_TRADE_ORDER_LOCKED, Warning),
+        RETURN_CODE(RET_TRADE_LONG_ONLY, Error),
+        RETURN_CODE(RET_TRADE_TOO_MANY_REQ, Warning),
+        RETURN_CODE(RET_TRADE_ACCEPTED, Normal),
+        RETURN_CODE(RET_TRADE_PROCESS, Normal),
+        RETURN_CODE(RET_TRADE_USER_CANCEL, Normal),
+        RETURN_CODE(RET_TRADE_MODIFY_DENIED, Error),
+        RETURN_CODE(RET_TRADE_CONTEXT_BUSY, Warning),
+        RETURN_CODE(RET_TRADE_EXPIRATION_DENIED, Error),
+        RETURN_CODE(RET_TRADE_TOO_MANY_ORDERS, Error),
+        RETURN_CODE(RET_TRADE_HEDGE_PROHIBITED, Error),
+        RETURN_CODE(RET_TRADE_PROHIBITED_BY_FIFO, Error),
+        RETURN_CODE(RET_DUPLICATE_RECORD, Error),
+        RETURN_CODE(RET_TRADE_SEC_NOT_FOUND, Error),
+        RETURN_CODE(RET_TRADE_INVALID_SL_TP, Error),
+        RETURN_CODE(RET_TRADE_BAD_CLOSE_TIME, Error),
+        RETURN_CODE(RET_TRADE_READ_ONLY, Error),
+        RETURN_CODE(RET_TRADE_INCORRECT_STATE, Error),
+        RETURN_CODE(RET_TRADE_INCORRECT_CMD, Error),
+        RETURN_CODE(RET_TRADE_INCORRECT_ORDER, Error),
+        RETURN_CODE(RET_TRADE_EXIST, Error),
+        RETURN_CODE(RET_TRADE_LIMIT_REACHED, Error),
+        RETURN_CODE(RET_TRADE_HAS_OPEN, Error),
+        RETURN_CODE(RET_FEED_ALREADY_LOAD, Warning),
+        RETURN_CODE(RET_FIX_SLOT_NOT_FOUND, Error),
+        RETURN_CODE(RET_FIX_SLOT_DISABLED, Error),
+        RETURN_CODE(RET_FIX_SLOT_NOT_ASSIGNED, Error),
+        RETURN_CODE(RET_FIX_SLOT_OUTSIDE_RUNTIME_POOL, Error),
+        RETURN_CODE(RET_FIX_SLOT_PASSWORD_INVALID, Error),
+        RETURN_CODE(RET_FIX_SLOT_RULES_DENY_LOGON, Error),
+        RETURN_CODE(RET_FIX_SLOT_RUNTIME_LIMIT_REACHED, Error),
+        RETURN_CODE(RET_FIX_RUNTIME_SESSION_UNAVAILABLE, Critical),
+        RETURN_CODE(RET_CFG_LAST_ADMIN, Error),
+        RETURN_CODE(RET_CFG_LAST_ADMIN_GROUP, Error),
+        RETURN_CODE(RET_CFG_NOT_EMPTY, Error),
+        RETURN_CODE(RET_CFG_INVALID_RANGE, Error),
+        RETURN_CODE(RET_CFG_NOT_MANAGER_LOGIN, Error),
+        RETURN_CODE(RET_CFG_BUILTIN, Error),
+        RETURN_CODE(RET_CFG_DUPLICATE, Error),
+        RETURN_CODE(RET_CFG_LIMIT_REACHED, Error),
+        RETURN_CODE(RET_CFG_NO_ACCESS_TO_MAIN, Error),
+        RETURN_CODE(RET_CFG_DEALER_ID_EXIST, Error),
+        RETURN_CODE(RET_CFG_BIND_ADDR_EXIST, Error),
+        RETURN_CODE(RET_CFG_WORKING_TRADE, Error),
+        RETURN_CODE(RET_CFG_GATEWAY_NAME_EXIST, Error),
+        RETURN_CODE(RET_CFG_SWITCH_TO_BACKUP, Warning),
+        RETURN_CODE(RET_CFG_NO_BACKUP_MODULE, Critical),
+        RETURN_CODE(RET_CFG_NO_TRADE_MODULE, Critical),
+        RETURN_CODE(RET_CFG_NO_HISTORY_MODULE, Critical),
+        RETURN_CODE(RET_CFG_ANOTHER_SWITCH, Warning),
+        RETURN_CODE(RET_CFG_NO_LICENSE_FILE, Critical),
+        RETURN_CODE(RET_CFG_GATEWAY_LOGIN_EXIST, Error),
+        RETURN_CODE(RET_LICENSE_NOT_ACTIVE, Critical),
+        RETURN_CODE(RET_BAD_REQUEST, Error),
+        RETURN_CODE(RET_UNAUTHORIZED, Error),
+        RETURN_CODE(RET_FIELD_REQUIRED, Error),
+        RETURN_CODE(RET_FORBIDDEN, Error),
+        RETURN_CODE(RET_NOT_FOUND, Error),
+        RETURN_CODE(RET_METHOD_NOT_ALLOWED, Error),
+        RETURN_CODE(RET_INVALID_METHOD, Error),
+        RETURN_CODE(RET_TIMEOUT, Warning),
+    };
+
+#undef RETURN_CODE
+
+    inline constexpr size_t SEVERITY_TOKENS_COUNT = std::size(SEVERITY_TOKENS);
+
+    constexpr char ToLowerAscii(char c) { return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c; }
+
+    // FNV-1a без учета регистра
+    constexpr uint32_t HashToken(std::string_view token, uint32_t seed) {
+        uint32_t hash = 2166136261u ^ seed;
+        for (const char c : token) {
+            hash ^= static_cast<uint8_t>(ToLowerAscii(c));
+            hash *= 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+
+    constexpr bool EqualsIgnoreCase(std::string_view left, std::string_view right) {
+        if (left.size() != right.size())
+            return false;
+        for (size_t i = 0; i < left.size(); ++i) {
+            if (ToLowerAscii(left[i]) != ToLowerAscii(right[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Идеальная хеш-функция: seed подбирается при компиляции так, чтобы все известные
+    // токены попали в разные слоты таблицы
+    class SeverityTable {
+    public:
+        // Без коллизий seed находится быстро, только если слотов на порядок больше токенов
+        static constexpr size_t  SLOTS = 4096;
+        static constexpr uint8_t EMPTY = UINT8_MAX;
+
+        static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+        static_assert(SLOTS >= SEVERITY_TOKENS_COUNT * 16, "Too many severity tokens");
+        static_assert(SEVERITY_TOKENS_COUNT < EMPTY, "Slot index does not fit");
+
+        consteval SeverityTable() {
+            for (uint32_t seed = 1; seed < 100000; ++seed) {
+                if (TryBuild(seed)) {
+                    _seed = seed;
+                    return;
+                }
+            }
+            _seed = 0;
+        }
+
+        [[nodiscard]] constexpr bool Valid() const { return _seed != 0; }
+
+        [[nodiscard]] constexpr LogSeverity Lookup(std::string_view value) const {
+            const size_t index = _slots[HashToken(value, _seed) & (SLOTS - 1)];
+            if (index == EMPTY || !EqualsIgnoreCase(value, SEVERITY_TOKENS[index].token))
+                return LogSeverity::Unknown;
+            return SEVERITY_TOKENS[index].severity;
+        }
+
+    private:
+        uint32_t                   _seed = 0;
+        std::array<uint8_t, SLOTS> _slots{};
+
+        constexpr bool TryBuild(uint32_t seed) {
+            _slots.fill(EMPTY);
+            for (size_t i = 0; i < SEVERITY_TOKENS_COUNT; ++i) {
+                uint8_t& slot = _slots[HashToken(SEVERITY_TOKENS[i].token, seed) & (SLOTS - 1)];
+                if (slot != EMPTY)
+                    return false;
+                slot = static_cast<uint8_t>(i);
+            }
+            return true;
+        }
+    };
+
+    inline constexpr SeverityTable SEVERITY_TABLE{};
+
+    static_assert(SEVERITY_TABLE.Valid(), "No perfect hash seed found for severity tokens");
+    static_assert(SEVERITY_TABLE.Lookup("ERROR") == LogSeverity::Error);
+    static_assert(SEVERITY_TABLE.Lookup("RET_OK") == LogSeverity::Normal);
+    static_assert(SEVERITY_TABLE.Lookup("ret_err_timeout") == LogSeverity::Warning);
+    static_assert(SEVERITY_TABLE.Lookup("something") == LogSeverity::Unknown);
+
+    // Классификация статуса: таблица известных токенов, затем HTTP-подобные коды.
+    // RET_*, которого нет в ReturnCodes, не распознан: о его важности ничего не известно
+    constexpr LogSeverity ClassifyStatus(std::string_view status) {
+        const LogSeverity severity = SEVERITY_TABLE.Lookup(status);
+        if (severity != LogSeverity::Unknown)
+            return severity;
+
+        if (status.size() == 3 && status[0] >= '1' && status[0] <= '5' && status[1] >= '0' &&
+            status[1] <= '9' && status[2] >= '0' && status[2] <= '9') {
+            return status[0] == '5'   ? LogSeverity::Critical
+                   : status[0] == '4' ? LogSeverity::Error
+                                      : LogSeverity::Normal;
+        }
+
+        return LogSeverity::Unknown;
+    }
+
+    static_assert(ClassifyStatus("RET_TIMEOUT") == LogSeverity::Warning);
+    static_assert(ClassifyStatus("RET_NOT_A_CODE") == LogSeverity::Unknown);
+
+    // Статус записи; нераспознанный статус уточняется по действию
+    constexpr LogSeverity ClassifyLog(std::string_view status, std::string_view action) {
+        const LogSeverity severity = ClassifyStatus(status);
+        if (severity != LogSeverity::Unknown)
+            return severity;
+        return SEVERITY_TABLE.Lookup(action);
+    }
+} // namespace classifiers
@@ -0,0 +1,150 @@
+#include "LogCollapser.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+#include "records/CompactLogStore.h"
+
+namespace collapse {
+    namespace {
+        constexpr time_t   MAX_WINDOW = 24 * 60 * 60;
+        constexpr size_t   MAX_GROUPS = 1 << 20;
+        constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+        constexpr uint64_t FNV_PRIME  = 1099511628211ULL;
+
+        // Поля разделяются нулевым байтом, чтобы "ab"+"c" и "a"+"bc" не совпадали
+        uint64_t HashField(uint64_t hash, std::string_view field) {
+            for (const char symbol : field) {
+                hash = (hash ^ static_cast<unsigned char>(symbol)) * FNV_PRIME;
+            }
+            return (hash ^ 0xFF) * FNV_PRIME;
+        }
+    } // namespace
+
+    bool ParseCollapseOptions(const rapidjson::Value& request, CollapseOptions* options) {
+        options->enabled = false;
+
+        if (!request.HasMember("collapse"))
+            return true;
+
+        const rapidjson::Value& collapse_value = request["collapse"];
+
+        if (collapse_value.IsBool()) {
+            options->enabled = collapse_value.GetBool();
+            return true;
+        }
+
+        if (!collapse_value.IsObject())
+            return false;
+
+        if (collapse_value.HasMember("window")) {
+            if (!collapse_value["window"].IsNumber())
+                return false;
+            const double window = collapse_value["window"].GetDouble();
+            if (window < 0 || window > MAX_WINDOW)
+                return false;
+            options->window = static_cast<time_t>(window);
+        }
+
+        if (collapse_value.HasMember("max_groups")) {
+            if (!collapse_value["max_groups"].IsNumber())
+                return false;
+            const double max_groups = collapse_value["max_groups"].GetDouble();
+            if (max_groups < 1 || max_groups > MAX_GROUPS)
+                return false;
+            options->max_groups = static_cast<size_t>(max_groups);
+        }
+
+        options->enabled = true;
+        return true;
+    }
+
+    LogCollapser::LogCollapser(const CollapseOptions& options, Sink sink)
+        : _options(options), _sink(std::move(sink)) {
+        _by_hash.reserve(_options.max_groups * 2);
+    }
+
+    void LogCollapser::Add(const CompactLog& log) {
+        ++_rows;
+
+        // Строка без разбираемого времени относится к текущему моменту потока
+        int64_t time = log.time;
+        if (time < 0) {
+            time = _now;
+        }
+        if (time > _now) {
+            _now = time;
+            CloseExpired();
+        }
+
+        const uint64_t hash = HashLog(log);
+
+        const auto found = _by_hash.find(hash);
+        if (found != _by_hash.end()) {
+            const GroupList::iterator group = found->second;
+            CollapsedLog&             collapsed = group->collapsed;
+
+            if (IsSameLog(collapsed.log, log) && time <= collapsed.last_seen + _options.window) {
+                collapsed.count++;
+                collapsed.first_seen = std::min(collapsed.first_seen, time);
+                if (time > collapsed.last_seen) {
+                    collapsed.last_seen = time;
+                    _open.splice(_open.end(), _open, group);
+                }
+                return;
+            }
+
+            // Окно истекло или коллизия хеша - группа закрывается, строка открывает новую
+            Close(group);
+        }
+
+        CollapsedLog collapsed;
+        collapsed.log        = records::ToReportServerLog(log);
+        collapsed.count      = 1;
+        collapsed.first_seen = time;
+        collapsed.last_seen  = time;
+
+        _open.push_back({hash, std::move(collapsed)});
+        _by_hash[hash] = std::prev(_open.end());
+
+        if (_open.size() > _options.max_groups) {
+            Close(_open.begin());
+        }
+    }
+
+    void LogCollapser::Flush() {
+        while (!_open.empty()) {
+            Close(_open.begin());
+        }
+    }
+
+    void LogCollapser::Close(GroupList::iterator group) {
+        _by_hash.erase(group->hash);
+        ++_groups;
+        _sink(std::move(group->collapsed));
+        _open.erase(group);
+    }
+
+    void LogCollapser::CloseExpired() {
+        while (!_open.empty() && _open.front().collapsed.last_seen + _options.window < _now) {
+            Close(_open.begin());
+        }
+    }
+
+    uint64_t LogCollapser::HashLog(const CompactLog& log) {
+        uint64_t hash = FNV_OFFSET;
+        hash = HashField(hash, log.actor_type);
+        hash = HashField(hash, log.actor_id);
+        hash = HashField(hash, log.action);
+        hash = HashField(hash, log.status);
+        hash = HashField(hash, log.source);
+        hash = HashField(hash, log.detail);
+        return hash;
+    }
+
+    bool LogCollapser::IsSameLog(const ReportServerLog& a, const CompactLog& b) {
+        return a.actor_type == b.actor_type && a.actor_id == b.actor_id && a.action == b.action &&
+               a.status == b.status && a.source == b.source && a.detail == b.detail;
+    }
+} // namespace collapse
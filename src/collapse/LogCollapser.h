@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <rapidjson/document.h>
+#include <unordered_map>
+
+#include "structures/CompactLog.h"
+#include "structures/CollapsedLog.h"
+
+namespace collapse {
+    // Разбор request["collapse"]; false - некорректное значение
+    bool ParseCollapseOptions(const rapidjson::Value& request, CollapseOptions* options);
+
+    // Потоковое сворачивание повторов. Открытые группы упорядочены по last_seen: группа
+    // закрывается и уходит в sink, когда окно истекло или открытых групп больше max_groups.
+    // Состояние ограничено max_groups записями независимо от длины потока
+    class LogCollapser {
+    public:
+        using Sink = std::function<void(CollapsedLog&&)>;
+
+        LogCollapser(const CollapseOptions& options, Sink sink);
+
+        void Add(const CompactLog& log);
+
+        // Закрывает все открытые группы
+        void Flush();
+
+        [[nodiscard]] uint64_t Rows() const { return _rows; }
+        [[nodiscard]] uint64_t Groups() const { return _groups; }
+
+    private:
+        struct Group {
+            uint64_t     hash;
+            CollapsedLog collapsed;
+        };
+
+        using GroupList = std::list<Group>;
+
+        CollapseOptions _options;
+        Sink            _sink;
+
+        GroupList                                        _open; // от старых last_seen к новым
+        std::unordered_map<uint64_t, GroupList::iterator> _by_hash;
+
+        int64_t  _now    = 0; // наибольшее время среди добавленных строк
+        uint64_t _rows   = 0;
+        uint64_t _groups = 0;
+
+        void Close(GroupList::iterator group);
+
+        void CloseExpired();
+
+        static uint64_t HashLog(const CompactLog& log);
+
+        static bool IsSameLog(const ReportServerLog& a, const CompactLog& b);
+    };
+} // namespace collapse
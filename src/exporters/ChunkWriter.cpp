@@ -0,0 +1,132 @@
+#include "ChunkWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace exporters {
+    namespace {
+        constexpr std::array<bool, 256> MakeCsvSpecials() {
+            std::array<bool, 256> table{};
+            table[static_cast<unsigned char>(',')]  = true;
+            table[static_cast<unsigned char>('"')]  = true;
+            table[static_cast<unsigned char>('\n')] = true;
+            table[static_cast<unsigned char>('\r')] = true;
+            return table;
+        }
+
+        constexpr std::array<bool, 256> MakeJsonSpecials() {
+            std::array<bool, 256> table{};
+            for (size_t i = 0; i < 0x20; ++i) {
+                table[i] = true;
+            }
+            table[static_cast<unsigned char>('"')]  = true;
+            table[static_cast<unsigned char>('\\')] = true;
+            return table;
+        }
+
+        constexpr std::array<bool, 256> CSV_SPECIALS  = MakeCsvSpecials();
+        constexpr std::array<bool, 256> JSON_SPECIALS = MakeJsonSpecials();
+
+        // Длина начального отрезка без спецсимволов
+        size_t SafePrefix(std::string_view value, const std::array<bool, 256>& specials) {
+            size_t i = 0;
+            while (i < value.size() && !specials[static_cast<unsigned char>(value[i])]) {
+                ++i;
+            }
+            return i;
+        }
+    } // namespace
+
+    ChunkWriter::ChunkWriter(std::FILE* file, size_t chunk_size)
+        : _file(file), _buffer(new char[std::max<size_t>(chunk_size, 64)]),
+          _capacity(std::max<size_t>(chunk_size, 64)) {}
+
+    void ChunkWriter::Append(std::string_view data) {
+        while (!data.empty()) {
+            if (_size == _capacity) {
+                Flush();
+            }
+
+            const size_t part = std::min(data.size(), _capacity - _size);
+            std::memcpy(_buffer.get() + _size, data.data(), part);
+            _size += part;
+            data.remove_prefix(part);
+        }
+    }
+
+    void ChunkWriter::AppendCsvField(std::string_view value) {
+        if (SafePrefix(value, CSV_SPECIALS) == value.size()) {
+            Append(value);
+            return;
+        }
+
+        Append('"');
+        while (!value.empty()) {
+            const size_t quote = value.find('"');
+            if (quote == std::string_view::npos) {
+                Append(value);
+                break;
+            }
+
+            // Кавычка удваивается
+            Append(value.substr(0, quote + 1));
+            Append('"');
+            value.remove_prefix(quote + 1);
+        }
+        Append('"');
+    }
+
+    void ChunkWriter::AppendJsonString(std::string_view value) {
+        static constexpr char HEX[] = "0123456789abcdef";
+
+        Append('"');
+        while (!value.empty()) {
+            const size_t safe = SafePrefix(value, JSON_SPECIALS);
+            Append(value.substr(0, safe));
+            if (safe == value.size())
+                break;
+
+            const unsigned char symbol = static_cast<unsigned char>(value[safe]);
+            switch (symbol) {
+                case '"':
+                    Append("\\\"");
+                    break;
+                case '\\':
+                    Append("\\\\");
+                    break;
+                case '\n':
+                    Append("\\n");
+                    break;
+                case '\r':
+                    Append("\\r");
+                    break;
+                case '\t':
+                    Append("\\t");
+                    break;
+                default: {
+                    const char escaped[] = {
+                        '\\', 'u', '0', '0', HEX[symbol >> 4], HEX[symbol & 0xF]};
+                    Append(std::string_view(escaped, sizeof(escaped)));
+                    break;
+                }
+            }
+            value.remove_prefix(safe + 1);
+        }
+        Append('"');
+    }
+
+    void ChunkWriter::Flush() {
+        if (_size == 0)
+            return;
+
+        if (std::fwrite(_buffer.get(), 1, _size, _file) != _size) {
+            throw std::runtime_error("ChunkWriter: write failed");
+        }
+
+        _bytes += _size;
+        _size = 0;
+        ++_chunks;
+    }
+} // namespace exporters
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+
+namespace exporters {
+    // Буфер фиксированного размера поверх файла: данные и экранирование пишутся прямо в
+    // буфер, заполненный буфер уходит в файл одним fwrite
+    class ChunkWriter {
+    public:
+        ChunkWriter(std::FILE* file, size_t chunk_size);
+
+        ChunkWriter(const ChunkWriter&)            = delete;
+        ChunkWriter& operator=(const ChunkWriter&) = delete;
+
+        void Append(std::string_view data);
+
+        void Append(char symbol) {
+            if (_size == _capacity) {
+                Flush();
+            }
+            _buffer[_size++] = symbol;
+        }
+
+        // Поле CSV по RFC 4180: в кавычках, только если содержит разделитель, кавычку или
+        // перевод строки
+        void AppendCsvField(std::string_view value);
+
+        // Строка JSON в кавычках
+        void AppendJsonString(std::string_view value);
+
+        void Flush();
+
+        [[nodiscard]] uint64_t Bytes() const { return _bytes + _size; }
+        [[nodiscard]] uint64_t Chunks() const { return _chunks; }
+
+    private:
+        std::FILE*              _file;
+        std::unique_ptr<char[]> _buffer;
+        size_t                  _capacity;
+        size_t                  _size   = 0;
+        uint64_t                _bytes  = 0; // записано в файл
+        uint64_t                _chunks = 0;
+    };
+} // namespace exporters
@@ -0,0 +1,245 @@
+#include "LogExporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "filters/LogFilters.h"
+#include "runtime/PluginRuntime.h"
+#include "tracing/Tracer.h"
+
+namespace exporters {
+    namespace {
+        constexpr size_t MIN_CHUNK_SIZE = 4 * 1024;
+        constexpr size_t MAX_CHUNK_SIZE = 64 * 1024 * 1024;
+
+        constexpr std::string_view CSV_HEADER =
+            "time,actor_id,actor_type,action,status,source,detail\n";
+
+        // Создает файл, которого еще нет: выгрузки не перезаписывают друг друга. В файле IP и
+        // детали записей - он доступен только владельцу процесса (0600), независимо от umask.
+        // Путь не попадает в текст исключения: сообщение показывается в интерфейсе
+        std::FILE* CreateExportFile(const std::filesystem::path& directory,
+                                    time_t                       from,
+                                    ExportFormat                 format,
+                                    std::string*                 path) {
+            static std::atomic<uint64_t> counter{0};
+
+            const char* extension = format == ExportFormat::Csv ? ".csv" : ".ndjson";
+
+            int error = 0;
+            for (int attempt = 0; attempt < 16; ++attempt) {
+                const std::string name = "daily_logs_" + std::to_string(from) + "_" +
+                                         std::to_string(std::time(nullptr)) + "_" +
+                                         std::to_string(counter++) + extension;
+
+                *path = (directory / name).string();
+
+                // O_EXCL - ошибка, если файл существует (в том числе подложенная ссылка)
+                const int descriptor =
+                    open(path->c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+                if (descriptor < 0) {
+                    error = errno;
+                    if (error != EEXIST)
+                        break;
+                    continue;
+                }
+
+                if (std::FILE* file = fdopen(descriptor, "wb")) {
+                    return file;
+                }
+
+                error = errno;
+                close(descriptor);
+                std::remove(path->c_str());
+                break;
+            }
+
+            throw std::runtime_error(std::string("ExportDayLogs: cannot create export file: ") +
+                                     std::strerror(error));
+        }
+
+        void WriteLogs(ReportServerInterface*        server,
+                       time_t                        from,
+                       time_t                        to,
+                       const std::vector<LogFilter>& filters,
+                       const ExportOptions&          options,
+                       LogExporter&                  exporter) {
+            if (const auto slice = runtime::PluginRuntime::Instance().Cache().Find(from, to)) {
+                const filters::TokenIndex* index = filters.empty() ? nullptr : &slice->Index();
+                const filters::Bitmap      selected =
+                    filters::SelectLogs(slice->Columns(), index, filters);
+
+                const CompactLogSpan logs = slice->Compact();
+                selected.ForEach([&](size_t row) { exporter.Write(logs[row]); });
+                return;
+            }
+
+            const LogQuery query =
+                filters::PlanLogQuery(from, to, filters, filters::HostFilterFromEnvironment());
+
+            // Один вектор на все окна: емкость сохраняется между окнами
+            std::vector<ReportServerLog> window_logs;
+
+            for (time_t window_from = query.from; window_from <= query.to;
+                 window_from += options.fetch_step) {
+                const time_t window_to = std::min(window_from + options.fetch_step - 1, query.to);
+
+                window_logs.clear();
+                {
+                    tracing::Span span("GetLogs", "fetch");
+                    span.SetArg("from", window_from);
+                    server->GetLogs(window_from, window_to, query.type, query.filter, &window_logs);
+                    span.SetArg("rows", static_cast<int64_t>(window_logs.size()));
+                }
+                filters::ApplyLogFilters(window_logs, query.residual);
+
+                for (const auto& log : window_logs) {
+                    exporter.Write(log);
+                }
+            }
+        }
+    } // namespace
+
+    LogExporter::LogExporter(std::FILE* file, const ExportOptions& options)
+        : _format(options.format), _writer(file, options.chunk_size) {
+        if (_format == ExportFormat::Csv) {
+            _writer.Append(CSV_HEADER);
+        }
+    }
+
+    void LogExporter::Write(const ReportServerLog& log) {
+        // Разобранное время выгрузке не нужно
+        Write(CompactLog{-1,
+                         log.time,
+                         log.actor_type,
+                         log.actor_id,
+                         log.action,
+                         log.status,
+                         log.source,
+                         log.detail});
+    }
+
+    void LogExporter::Write(const CompactLog& log) {
+        if (_format == ExportFormat::Csv) {
+            _writer.AppendCsvField(log.time_text);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.actor_id);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.actor_type);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.action);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.status);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.source);
+            _writer.Append(',');
+            _writer.AppendCsvField(log.detail);
+            _writer.Append('\n');
+        } else {
+            _writer.Append("{\"time\":");
+            _writer.AppendJsonString(log.time_text);
+            _writer.Append(",\"actor_id\":");
+            _writer.AppendJsonString(log.actor_id);
+            _writer.Append(",\"actor_type\":");
+            _writer.AppendJsonString(log.actor_type);
+            _writer.Append(",\"action\":");
+            _writer.AppendJsonString(log.action);
+            _writer.Append(",\"status\":");
+            _writer.AppendJsonString(log.status);
+            _writer.Append(",\"source\":");
+            _writer.AppendJsonString(log.source);
+            _writer.Append(",\"detail\":");
+            _writer.AppendJsonString(log.detail);
+            _writer.Append("}\n");
+        }
+
+        ++_rows;
+    }
+
+    bool ParseExportOptions(const rapidjson::Value& request, ExportOptions* options) {
+        if (!request.HasMember("export") || !request["export"].IsObject())
+            return false;
+
+        const rapidjson::Value& export_object = request["export"];
+
+        if (export_object.HasMember("format") && export_object["format"].IsString()) {
+            const std::string format = export_object["format"].GetString();
+            if (format == "csv") {
+                options->format = ExportFormat::Csv;
+            } else if (format == "ndjson") {
+                options->format = ExportFormat::Ndjson;
+            } else {
+                return false;
+            }
+        }
+
+        if (export_object.HasMember("chunk_size") && export_object["chunk_size"].IsNumber()) {
+            const double chunk_size = export_object["chunk_size"].GetDouble();
+            if (chunk_size < MIN_CHUNK_SIZE || chunk_size > MAX_CHUNK_SIZE)
+                return false;
+            options->chunk_size = static_cast<size_t>(chunk_size);
+        }
+
+        if (export_object.HasMember("fetch_step") && export_object["fetch_step"].IsNumber()) {
+            const double fetch_step = export_object["fetch_step"].GetDouble();
+            if (fetch_step < 60 || fetch_step > 24 * 60 * 60)
+                return false;
+            options->fetch_step = static_cast<time_t>(fetch_step);
+        }
+
+        return true;
+    }
+
+    std::string ExportDirectory() {
+        const char* directory = std::getenv("DAILY_LOGS_EXPORT_DIR");
+        return directory != nullptr ? directory : "";
+    }
+
+    ExportResult ExportDayLogs(ReportServerInterface*        server,
+                               time_t                        from,
+                               time_t                        to,
+                               const std::vector<LogFilter>& filters,
+                               const ExportOptions&          options) {
+        // Без настроенного каталога выгрузка выключена: логи дня не пишутся в общий /tmp
+        const std::string directory = ExportDirectory();
+        if (directory.empty())
+            throw std::runtime_error("ExportDayLogs: export is disabled, "
+                                     "DAILY_LOGS_EXPORT_DIR is not set");
+
+        ExportResult result;
+
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+            CreateExportFile(directory, from, options.format, &result.path), &std::fclose);
+
+        LogExporter exporter(file.get(), options);
+
+        try {
+            WriteLogs(server, from, to, filters, options, exporter);
+            exporter.Finish();
+        } catch (...) {
+            // Недописанный файл не оставляем
+            file.reset();
+            std::remove(result.path.c_str());
+            throw;
+        }
+
+        if (std::fclose(file.release()) != 0) {
+            std::remove(result.path.c_str());
+            throw std::runtime_error("ExportDayLogs: cannot close export file");
+        }
+
+        result.rows   = exporter.Rows();
+        result.bytes  = exporter.Bytes();
+        result.chunks = exporter.Chunks();
+        return result;
+    }
+} // namespace exporters
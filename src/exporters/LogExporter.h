@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdio>
+#include <ctime>
+#include <rapidjson/document.h>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "exporters/ChunkWriter.h"
+#include "structures/CompactLog.h"
+#include "structures/ExportOptions.h"
+#include "structures/LogFilter.h"
+
+namespace exporters {
+    // Построчная запись логов в CSV (с заголовком) или NDJSON
+    class LogExporter {
+    public:
+        LogExporter(std::FILE* file, const ExportOptions& options);
+
+        // Пишется исходный текст времени (time_text)
+        void Write(const CompactLog& log);
+
+        void Write(const ReportServerLog& log);
+
+        void Finish() { _writer.Flush(); }
+
+        [[nodiscard]] uint64_t Rows() const { return _rows; }
+        [[nodiscard]] uint64_t Bytes() const { return _writer.Bytes(); }
+        [[nodiscard]] uint64_t Chunks() const { return _writer.Chunks(); }
+
+    private:
+        ExportFormat _format;
+        ChunkWriter  _writer;
+        uint64_t     _rows = 0;
+    };
+
+    // Разбор request["export"]; отсутствующие поля остаются по умолчанию
+    bool ParseExportOptions(const rapidjson::Value& request, ExportOptions* options);
+
+    // Каталог выгрузок из DAILY_LOGS_EXPORT_DIR; пустой - выгрузка выключена
+    std::string ExportDirectory();
+
+    // Выгрузка логов [from, to] с фильтрами таблицы в новый файл каталога выгрузок (права
+    // 0600); без каталога - std::runtime_error.
+    // Загруженный день берется из DayCache, иначе логи запрашиваются окнами по fetch_step,
+    // так что память ограничена одним окном, а не всей выгрузкой
+    ExportResult ExportDayLogs(ReportServerInterface*        server,
+                               time_t                        from,
+                               time_t                        to,
+                               const std::vector<LogFilter>& filters,
+                               const ExportOptions&          options);
+} // namespace exporters
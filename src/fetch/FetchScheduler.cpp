@@ -0,0 +1,121 @@
+#include "FetchScheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+
+#include "pipeline/HostCall.h"
+#include "tracing/Tracer.h"
+
+namespace fetch {
+    namespace {
+        constexpr size_t MAX_CONCURRENCY = 64;
+        constexpr time_t MIN_SHARD       = 60;
+
+        // Положительное целое из переменной окружения, иначе default_value
+        long EnvironmentNumber(const char* name, long default_value) {
+            const char* value = std::getenv(name);
+            if (value == nullptr || *value == '\0')
+                return default_value;
+
+            char*      end    = nullptr;
+            const long number = std::strtol(value, &end, 10);
+            return *end == '\0' && number > 0 ? number : default_value;
+        }
+
+        // Начатая загрузка интервала: вызов в пуле пишет в logs
+        struct ShardCall {
+            ShardCall(pipeline::Executor& pool, pipeline::Executor& executor)
+                : call(pool, executor) {}
+
+            pipeline::HostCall           call;
+            std::vector<ReportServerLog> logs;
+        };
+    } // namespace
+
+    FetchOptions FetchOptionsFromEnvironment() {
+        FetchOptions options;
+        options.concurrency = std::min<size_t>(
+            EnvironmentNumber("DAILY_LOGS_FETCH_CONCURRENCY", 1), MAX_CONCURRENCY);
+        options.shard =
+            std::max<time_t>(EnvironmentNumber("DAILY_LOGS_FETCH_SHARD", options.shard), MIN_SHARD);
+        return options;
+    }
+
+    FetchScheduler::FetchScheduler(pipeline::ServerGate& server,
+                                   const FetchOptions&   options,
+                                   pipeline::Executor&   pool,
+                                   pipeline::Executor&   executor)
+        : _server(server), _options(options), _pool(pool), _executor(executor) {
+        _options.shard       = std::max(_options.shard, MIN_SHARD);
+        _options.concurrency = std::clamp<size_t>(_options.concurrency, 1, MAX_CONCURRENCY);
+    }
+
+    pipeline::Task<void> FetchScheduler::Fetch(time_t       from,
+                                               time_t       to,
+                                               std::string  type,
+                                               std::string  filter,
+                                               ShardHandler on_shard) const {
+        // Границы интервалов включительные, как у GetLogs
+        std::vector<std::pair<time_t, time_t>> shards;
+        for (time_t shard_from = from; shard_from <= to; shard_from += _options.shard) {
+            shards.emplace_back(shard_from, std::min(shard_from + _options.shard - 1, to));
+        }
+
+        std::deque<std::unique_ptr<ShardCall>> pending; // начатые, по порядку времени
+        size_t                                 next = 0;
+
+        // Отмена проверяется в ServerGate перед каждым GetLogs: после дедлайна новые
+        // интервалы сразу завершаются CancelledError
+        auto start_next = [&]() {
+            const auto [shard_from, shard_to] = shards[next++];
+
+            auto  shard = std::make_unique<ShardCall>(_pool, _executor);
+            auto* logs  = &shard->logs;
+            shard->call.Start([this, shard_from, shard_to, &type, &filter, logs] {
+                tracing::Span span("GetLogs", "fetch");
+                span.SetArg("from", shard_from);
+                _server.GetLogs(shard_from, shard_to, type, filter, logs);
+                span.SetArg("rows", static_cast<int64_t>(logs->size()));
+            });
+            pending.push_back(std::move(shard));
+        };
+
+        std::exception_ptr error;
+        try {
+            while (next < shards.size() && pending.size() < _options.concurrency) {
+                start_next();
+            }
+
+            while (!pending.empty()) {
+                co_await pending.front()->call;
+
+                std::vector<ReportServerLog> logs = std::move(pending.front()->logs);
+                pending.pop_front();
+
+                // Следующий интервал грузится, пока обрабатывается этот
+                if (next < shards.size()) {
+                    start_next();
+                }
+                on_shard(std::move(logs));
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // Вызовы ссылаются на кадр корутины: выход ждет каждый начатый
+        while (!pending.empty()) {
+            try {
+                co_await pending.front()->call;
+            } catch (...) {
+            }
+            pending.pop_front();
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+} // namespace fetch
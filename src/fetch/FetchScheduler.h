@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "pipeline/Executor.h"
+#include "pipeline/ServerGate.h"
+#include "pipeline/Task.h"
+#include "structures/FetchOptions.h"
+
+namespace fetch {
+    // Настройки из окружения хоста: DAILY_LOGS_FETCH_CONCURRENCY (по умолчанию 1 - хост
+    // не обязан допускать параллельные GetLogs) и DAILY_LOGS_FETCH_SHARD (секунды)
+    FetchOptions FetchOptionsFromEnvironment();
+
+    // Загрузка окна [from, to] интервалами по options.shard. GetLogs выполняются в pool,
+    // одновременно - не больше options.concurrency интервалов; готовые интервалы передаются
+    // в on_shard строго по порядку времени в потоке executor, пока следующие загружаются.
+    // Потоки executor не ждут хост: корутина приостанавливается до ответа
+    class FetchScheduler {
+    public:
+        using ShardHandler = std::function<void(std::vector<ReportServerLog>&& logs)>;
+
+        FetchScheduler(pipeline::ServerGate& server,
+                       const FetchOptions&   options,
+                       pipeline::Executor&   pool,
+                       pipeline::Executor&   executor);
+
+        // Исключение GetLogs любого интервала пробрасывается, когда завершены все начатые.
+        // Аргументы копируются в кадр корутины
+        pipeline::Task<void> Fetch(time_t       from,
+                                   time_t       to,
+                                   std::string  type,
+                                   std::string  filter,
+                                   ShardHandler on_shard) const;
+
+    private:
+        pipeline::ServerGate& _server;
+        FetchOptions          _options;
+        pipeline::Executor&   _pool;
+        pipeline::Executor&   _executor;
+    };
+} // namespace fetch
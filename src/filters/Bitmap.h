@@ -0,0 +1,91 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace filters {
+    // Битовая маска строк выборки: 64 строки на слово
+    class Bitmap {
+    public:
+        Bitmap() = default;
+
+        explicit Bitmap(size_t size, bool value = false)
+            : _size(size), _words((size + 63) / 64, value ? ~uint64_t{0} : 0) {
+            TrimTail();
+        }
+
+        [[nodiscard]] size_t Size() const { return _size; }
+
+        [[nodiscard]] bool Test(size_t index) const {
+            return (_words[index >> 6] >> (index & 63)) & 1;
+        }
+
+        void Set(size_t index) { _words[index >> 6] |= uint64_t{1} << (index & 63); }
+
+        void Reset(size_t index) { _words[index >> 6] &= ~(uint64_t{1} << (index & 63)); }
+
+        std::vector<uint64_t>&       Words() { return _words; }
+        const std::vector<uint64_t>& Words() const { return _words; }
+
+        Bitmap& operator&=(const Bitmap& other) {
+            for (size_t i = 0; i < _words.size() && i < other._words.size(); ++i) {
+                _words[i] &= other._words[i];
+            }
+            return *this;
+        }
+
+        Bitmap& operator|=(const Bitmap& other) {
+            for (size_t i = 0; i < _words.size() && i < other._words.size(); ++i) {
+                _words[i] |= other._words[i];
+            }
+            return *this;
+        }
+
+        void Flip() {
+            for (auto& word : _words) {
+                word = ~word;
+            }
+            TrimTail();
+        }
+
+        [[nodiscard]] size_t Count() const {
+            size_t count = 0;
+            for (const auto word : _words) {
+                count += std::popcount(word);
+            }
+            return count;
+        }
+
+        [[nodiscard]] bool None() const {
+            for (const auto word : _words) {
+                if (word != 0)
+                    return false;
+            }
+            return true;
+        }
+
+        // Обход установленных битов по возрастанию
+        template <typename Callback>
+        void ForEach(Callback&& callback) const {
+            for (size_t w = 0; w < _words.size(); ++w) {
+                uint64_t word = _words[w];
+                while (word != 0) {
+                    callback(w * 64 + std::countr_zero(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+    private:
+        size_t                _size = 0;
+        std::vector<uint64_t> _words;
+
+        void TrimTail() {
+            if (_size % 64 != 0 && !_words.empty()) {
+                _words.back() &= (uint64_t{1} << (_size % 64)) - 1;
+            }
+        }
+    };
+} // namespace filters
@@ -0,0 +1,286 @@
+#include "FilterProgram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "filters/LogFilters.h"
+#include "filters/SubstringSearch.h"
+
+namespace filters {
+    namespace {
+        bool IsRangeSearch(SearchType search_type) {
+            switch (search_type) {
+                case SearchType::Between:
+                case SearchType::Outside:
+                case SearchType::Below:
+                case SearchType::BelowOrEqual:
+                case SearchType::Above:
+                case SearchType::AboveOrEqual:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool IsDictionaryColumn(LogColumn column) {
+            return column != LogColumn::Time && column != LogColumn::Detail;
+        }
+    } // namespace
+
+    FilterProgram FilterProgram::Compile(const std::vector<LogFilter>& filters) {
+        FilterProgram program;
+
+        for (const auto& filter : filters) {
+            Instruction instruction;
+
+            if (filter.values.empty() || !ParseLogColumn(filter.column, &instruction.column))
+                continue;
+
+            instruction.search_type = filter.search_type;
+            instruction.values      = filter.values;
+
+            const bool is_time = instruction.column == LogColumn::Time;
+
+            for (const auto& value : filter.values) {
+                double number = 0.0;
+                if (!(is_time ? ParseTimeValue(value, &number) : ParseNumber(value, &number)))
+                    break;
+                instruction.numbers.push_back(number);
+            }
+            if (instruction.numbers.size() != filter.values.size())
+                instruction.numbers.clear();
+
+            const bool has_bounds =
+                !instruction.numbers.empty() &&
+                (filter.search_type == SearchType::Between ||
+                 filter.search_type == SearchType::Outside
+                     ? instruction.numbers.size() >= 2
+                     : true);
+
+            if (is_time && IsRangeSearch(filter.search_type) && has_bounds) {
+                instruction.kernel = Kernel::TimeRange;
+                instruction.low    = std::numeric_limits<int64_t>::min();
+                instruction.high   = std::numeric_limits<int64_t>::max();
+
+                const double first = instruction.numbers[0];
+
+                switch (filter.search_type) {
+                    case SearchType::Between:
+                    case SearchType::Outside:
+                        instruction.low  = static_cast<int64_t>(std::ceil(first));
+                        instruction.high =
+                            static_cast<int64_t>(std::floor(instruction.numbers[1]));
+                        instruction.negated = filter.search_type == SearchType::Outside;
+                        break;
+                    case SearchType::Below:
+                        instruction.high = static_cast<int64_t>(std::ceil(first)) - 1;
+                        break;
+                    case SearchType::BelowOrEqual:
+                        instruction.high = static_cast<int64_t>(std::floor(first));
+                        break;
+                    case SearchType::Above:
+                        instruction.low = static_cast<int64_t>(std::floor(first)) + 1;
+                        break;
+                    case SearchType::AboveOrEqual:
+                        instruction.low = static_cast<int64_t>(std::ceil(first));
+                        break;
+                    default:
+                        break;
+                }
+            } else if (IsDictionaryColumn(instruction.column)) {
+                instruction.kernel = Kernel::Dictionary;
+            } else {
+                instruction.kernel = Kernel::Raw;
+            }
+
+            program._instructions.push_back(std::move(instruction));
+        }
+
+        // Дешевые инструкции первыми: они сужают набор строк для построчных проверок
+        std::stable_sort(program._instructions.begin(),
+                         program._instructions.end(),
+                         [](const Instruction& a, const Instruction& b) {
+                             return static_cast<int>(a.kernel) < static_cast<int>(b.kernel);
+                         });
+
+        return program;
+    }
+
+    Bitmap FilterProgram::Evaluate(const LogColumns& columns, const TokenIndex* index) const {
+        Bitmap selected(columns.Size(), true);
+
+        for (const auto& instruction : _instructions) {
+            if (selected.None())
+                break;
+
+            bool use_raw = false;
+
+            if (index != nullptr && instruction.kernel != Kernel::TimeRange) {
+                const std::optional<Bitmap> candidates = index->Candidates(
+                    instruction.column, instruction.search_type, instruction.values);
+
+                if (candidates) {
+                    selected &= *candidates;
+                    // Мало кандидатов - дешевле проверить их напрямую, чем строить словарь
+                    use_raw = selected.Count() * 32 < columns.Size();
+                }
+            }
+
+            switch (instruction.kernel) {
+                case Kernel::TimeRange:
+                    EvaluateTimeRange(instruction, columns, selected);
+                    break;
+                case Kernel::Dictionary:
+                    if (use_raw) {
+                        EvaluateRaw(instruction, columns, selected);
+                    } else {
+                        EvaluateDictionary(instruction, columns, selected);
+                    }
+                    break;
+                case Kernel::Raw:
+                    EvaluateRaw(instruction, columns, selected);
+                    break;
+            }
+        }
+
+        return selected;
+    }
+
+    bool FilterProgram::Matches(std::string_view field, const Instruction& instruction) {
+        const auto& values = instruction.values;
+
+        // Сравнение: численное, если и поле, и значение фильтра - числа
+        auto compare = [&](size_t index) {
+            double     number  = 0.0;
+            const bool numeric = !instruction.numbers.empty() &&
+                                 (instruction.column == LogColumn::Time
+                                      ? ParseTimeValue(field, &number)
+                                      : ParseNumber(field, &number));
+
+            if (numeric) {
+                const double value = instruction.numbers[index];
+                return number < value ? -1 : (number > value ? 1 : 0);
+            }
+
+            const int cmp = field.compare(values[index]);
+            return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+        };
+
+        switch (instruction.search_type) {
+            case SearchType::Like:
+                return ContainsSubstring(field, values.front());
+            case SearchType::Equal:
+                return field == values.front();
+            case SearchType::NotEqual:
+                return field != values.front();
+            case SearchType::Select:
+                return std::find(values.begin(), values.end(), field) != values.end();
+            case SearchType::SelectExcept:
+                return std::find(values.begin(), values.end(), field) == values.end();
+            case SearchType::Below:
+                return compare(0) < 0;
+            case SearchType::BelowOrEqual:
+                return compare(0) <= 0;
+            case SearchType::Above:
+                return compare(0) > 0;
+            case SearchType::AboveOrEqual:
+                return compare(0) >= 0;
+            case SearchType::Between:
+            case SearchType::Outside: {
+                if (values.size() < 2)
+                    return true;
+                const bool inside = compare(0) >= 0 && compare(1) <= 0;
+                return instruction.search_type == SearchType::Between ? inside : !inside;
+            }
+        }
+        return true;
+    }
+
+    void FilterProgram::EvaluateTimeRange(const Instruction& instruction,
+                                          const LogColumns&  columns,
+                                          Bitmap&            selected) {
+        const std::vector<int64_t>& time  = columns.Time();
+        std::vector<uint64_t>&      words = selected.Words();
+
+        const int64_t  low     = instruction.low;
+        const int64_t  high    = instruction.high;
+        const uint64_t negated = instruction.negated ? ~uint64_t{0} : 0;
+
+        for (size_t w = 0; w < words.size(); ++w) {
+            if (words[w] == 0)
+                continue;
+
+            const size_t begin = w * 64;
+            const size_t end   = std::min(begin + 64, time.size());
+
+            uint64_t word = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const int64_t t = time[i];
+                word |= static_cast<uint64_t>(t >= 0 && t >= low && t <= high) << (i - begin);
+            }
+
+            // Нераспознанное время не попадает ни в диапазон, ни вне его
+            if (negated != 0) {
+                uint64_t valid = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    valid |= static_cast<uint64_t>(time[i] >= 0) << (i - begin);
+                }
+                word = ~word & valid;
+            }
+
+            words[w] &= word;
+        }
+    }
+
+    void FilterProgram::EvaluateDictionary(const Instruction& instruction,
+                                           const LogColumns&  columns,
+                                           Bitmap&            selected) {
+        const DictionaryColumn& column = columns.Dictionary(instruction.column);
+
+        // Предикат вычисляется один раз на уникальное значение
+        std::vector<uint8_t> accepted(column.dictionary.size());
+        for (size_t i = 0; i < column.dictionary.size(); ++i) {
+            accepted[i] = Matches(column.dictionary[i], instruction) ? 1 : 0;
+        }
+
+        const uint32_t*        codes = column.codes.data();
+        const uint8_t*         table = accepted.data();
+        std::vector<uint64_t>& words = selected.Words();
+        const size_t           rows  = column.codes.size();
+
+        for (size_t w = 0; w < words.size(); ++w) {
+            if (words[w] == 0)
+                continue;
+
+            const size_t begin = w * 64;
+            const size_t end   = std::min(begin + 64, rows);
+
+            uint64_t word = 0;
+            for (size_t i = begin; i < end; ++i) {
+                word |= static_cast<uint64_t>(table[codes[i]]) << (i - begin);
+            }
+            words[w] &= word;
+        }
+    }
+
+    void FilterProgram::EvaluateRaw(const Instruction& instruction,
+                                    const LogColumns&  columns,
+                                    Bitmap&            selected) {
+        std::vector<uint64_t>& words = selected.Words();
+
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t candidates = words[w];
+            uint64_t word       = 0;
+
+            while (candidates != 0) {
+                const unsigned bit = std::countr_zero(candidates);
+                if (Matches(columns.Value(w * 64 + bit, instruction.column), instruction)) {
+                    word |= uint64_t{1} << bit;
+                }
+                candidates &= candidates - 1;
+            }
+            words[w] = word;
+        }
+    }
+} // namespace filters
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filters/Bitmap.h"
+#include "filters/LogColumns.h"
+#include "filters/TokenIndex.h"
+#include "structures/LogFilter.h"
+
+namespace filters {
+    // Набор фильтров таблицы, скомпилированный один раз на запрос в программу над колонками.
+    // Каждая инструкция дает битовую маску, результаты пересекаются; дорогие инструкции
+    // выполняются последними и только по строкам, оставшимся после дешевых
+    class FilterProgram {
+    public:
+        static FilterProgram Compile(const std::vector<LogFilter>& filters);
+
+        [[nodiscard]] bool Empty() const { return _instructions.empty(); }
+
+        // index - необязательный индекс токенов того же среза: сужает строки-кандидаты
+        [[nodiscard]] Bitmap Evaluate(const LogColumns& columns,
+                                      const TokenIndex* index = nullptr) const;
+
+    private:
+        enum class Kernel {
+            TimeRange,  // диапазон по разобранному времени
+            Dictionary, // предикат по словарю, затем проход по кодам
+            Raw         // построчная проверка, только по строкам-кандидатам
+        };
+
+        struct Instruction {
+            Kernel                   kernel;
+            LogColumn                column;
+            SearchType               search_type;
+            std::vector<std::string> values;
+            std::vector<double>      numbers; // значения в виде чисел, если все разобрались
+            int64_t                  low     = 0;
+            int64_t                  high    = 0;
+            bool                     negated = false;
+        };
+
+        std::vector<Instruction> _instructions;
+
+        static bool Matches(std::string_view field, const Instruction& instruction);
+
+        static void EvaluateTimeRange(const Instruction& instruction,
+                                      const LogColumns&  columns,
+                                      Bitmap&            selected);
+
+        static void EvaluateDictionary(const Instruction& instruction,
+                                       const LogColumns&  columns,
+                                       Bitmap&            selected);
+
+        static void EvaluateRaw(const Instruction& instruction,
+                                const LogColumns&  columns,
+                                Bitmap&            selected);
+    };
+} // namespace filters
@@ -0,0 +1,94 @@
+#include "LogColumns.h"
+
+#include <unordered_map>
+
+namespace filters {
+    bool ParseLogColumn(const std::string& name, LogColumn* column) {
+        static const std::pair<const char*, LogColumn> columns[] = {
+            {"time", LogColumn::Time},
+            {"actor_id", LogColumn::ActorId},
+            {"actor_type", LogColumn::ActorType},
+            {"action", LogColumn::Action},
+            {"status", LogColumn::Status},
+            {"source", LogColumn::Source},
+            {"detail", LogColumn::Detail}};
+
+        for (const auto& [column_name, value] : columns) {
+            if (name == column_name) {
+                *column = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LogColumns::LogColumns(CompactLogSpan logs) : _logs(logs) {}
+
+    std::string_view LogColumns::Value(size_t row, LogColumn column) const {
+        const CompactLog& log = _logs[row];
+
+        switch (column) {
+            case LogColumn::Time:
+                return log.time_text;
+            case LogColumn::ActorId:
+                return log.actor_id;
+            case LogColumn::ActorType:
+                return log.actor_type;
+            case LogColumn::Action:
+                return log.action;
+            case LogColumn::Status:
+                return log.status;
+            case LogColumn::Source:
+                return log.source;
+            case LogColumn::Detail:
+                return log.detail;
+        }
+        return {};
+    }
+
+    const std::vector<int64_t>& LogColumns::Time() const {
+        std::call_once(_time_once, [this] {
+            _time.resize(_logs.size());
+            for (size_t i = 0; i < _logs.size(); ++i) {
+                _time[i] = _logs[i].time;
+            }
+        });
+        return _time;
+    }
+
+    const DictionaryColumn& LogColumns::Dictionary(LogColumn column) const {
+        const auto index = static_cast<size_t>(column);
+
+        std::call_once(_dictionary_once[index], [this, column, index] {
+            DictionaryColumn&                           result = _dictionaries[index];
+            std::unordered_map<std::string_view, uint32_t> codes;
+
+            result.codes.resize(_logs.size());
+
+            // Соседние строки логов часто совпадают - проверка предыдущего значения
+            // экономит поиск в хеш-таблице
+            std::string_view previous;
+            uint32_t         previous_code = 0;
+
+            for (size_t i = 0; i < _logs.size(); ++i) {
+                const std::string_view value = Value(i, column);
+
+                if (i > 0 && value == previous) {
+                    result.codes[i] = previous_code;
+                    continue;
+                }
+
+                const auto [it, inserted] =
+                    codes.try_emplace(value, static_cast<uint32_t>(result.dictionary.size()));
+                if (inserted) {
+                    result.dictionary.push_back(value);
+                }
+
+                previous        = value;
+                previous_code   = it->second;
+                result.codes[i] = it->second;
+            }
+        });
+        return _dictionaries[index];
+    }
+} // namespace filters
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "structures/CompactLog.h"
+
+namespace filters {
+    enum class LogColumn { Time, ActorId, ActorType, Action, Status, Source, Detail };
+
+    inline constexpr size_t LOG_COLUMNS_COUNT = 7;
+
+    bool ParseLogColumn(const std::string& name, LogColumn* column);
+
+    // Колонка со словарем: уникальные значения и код значения для каждой строки
+    struct DictionaryColumn {
+        std::vector<std::string_view> dictionary;
+        std::vector<uint32_t>         codes;
+    };
+
+    // Колоночное представление логов дня. Колонки строятся лениво при первом обращении;
+    // все string_view ссылаются на строки записей logs, которые должны пережить объект
+    class LogColumns {
+    public:
+        explicit LogColumns(CompactLogSpan logs);
+
+        LogColumns(const LogColumns&)            = delete;
+        LogColumns& operator=(const LogColumns&) = delete;
+
+        [[nodiscard]] size_t Size() const { return _logs.size(); }
+
+        [[nodiscard]] std::string_view Value(size_t row, LogColumn column) const;
+
+        // UNIX-время строк (CompactLog::time), -1 для нераспознанного значения
+        const std::vector<int64_t>& Time() const;
+
+        const DictionaryColumn& Dictionary(LogColumn column) const;
+
+    private:
+        CompactLogSpan _logs;
+
+        mutable std::once_flag       _time_once;
+        mutable std::vector<int64_t> _time;
+
+        mutable std::array<std::once_flag, LOG_COLUMNS_COUNT>   _dictionary_once;
+        mutable std::array<DictionaryColumn, LOG_COLUMNS_COUNT> _dictionaries;
+    };
+} // namespace filters
@@ -0,0 +1,246 @@
+#include "LogFilters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "filters/FilterProgram.h"
+#include "records/CompactLogStore.h"
+#include "utils/Utils.h"
+
+namespace filters {
+    namespace {
+        // Предел значения фильтра по времени: целые double точны, а приведение к time_t и
+        // сдвиг границы на секунду не переполняются
+        constexpr double MAX_TIME_VALUE = static_cast<double>(int64_t{1} << 53);
+
+        std::string ValueToString(const rapidjson::Value& value) {
+            if (value.IsString())
+                return value.GetString();
+            if (value.IsInt64())
+                return std::to_string(value.GetInt64());
+            if (value.IsNumber())
+                return std::to_string(value.GetDouble());
+            if (value.IsBool())
+                return value.GetBool() ? "true" : "false";
+            return "";
+        }
+    } // namespace
+
+    bool ParseNumber(std::string_view str, double* number) {
+        if (str.empty() || str.size() > 63)
+            return false;
+
+        char buffer[64];
+        std::memcpy(buffer, str.data(), str.size());
+        buffer[str.size()] = '\0';
+
+        char*        end   = nullptr;
+        const double value = std::strtod(buffer, &end);
+        if (end != buffer + str.size() || !std::isfinite(value))
+            return false;
+        *number = value;
+        return true;
+    }
+
+    bool ParseTimeValue(std::string_view str, double* timestamp) {
+        double number = 0.0;
+        if (ParseNumber(str, &number)) {
+            if (std::fabs(number) > MAX_TIME_VALUE)
+                return false;
+            *timestamp = number;
+            return true;
+        }
+        const int64_t parsed = utils::ParseLogTimestamp(str);
+        if (parsed < 0)
+            return false;
+        *timestamp = static_cast<double>(parsed);
+        return true;
+    }
+
+    bool IsFilterableColumn(const std::string& column) {
+        return column == "time" || column == "actor_id" || column == "actor_type" ||
+               column == "action" || column == "status" || column == "source" ||
+               column == "detail";
+    }
+
+    bool ParseSearchType(const std::string& name, SearchType* search_type) {
+        static const std::pair<const char*, SearchType> search_types[] = {
+            {"like", SearchType::Like},
+            {"equal", SearchType::Equal},
+            {"not_equal", SearchType::NotEqual},
+            {"between", SearchType::Between},
+            {"outside", SearchType::Outside},
+            {"below", SearchType::Below},
+            {"below_or_equal", SearchType::BelowOrEqual},
+            {"above", SearchType::Above},
+            {"above_or_equal", SearchType::AboveOrEqual},
+            {"select", SearchType::Select},
+            {"select_except", SearchType::SelectExcept}};
+
+        for (const auto& [type_name, type] : search_types) {
+            if (name == type_name) {
+                *search_type = type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<LogFilter> ParseLogFilters(const rapidjson::Value& request) {
+        std::vector<LogFilter> result;
+
+        if (!request.HasMember("filters") || !request["filters"].IsObject()) {
+            return result;
+        }
+
+        for (const auto& member : request["filters"].GetObject()) {
+            LogFilter filter;
+            filter.column = member.name.GetString();
+
+            if (!IsFilterableColumn(filter.column) || !member.value.IsObject()) {
+                continue;
+            }
+
+            const rapidjson::Value& config = member.value;
+
+            // По умолчанию - частичное совпадение, как у Search-фильтра на UI
+            if (config.HasMember("search_type") &&
+                (!config["search_type"].IsString() ||
+                 !ParseSearchType(config["search_type"].GetString(), &filter.search_type))) {
+                throw std::invalid_argument("filters." + filter.column +
+                                            ": invalid 'search_type'");
+            }
+
+            if (!config.HasMember("value")) {
+                continue;
+            }
+
+            const rapidjson::Value& value = config["value"];
+            if (value.IsArray()) {
+                for (const auto& item : value.GetArray()) {
+                    filter.values.push_back(ValueToString(item));
+                }
+            } else {
+                filter.values.push_back(ValueToString(value));
+            }
+
+            // Пустой Like совпадает со всем - такой фильтр не нужен
+            if (filter.values.empty() ||
+                (filter.search_type == SearchType::Like && filter.values.front().empty())) {
+                continue;
+            }
+
+            result.push_back(std::move(filter));
+        }
+
+        return result;
+    }
+
+    bool HostFilterFromEnvironment() {
+        const char* value = std::getenv("DAILY_LOGS_HOST_FILTER");
+        return value != nullptr && std::strcmp(value, "1") == 0;
+    }
+
+    LogQuery PlanLogQuery(time_t                        from,
+                          time_t                        to,
+                          const std::vector<LogFilter>& filters,
+                          bool                          is_host_filter) {
+        LogQuery query;
+        query.from = from;
+        query.to   = to;
+
+        const LogFilter* like_candidate = nullptr;
+
+        for (const auto& filter : filters) {
+            // actor_type = X - ровно то, что хост умеет фильтровать аргументом type
+            const bool single_value =
+                filter.search_type == SearchType::Equal ||
+                (filter.search_type == SearchType::Select && filter.values.size() == 1);
+
+            if (filter.column == "actor_type" && single_value && query.type.empty()) {
+                query.type = filter.values.front();
+                continue;
+            }
+
+            // Ограничения по времени сужают окно выборки; сам предикат остается в плагине,
+            // так как включительность границ GetLogs не гарантирована
+            if (filter.column == "time") {
+                double bound = 0.0;
+
+                switch (filter.search_type) {
+                    case SearchType::Between:
+                        if (filter.values.size() >= 2 && ParseTimeValue(filter.values[0], &bound))
+                            query.from = std::max(query.from, static_cast<time_t>(bound));
+                        if (filter.values.size() >= 2 && ParseTimeValue(filter.values[1], &bound))
+                            query.to = std::min(query.to, static_cast<time_t>(bound));
+                        break;
+                    case SearchType::Above:
+                    case SearchType::AboveOrEqual:
+                        if (ParseTimeValue(filter.values.front(), &bound))
+                            query.from = std::max(query.from, static_cast<time_t>(bound));
+                        break;
+                    case SearchType::Below:
+                    case SearchType::BelowOrEqual:
+                        if (ParseTimeValue(filter.values.front(), &bound))
+                            query.to = std::min(query.to, static_cast<time_t>(bound));
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            // Самый длинный Like - самый селективный кандидат для filter хоста
+            if (is_host_filter && filter.search_type == SearchType::Like &&
+                filter.column != "time" &&
+                (like_candidate == nullptr ||
+                 filter.values.front().size() > like_candidate->values.front().size())) {
+                like_candidate = &filter;
+            }
+
+            query.residual.push_back(filter);
+        }
+
+        // Расчет на то, что хост ищет filter как подстроку по всей записи: тогда его выборка -
+        // надмножество результата, а точная проверка колонки остается в residual
+        if (like_candidate != nullptr) {
+            query.filter = like_candidate->values.front();
+        }
+
+        return query;
+    }
+
+    Bitmap SelectLogs(const LogColumns&             columns,
+                      const TokenIndex*             index,
+                      const std::vector<LogFilter>& filters) {
+        return FilterProgram::Compile(filters).Evaluate(columns, index);
+    }
+
+    void ApplyLogFilters(std::vector<ReportServerLog>&  logs,
+                         const std::vector<LogFilter>& filters) {
+        const FilterProgram program = FilterProgram::Compile(filters);
+        if (program.Empty())
+            return;
+
+        Bitmap selected;
+        {
+            records::CompactLogStore views;
+            views.AppendView(logs);
+
+            const LogColumns columns(views.Logs());
+            selected = program.Evaluate(columns);
+        }
+
+        // Уплотнение вектора на месте, без копирования оставшихся строк
+        size_t kept = 0;
+        selected.ForEach([&](size_t row) {
+            if (row != kept) {
+                logs[kept] = std::move(logs[row]);
+            }
+            ++kept;
+        });
+        logs.resize(kept);
+    }
+} // namespace filters
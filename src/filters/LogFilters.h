@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ctime>
+#include <rapidjson/document.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "filters/Bitmap.h"
+#include "filters/LogColumns.h"
+#include "filters/TokenIndex.h"
+#include "structures/LogFilter.h"
+
+namespace filters {
+    // Колонки таблицы логов, по которым допускается фильтрация
+    bool IsFilterableColumn(const std::string& column);
+
+    bool ParseSearchType(const std::string& name, SearchType* search_type);
+
+    // Конечное число; nan и inf не принимаются
+    bool ParseNumber(std::string_view str, double* number);
+
+    // Значение фильтра по времени: UNIX-время (не больше 2^53 по модулю) либо строка даты лога
+    bool ParseTimeValue(std::string_view str, double* timestamp);
+
+    // Разбор request["filters"]: { "<column>": { "search_type": "...", "value": ... } }.
+    // std::invalid_argument - search_type не строка или неизвестен
+    std::vector<LogFilter> ParseLogFilters(const rapidjson::Value& request);
+
+    // DAILY_LOGS_HOST_FILTER=1 - передавать хосту аргументом filter самый длинный Like.
+    // По умолчанию выключено: что хост ищет по filter (подстроку в какой части записи), не
+    // подтверждено, а узкая выборка хоста молча теряет строки
+    bool HostFilterFromEnvironment();
+
+    // Перенос фильтров в аргументы GetLogs: type и окно времени, с is_host_filter - еще filter
+    LogQuery PlanLogQuery(time_t                        from,
+                          time_t                        to,
+                          const std::vector<LogFilter>& filters,
+                          bool                          is_host_filter);
+
+    // Строки колонок, прошедшие все фильтры; index - необязательный индекс токенов среза
+    Bitmap SelectLogs(const LogColumns&             columns,
+                      const TokenIndex*             index,
+                      const std::vector<LogFilter>& filters);
+
+    // Оставляет в logs только строки, прошедшие все фильтры
+    void ApplyLogFilters(std::vector<ReportServerLog>&  logs,
+                         const std::vector<LogFilter>& filters);
+} // namespace filters
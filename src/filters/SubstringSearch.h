@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace filters {
+    // Поиск подстроки: SSE2-сравнение первого и последнего символа образца по 16 позиций
+    // за шаг, полное сравнение только для кандидатов
+    inline bool ContainsSubstring(std::string_view haystack, std::string_view needle) {
+        const size_t n = haystack.size();
+        const size_t k = needle.size();
+
+        if (k == 0)
+            return true;
+        if (k > n)
+            return false;
+        if (k == 1)
+            return std::memchr(haystack.data(), needle[0], n) != nullptr;
+
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        const char*   h     = haystack.data();
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last  = _mm_set1_epi8(needle[k - 1]);
+
+        for (; i + k - 1 + 16 <= n; i += 16) {
+            const __m128i block_first =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            const __m128i block_last =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + k - 1));
+
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                              _mm_cmpeq_epi8(last, block_last))));
+
+            while (mask != 0) {
+                const unsigned bit = __builtin_ctz(mask);
+                if (std::memcmp(h + i + bit + 1, needle.data() + 1, k - 2) == 0)
+                    return true;
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        return haystack.substr(i).find(needle) != std::string_view::npos;
+    }
+} // namespace filters
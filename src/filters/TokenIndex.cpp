@@ -0,0 +1,350 @@
+#include "TokenIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "filters/SubstringSearch.h"
+
+namespace filters {
+    namespace {
+        struct TokenCharTable {
+            bool chars[256] = {};
+
+            constexpr TokenCharTable() {
+                for (int c = '0'; c <= '9'; ++c)
+                    chars[c] = true;
+                for (int c = 'a'; c <= 'z'; ++c)
+                    chars[c] = true;
+                for (int c = 'A'; c <= 'Z'; ++c)
+                    chars[c] = true;
+                for (const char c : {'_', '.', ':', '-', '@'})
+                    chars[static_cast<unsigned char>(c)] = true;
+            }
+        };
+
+        constexpr TokenCharTable TOKEN_CHARS;
+
+        bool IsTokenChar(char c) { return TOKEN_CHARS.chars[static_cast<unsigned char>(c)]; }
+
+        // Вызывает callback(token, begin_offset) для каждого токена строки
+        template <typename Callback>
+        void ForEachToken(std::string_view str, Callback&& callback) {
+            size_t i = 0;
+            while (i < str.size()) {
+                while (i < str.size() && !IsTokenChar(str[i])) {
+                    ++i;
+                }
+                const size_t begin = i;
+                while (i < str.size() && IsTokenChar(str[i])) {
+                    ++i;
+                }
+                if (i > begin) {
+                    callback(str.substr(begin, i - begin), begin);
+                }
+            }
+        }
+    } // namespace
+
+    void PostingList::Append(uint32_t row) {
+        // Повтор токена в той же строке
+        if (_count > 0 && row == _last)
+            return;
+
+        uint8_t  buffer[5];
+        size_t   size  = 0;
+        uint32_t delta = _count == 0 ? row : row - _last;
+        while (delta >= 0x80) {
+            buffer[size++] = static_cast<uint8_t>(delta | 0x80);
+            delta >>= 7;
+        }
+        buffer[size++] = static_cast<uint8_t>(delta);
+        _bytes.insert(_bytes.end(), buffer, buffer + size);
+
+        _last = row;
+        ++_count;
+    }
+
+    void PostingList::AddTo(Bitmap& bitmap) const {
+        uint32_t row   = 0;
+        uint32_t delta = 0;
+        int      shift = 0;
+
+        for (const uint8_t byte : _bytes) {
+            delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (byte & 0x80) {
+                shift += 7;
+                continue;
+            }
+            row += delta;
+            bitmap.Set(row);
+            delta = 0;
+            shift = 0;
+        }
+    }
+
+    uint32_t TermTable::Insert(std::string_view term, uint32_t next_id, bool* inserted) {
+        if ((_size + 1) * 2 > _slots.size()) {
+            Grow();
+        }
+
+        const uint64_t hash = Hash(term);
+        const size_t   mask = _slots.size() - 1;
+
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = _slots[i];
+
+            if (slot.id == EMPTY) {
+                slot.term = Intern(term);
+                slot.hash = hash;
+                slot.id   = next_id;
+                ++_size;
+                *inserted = true;
+                return next_id;
+            }
+
+            if (slot.hash == hash && slot.term == term) {
+                *inserted = false;
+                return slot.id;
+            }
+        }
+    }
+
+    std::optional<uint32_t> TermTable::Find(std::string_view term) const {
+        if (_slots.empty())
+            return std::nullopt;
+
+        const uint64_t hash = Hash(term);
+        const size_t   mask = _slots.size() - 1;
+
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = _slots[i];
+            if (slot.id == EMPTY)
+                return std::nullopt;
+            if (slot.hash == hash && slot.term == term)
+                return slot.id;
+        }
+    }
+
+    std::string_view TermTable::Intern(std::string_view term) {
+        // Длинные термы (редкость) получают отдельный блок, текущий блок остается последним
+        if (term.size() > BLOCK_SIZE / 4) {
+            auto block = std::make_unique<char[]>(term.size());
+            std::memcpy(block.get(), term.data(), term.size());
+            const std::string_view interned(block.get(), term.size());
+            _blocks.insert(_blocks.empty() ? _blocks.end() : _blocks.end() - 1, std::move(block));
+            return interned;
+        }
+
+        if (_block_used + term.size() > BLOCK_SIZE) {
+            _blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            _block_used = 0;
+        }
+
+        char* data = _blocks.back().get() + _block_used;
+        std::memcpy(data, term.data(), term.size());
+        _block_used += term.size();
+        return {data, term.size()};
+    }
+
+    uint64_t TermTable::Hash(std::string_view term) {
+        const char* data = term.data();
+        size_t      size = term.size();
+        uint64_t    hash = 0x9E3779B97F4A7C15ULL ^ size;
+
+        while (size >= 8) {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+            hash ^= hash >> 31;
+            data += 8;
+            size -= 8;
+        }
+
+        uint64_t tail = 0;
+        std::memcpy(&tail, data, size);
+
+        // Финализатор splitmix64: младшие биты, по которым берется слот, зависят от всех байтов
+        hash ^= tail;
+        hash ^= hash >> 30;
+        hash *= 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+        return hash;
+    }
+
+    void TermTable::Grow() {
+        std::vector<Slot> old_slots(_slots.empty() ? 1024 : _slots.size() * 2);
+        old_slots.swap(_slots);
+
+        const size_t mask = _slots.size() - 1;
+        for (const auto& slot : old_slots) {
+            if (slot.id == EMPTY)
+                continue;
+            size_t i = slot.hash & mask;
+            while (_slots[i].id != EMPTY) {
+                i = (i + 1) & mask;
+            }
+            _slots[i] = slot;
+        }
+    }
+
+    TokenIndex::TokenIndex(const LogColumns& columns) : _rows(columns.Size()) {
+        for (const LogColumn column :
+             {LogColumn::Detail, LogColumn::ActorId, LogColumn::Action, LogColumn::Source}) {
+            Terms& terms = _terms[static_cast<size_t>(column)];
+
+            for (size_t row = 0; row < columns.Size(); ++row) {
+                ForEachToken(columns.Value(row, column), [&](std::string_view token, size_t) {
+                    bool           inserted = false;
+                    const uint32_t id       = terms.ids.Insert(
+                        token, static_cast<uint32_t>(terms.postings.size()), &inserted);
+                    if (inserted) {
+                        terms.postings.emplace_back();
+                    }
+                    terms.postings[id].Append(static_cast<uint32_t>(row));
+                });
+            }
+
+            terms.sorted.reserve(terms.ids.Size());
+            terms.ids.ForEach([&](std::string_view term, uint32_t id) {
+                terms.sorted.emplace_back(term, id);
+            });
+            std::sort(terms.sorted.begin(), terms.sorted.end());
+        }
+    }
+
+    bool TokenIndex::IsIndexedColumn(LogColumn column) {
+        return column == LogColumn::Detail || column == LogColumn::ActorId ||
+               column == LogColumn::Action || column == LogColumn::Source;
+    }
+
+    std::optional<Bitmap> TokenIndex::Candidates(LogColumn                       column,
+                                                 SearchType                      search_type,
+                                                 const std::vector<std::string>& values) const {
+        if (!IsIndexedColumn(column) || values.empty())
+            return std::nullopt;
+
+        const Terms& terms = _terms[static_cast<size_t>(column)];
+
+        switch (search_type) {
+            case SearchType::Like:
+                return PatternCandidates(terms, values.front(), false);
+            case SearchType::Equal:
+                return PatternCandidates(terms, values.front(), true);
+            case SearchType::Select: {
+                // Объединение кандидатов по всем значениям
+                Bitmap result(_rows);
+                for (const auto& value : values) {
+                    std::optional<Bitmap> candidates = PatternCandidates(terms, value, true);
+                    if (!candidates)
+                        return std::nullopt;
+                    result |= *candidates;
+                }
+                return result;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    std::optional<Bitmap> TokenIndex::PatternCandidates(const Terms&     terms,
+                                                        std::string_view pattern,
+                                                        bool             whole_value) const {
+        std::optional<Bitmap> result;
+
+        ForEachToken(pattern, [&](std::string_view token, size_t begin) {
+            if (result && result->None())
+                return;
+
+            // Граница токена гарантирована, если она совпадает с разделителем внутри образца
+            // или с границей значения при точном сравнении
+            const bool left_bounded  = begin > 0 || whole_value;
+            const bool right_bounded = begin + token.size() < pattern.size() || whole_value;
+
+            const TermMatch match = left_bounded && right_bounded ? TermMatch::Exact
+                                    : left_bounded                ? TermMatch::Prefix
+                                    : right_bounded               ? TermMatch::Suffix
+                                                                  : TermMatch::Contains;
+
+            Bitmap token_rows(_rows);
+            if (!AddMatchingTerms(terms, token, match, token_rows))
+                return;
+
+            if (result) {
+                *result &= token_rows;
+            } else {
+                result = std::move(token_rows);
+            }
+        });
+
+        // Нет селективных токенов - индекс не помогает
+        return result;
+    }
+
+    bool TokenIndex::AddMatchingTerms(const Terms&     terms,
+                                      std::string_view token,
+                                      TermMatch        match,
+                                      Bitmap&          bitmap) const {
+        std::vector<uint32_t> ids;
+
+        switch (match) {
+            case TermMatch::Exact:
+                if (const std::optional<uint32_t> id = terms.ids.Find(token)) {
+                    ids.push_back(*id);
+                }
+                break;
+            case TermMatch::Prefix: {
+                auto it = std::lower_bound(terms.sorted.begin(),
+                                           terms.sorted.end(),
+                                           token,
+                                           [](const auto& term, std::string_view value) {
+                                               return term.first < value;
+                                           });
+                for (; it != terms.sorted.end() && it->first.starts_with(token); ++it) {
+                    ids.push_back(it->second);
+                }
+                break;
+            }
+            case TermMatch::Suffix:
+                for (const auto& [term, id] : terms.sorted) {
+                    if (term.ends_with(token)) {
+                        ids.push_back(id);
+                    }
+                }
+                break;
+            case TermMatch::Contains:
+                for (const auto& [term, id] : terms.sorted) {
+                    if (ContainsSubstring(term, token)) {
+                        ids.push_back(id);
+                    }
+                }
+                break;
+        }
+
+        // Распаковка длинных списков дороже прямой проверки колонки
+        size_t postings = 0;
+        for (const uint32_t id : ids) {
+            postings += terms.postings[id].Count();
+        }
+        if (postings > _rows / SELECTIVITY_LIMIT)
+            return false;
+
+        for (const uint32_t id : ids) {
+            terms.postings[id].AddTo(bitmap);
+        }
+        return true;
+    }
+
+    size_t TokenIndex::MemoryUsage() const {
+        size_t bytes = 0;
+        for (const auto& terms : _terms) {
+            bytes += terms.sorted.size() * sizeof(terms.sorted[0]);
+            bytes += terms.ids.MemoryUsage();
+            for (const auto& posting : terms.postings) {
+                bytes += sizeof(PostingList) + posting.Bytes();
+            }
+        }
+        return bytes;
+    }
+} // namespace filters
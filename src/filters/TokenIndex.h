@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "filters/Bitmap.h"
+#include "filters/LogColumns.h"
+#include "structures/LogFilter.h"
+
+namespace filters {
+    // Список строк, содержащих токен: возрастающие номера строк, delta + varint
+    class PostingList {
+    public:
+        void Append(uint32_t row);
+
+        [[nodiscard]] uint32_t Count() const { return _count; }
+
+        [[nodiscard]] size_t Bytes() const { return _bytes.size(); }
+
+        void AddTo(Bitmap& bitmap) const;
+
+    private:
+        std::vector<uint8_t> _bytes;
+        uint32_t             _last  = 0;
+        uint32_t             _count = 0;
+    };
+
+    // Хеш-таблица термов с открытой адресацией: term -> id. Термы копируются в собственные
+    // блоки памяти: сравнение не обращается к разбросанным строкам исходных логов
+    class TermTable {
+    public:
+        // Возвращает id терма; новый терм получает next_id
+        uint32_t Insert(std::string_view term, uint32_t next_id, bool* inserted);
+
+        [[nodiscard]] std::optional<uint32_t> Find(std::string_view term) const;
+
+        [[nodiscard]] size_t Size() const { return _size; }
+
+        [[nodiscard]] size_t MemoryUsage() const {
+            return _slots.size() * sizeof(Slot) + _blocks.size() * BLOCK_SIZE;
+        }
+
+        template <typename Callback>
+        void ForEach(Callback&& callback) const {
+            for (const auto& slot : _slots) {
+                if (slot.id != EMPTY)
+                    callback(slot.term, slot.id);
+            }
+        }
+
+    private:
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        struct Slot {
+            std::string_view term;
+            uint64_t         hash = 0;
+            uint32_t         id   = EMPTY;
+        };
+
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        std::vector<Slot>                    _slots;
+        size_t                               _size = 0;
+        std::vector<std::unique_ptr<char[]>> _blocks;
+        size_t                               _block_used = BLOCK_SIZE;
+
+        std::string_view Intern(std::string_view term);
+
+        static uint64_t Hash(std::string_view term);
+
+        void Grow();
+    };
+
+    // Инвертированный индекс токенов колонок detail, actor_id, action и source.
+    // Строится один раз на срез дня и от исходных строк после построения не зависит
+    class TokenIndex {
+    public:
+        explicit TokenIndex(const LogColumns& columns);
+
+        static bool IsIndexedColumn(LogColumn column);
+
+        // Надмножество строк, которые могут пройти фильтр; nullopt - индекс не помогает
+        [[nodiscard]] std::optional<Bitmap>
+        Candidates(LogColumn column, SearchType search_type, const std::vector<std::string>& values)
+            const;
+
+        [[nodiscard]] size_t MemoryUsage() const;
+
+    private:
+        enum class TermMatch { Exact, Prefix, Suffix, Contains };
+
+        struct Terms {
+            TermTable                                          ids;
+            std::vector<PostingList>                           postings;
+            std::vector<std::pair<std::string_view, uint32_t>> sorted; // для префиксного поиска
+        };
+
+        static constexpr size_t SELECTIVITY_LIMIT = 8;
+
+        size_t                               _rows = 0;
+        std::array<Terms, LOG_COLUMNS_COUNT> _terms;
+
+        std::optional<Bitmap> PatternCandidates(const Terms&     terms,
+                                                std::string_view pattern,
+                                                bool             whole_value) const;
+
+        // false - термы покрывают слишком много строк, чтобы сужать выборку
+        bool AddMatchingTerms(const Terms&     terms,
+                              std::string_view token,
+                              TermMatch        match,
+                              Bitmap&          bitmap) const;
+    };
+} // namespace filters
@@ -0,0 +1,215 @@
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace logging {
+    namespace {
+        constexpr size_t QUEUE_MASK = LOG_QUEUE_CAPACITY - 1;
+
+        static_assert((LOG_QUEUE_CAPACITY & QUEUE_MASK) == 0, "capacity must be a power of two");
+
+        constexpr const char* LOG_PREFIX = "[DailyLogsReportInterface]: ";
+
+        int64_t NowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        std::FILE* LevelStream(LogLevel level) {
+            return level >= LogLevel::Warning ? stderr : stdout;
+        }
+    } // namespace
+
+    LoggerOptions LoggerOptionsFromEnvironment() {
+        LoggerOptions options;
+
+        if (const char* level = std::getenv("DAILY_LOGS_LOG_LEVEL")) {
+            const std::string_view name(level);
+            if (name == "debug") {
+                options.min_level = LogLevel::Debug;
+            } else if (name == "warning") {
+                options.min_level = LogLevel::Warning;
+            } else if (name == "error") {
+                options.min_level = LogLevel::Error;
+            }
+        }
+
+        if (const char* rate = std::getenv("DAILY_LOGS_LOG_RATE")) {
+            char*      end   = nullptr;
+            const long value = std::strtol(rate, &end, 10);
+            if (*rate != '\0' && *end == '\0' && value >= 0) {
+                options.rate = static_cast<uint32_t>(value);
+            }
+        }
+
+        return options;
+    }
+
+    AsyncLogger::AsyncLogger(const LoggerOptions& options)
+        : _options(options), _slots(std::make_unique<Slot[]>(LOG_QUEUE_CAPACITY)) {
+        if (_options.rate > 0) {
+            _emission_interval_ns = 1'000'000'000LL / _options.rate;
+            _burst_ns             = 1'000'000'000LL;
+        }
+
+        for (size_t i = 0; i < LOG_QUEUE_CAPACITY; ++i) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        _thread = std::thread([this] { Run(); });
+    }
+
+    AsyncLogger::~AsyncLogger() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+    }
+
+    bool AsyncLogger::Log(LogLevel level, const char* format, ...) {
+        if (!IsEnabled(level))
+            return false;
+
+        if (!IsAllowedByRate(level)) {
+            _rate_limited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        va_list arguments;
+        va_start(arguments, format);
+        const bool is_pushed = Push(level, format, arguments);
+        va_end(arguments);
+
+        if (!is_pushed) {
+            _overflowed.fetch_add(1, std::memory_order_relaxed);
+        }
+        return is_pushed;
+    }
+
+    bool AsyncLogger::IsAllowedByRate(LogLevel level) {
+        if (_emission_interval_ns == 0)
+            return true;
+
+        // Запись разрешена, если график уровня опережает текущее время не больше чем на всплеск
+        std::atomic<int64_t>& next_allowed = _next_allowed_ns[static_cast<size_t>(level)];
+
+        const int64_t now     = NowNs();
+        int64_t       current = next_allowed.load(std::memory_order_relaxed);
+        while (true) {
+            const int64_t base = current > now ? current : now;
+            if (base - now > _burst_ns)
+                return false;
+
+            if (next_allowed.compare_exchange_weak(
+                    current, base + _emission_interval_ns, std::memory_order_relaxed))
+                return true;
+        }
+    }
+
+    bool AsyncLogger::Push(LogLevel level, const char* format, va_list arguments) {
+        // Ограниченная очередь Вьюкова: позиция захватывается CAS, ячейка публикуется
+        // записью sequence = position + 1
+        size_t position = _enqueue_position.load(std::memory_order_relaxed);
+        Slot*  slot     = nullptr;
+
+        while (true) {
+            slot = &_slots[position & QUEUE_MASK];
+
+            const size_t   sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t lag =
+                static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (lag == 0) {
+                if (_enqueue_position.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (lag < 0) {
+                return false; // кольцо заполнено
+            } else {
+                position = _enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        const int length = std::vsnprintf(slot->text, LOG_RECORD_BYTES, format, arguments);
+
+        slot->level  = level;
+        slot->length = static_cast<uint16_t>(
+            length < 0 ? 0 : std::min<size_t>(static_cast<size_t>(length), LOG_RECORD_BYTES - 1));
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool AsyncLogger::Pop(LogLevel* level, char* text, size_t* length) {
+        Slot& slot = _slots[_dequeue_position & QUEUE_MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != _dequeue_position + 1)
+            return false;
+
+        *level  = slot.level;
+        *length = slot.length;
+        std::memcpy(text, slot.text, slot.length);
+
+        slot.sequence.store(_dequeue_position + LOG_QUEUE_CAPACITY, std::memory_order_release);
+        ++_dequeue_position;
+        return true;
+    }
+
+    void AsyncLogger::Drain() {
+        LogLevel level  = LogLevel::Info;
+        char     text[LOG_RECORD_BYTES];
+        size_t   length = 0;
+        bool     is_out = false;
+        bool     is_err = false;
+
+        while (Pop(&level, text, &length)) {
+            std::FILE* stream = LevelStream(level);
+            std::fputs(LOG_PREFIX, stream);
+            std::fwrite(text, 1, length, stream);
+            std::fputc('\n', stream);
+
+            (stream == stderr ? is_err : is_out) = true;
+        }
+
+        const uint64_t rate_limited = _rate_limited.exchange(0, std::memory_order_relaxed);
+        const uint64_t overflowed   = _overflowed.exchange(0, std::memory_order_relaxed);
+        if (rate_limited + overflowed > 0) {
+            std::fprintf(stderr,
+                         "%s%llu log records dropped (%llu rate limited, %llu queue full)\n",
+                         LOG_PREFIX,
+                         static_cast<unsigned long long>(rate_limited + overflowed),
+                         static_cast<unsigned long long>(rate_limited),
+                         static_cast<unsigned long long>(overflowed));
+            is_err = true;
+        }
+
+        if (is_out) {
+            std::fflush(stdout);
+        }
+        if (is_err) {
+            std::fflush(stderr);
+        }
+    }
+
+    void AsyncLogger::Run() {
+        std::unique_lock lock(_mutex);
+
+        while (true) {
+            const bool is_stopping =
+                _wakeup.wait_for(lock, DRAIN_INTERVAL, [this] { return _stopping; });
+
+            lock.unlock();
+            Drain();
+            lock.lock();
+
+            if (is_stopping)
+                return;
+        }
+    }
+} // namespace logging
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace logging {
+    enum class LogLevel : uint8_t { Debug, Info, Warning, Error };
+
+    inline constexpr size_t LOG_LEVELS_COUNT = 4;
+
+    // Запись длиннее обрезается: форматирование идет сразу в ячейку очереди
+    inline constexpr size_t LOG_RECORD_BYTES = 480;
+
+    // Емкость кольца; при переполнении запись отбрасывается, а не ждет
+    inline constexpr size_t LOG_QUEUE_CAPACITY = 1024;
+
+    // Настройки из окружения: DAILY_LOGS_LOG_LEVEL (debug / info / warning / error, по
+    // умолчанию info) и DAILY_LOGS_LOG_RATE - записей в секунду на уровень (по умолчанию 200,
+    // 0 - без ограничения; всплеск - до секундного объема)
+    struct LoggerOptions {
+        LogLevel min_level = LogLevel::Info;
+        uint32_t rate      = 200;
+    };
+
+    LoggerOptions LoggerOptionsFromEnvironment();
+
+    // Асинхронный журнал плагина. Потоки отчетов форматируют запись прямо в ячейку
+    // MPSC-кольца (без блокировок и аллокаций) и продолжают работу; фоновый поток раз в
+    // DRAIN_INTERVAL пишет накопленное: Debug / Info - в stdout, Warning / Error - в stderr,
+    // с одним fflush на пачку. Записи сверх лимита уровня или при полном кольце отбрасываются,
+    // их число выводится отдельной строкой
+    class AsyncLogger {
+    public:
+        explicit AsyncLogger(const LoggerOptions& options);
+
+        AsyncLogger(const AsyncLogger&)            = delete;
+        AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+        // Дописывает оставшиеся записи и останавливает поток
+        ~AsyncLogger();
+
+        // printf-формат; false - запись отброшена (уровень, лимит или полное кольцо)
+        bool Log(LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+        [[nodiscard]] bool IsEnabled(LogLevel level) const { return level >= _options.min_level; }
+
+    private:
+        static constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(50);
+
+        struct Slot {
+            std::atomic<size_t> sequence{0};
+            LogLevel            level  = LogLevel::Info;
+            uint16_t            length = 0;
+            char                text[LOG_RECORD_BYTES];
+        };
+
+        LoggerOptions _options;
+        int64_t       _emission_interval_ns = 0; // 1 / rate
+        int64_t       _burst_ns             = 0; // допустимое опережение графика
+
+        // Алгоритм GCRA: теоретическое время следующей записи уровня
+        std::array<std::atomic<int64_t>, LOG_LEVELS_COUNT> _next_allowed_ns{};
+
+        std::unique_ptr<Slot[]> _slots;
+        alignas(64) std::atomic<size_t> _enqueue_position{0};
+        alignas(64) size_t _dequeue_position = 0; // только поток вывода
+
+        std::atomic<uint64_t> _rate_limited{0};
+        std::atomic<uint64_t> _overflowed{0};
+
+        std::mutex              _mutex;
+        std::condition_variable _wakeup;
+        bool                    _stopping = false;
+        std::thread             _thread;
+
+        bool IsAllowedByRate(LogLevel level);
+
+        bool Push(LogLevel level, const char* format, va_list arguments);
+
+        // false - кольцо пусто
+        bool Pop(LogLevel* level, char* text, size_t* length);
+
+        void Drain();
+
+        void Run();
+    };
+} // namespace logging
@@ -0,0 +1,67 @@
+#include "RequestArena.h"
+
+#include <new>
+#include <utility>
+
+namespace memory {
+    void* SlabCache::Take(size_t bytes, size_t alignment) {
+        std::lock_guard lock(_mutex);
+
+        for (size_t i = _slabs.size(); i-- > 0;) {
+            if (_slabs[i].bytes == bytes && _slabs[i].alignment == alignment) {
+                void* pointer = _slabs[i].pointer;
+                _slabs[i]     = _slabs.back();
+                _slabs.pop_back();
+                _cached_bytes -= bytes;
+                return pointer;
+            }
+        }
+        return nullptr;
+    }
+
+    bool SlabCache::Put(void* pointer, size_t bytes, size_t alignment) {
+        std::lock_guard lock(_mutex);
+
+        if (_is_released || _cached_bytes + bytes > _max_bytes)
+            return false;
+
+        _slabs.push_back({pointer, bytes, alignment});
+        _cached_bytes += bytes;
+        return true;
+    }
+
+    void SlabCache::Release() {
+        std::vector<Slab> slabs;
+        {
+            std::lock_guard lock(_mutex);
+            slabs         = std::move(_slabs);
+            _cached_bytes = 0;
+            _is_released  = true;
+        }
+
+        for (const Slab& slab : slabs) {
+            ::operator delete(slab.pointer, slab.bytes, std::align_val_t(slab.alignment));
+        }
+    }
+
+    void* SlabResource::do_allocate(size_t bytes, size_t alignment) {
+        if (void* pointer = _cache->Take(bytes, alignment))
+            return pointer;
+
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void SlabResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+        if (!_cache->Put(pointer, bytes, alignment)) {
+            ::operator delete(pointer, bytes, std::align_val_t(alignment));
+        }
+    }
+
+    bool SlabResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        const auto* slabs = dynamic_cast<const SlabResource*>(&other);
+        return slabs != nullptr && slabs->_cache == _cache;
+    }
+
+    RequestArena::RequestArena(std::shared_ptr<SlabCache> cache)
+        : _slabs(std::move(cache)), _buffer(INITIAL_SLAB_BYTES, &_slabs) {}
+} // namespace memory
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace memory {
+    // Первый кусок арены; следующие монотонный буфер запрашивает с ростом в 1.5-2 раза
+    inline constexpr size_t INITIAL_SLAB_BYTES = 256 * 1024;
+
+    // Предел кеша кусков: хватает на арену обычного отчета, остальное возвращается в malloc
+    inline constexpr size_t MAX_CACHED_SLAB_BYTES = 8 * 1024 * 1024;
+
+    // Свободные куски арен, общие для всех потоков. Размеры, которые запрашивает монотонный
+    // буфер, повторяются от отчета к отчету, поэтому поиск точного совпадения почти всегда
+    // успешен. Принадлежит runtime::PluginRuntime и освобождается в его Shutdown
+    class SlabCache {
+    public:
+        explicit SlabCache(size_t max_bytes = MAX_CACHED_SLAB_BYTES) : _max_bytes(max_bytes) {}
+
+        SlabCache(const SlabCache&)            = delete;
+        SlabCache& operator=(const SlabCache&) = delete;
+
+        ~SlabCache() { Release(); }
+
+        // nullptr - подходящего куска нет
+        void* Take(size_t bytes, size_t alignment);
+
+        // false - кеш полон или освобожден, кусок возвращает вызывающий
+        bool Put(void* pointer, size_t bytes, size_t alignment);
+
+        // Возвращает куски в malloc; дальше кеш ничего не принимает - арены отчетов,
+        // переживших остановку, освобождают память напрямую
+        void Release();
+
+    private:
+        struct Slab {
+            void*  pointer;
+            size_t bytes;
+            size_t alignment;
+        };
+
+        std::mutex        _mutex;
+        std::vector<Slab> _slabs;
+        size_t            _cached_bytes = 0;
+        size_t            _max_bytes;
+        bool              _is_released = false;
+    };
+
+    // Источник кусков для монотонной арены: освобожденный кусок остается в cache и отдается
+    // следующему запросу того же размера - без обращения к malloc
+    class SlabResource final : public std::pmr::memory_resource {
+    public:
+        explicit SlabResource(std::shared_ptr<SlabCache> cache) : _cache(std::move(cache)) {}
+
+    private:
+        std::shared_ptr<SlabCache> _cache;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void  do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    // Арена запроса: все временные контейнеры отчета берут память из монотонного буфера
+    // и освобождаются разом вместе с ареной. Не потокобезопасна - ей пользуется одна
+    // корутина конвейера (шаги идут по очереди, даже если переходят между потоками)
+    class RequestArena {
+    public:
+        explicit RequestArena(std::shared_ptr<SlabCache> cache);
+
+        RequestArena(const RequestArena&)            = delete;
+        RequestArena& operator=(const RequestArena&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* Resource() { return &_buffer; }
+
+    private:
+        SlabResource                        _slabs;
+        std::pmr::monotonic_buffer_resource _buffer;
+    };
+} // namespace memory
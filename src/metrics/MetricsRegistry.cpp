@@ -0,0 +1,209 @@
+#include "MetricsRegistry.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <stdexcept>
+
+namespace metrics {
+    namespace {
+        std::atomic<size_t> next_shard{0};
+
+        std::string Escape(std::string_view text, bool is_label_value) {
+            std::string escaped;
+            escaped.reserve(text.size());
+            for (const char c : text) {
+                if (c == '\\') {
+                    escaped += "\\\\";
+                } else if (c == '\n') {
+                    escaped += "\\n";
+                } else if (c == '"' && is_label_value) {
+                    escaped += "\\\"";
+                } else {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        // Границы и суммы: без экспоненты для целых и без хвоста из девяток для долей
+        void AppendNumber(std::string* out, double value) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+            *out += buffer;
+        }
+
+        void AppendNumber(std::string* out, uint64_t value) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+            *out += buffer;
+        }
+
+        // name{labels,extra} - пустые части пропускаются вместе со скобками
+        void AppendSeries(std::string*       out,
+                          const std::string& name,
+                          std::string_view   suffix,
+                          const std::string& labels,
+                          std::string_view   extra = {}) {
+            *out += name;
+            *out += suffix;
+            if (!labels.empty() || !extra.empty()) {
+                *out += '{';
+                *out += labels;
+                if (!labels.empty() && !extra.empty()) {
+                    *out += ',';
+                }
+                *out += extra;
+                *out += '}';
+            }
+            *out += ' ';
+        }
+    } // namespace
+
+    size_t CurrentShard() {
+        thread_local const size_t shard =
+            next_shard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+        return shard;
+    }
+
+    uint64_t Counter::Value() const {
+        uint64_t value = 0;
+        for (const Shard& shard : _shards) {
+            value += shard.value.load(std::memory_order_relaxed);
+        }
+        return value;
+    }
+
+    Histogram::Histogram(const HistogramOptions& options) {
+        const size_t steps = std::max<size_t>(options.steps_per_octave, 1);
+
+        double octave_bound = options.first_bound;
+        _bounds.reserve(options.octaves * steps + 1);
+        for (size_t octave = 0; octave < options.octaves; ++octave) {
+            for (size_t step = 0; step < steps; ++step) {
+                _bounds.push_back(octave_bound * (1.0 + static_cast<double>(step) / steps));
+            }
+            octave_bound *= 2;
+        }
+        _bounds.push_back(octave_bound);
+
+        for (Shard& shard : _shards) {
+            shard.counts = std::make_unique<std::atomic<uint64_t>[]>(_bounds.size() + 1);
+        }
+    }
+
+    void Histogram::Observe(double value) {
+        // Корзина le - первая граница не меньше значения; за последней - +Inf
+        const size_t bucket =
+            std::lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin();
+
+        Shard& shard = _shards[CurrentShard()];
+        shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    Histogram::Sample Histogram::Collect() const {
+        Sample sample;
+        sample.cumulative.assign(_bounds.size() + 1, 0);
+
+        for (const Shard& shard : _shards) {
+            for (size_t i = 0; i < sample.cumulative.size(); ++i) {
+                sample.cumulative[i] += shard.counts[i].load(std::memory_order_relaxed);
+            }
+            sample.sum += shard.sum.load(std::memory_order_relaxed);
+        }
+
+        for (size_t i = 1; i < sample.cumulative.size(); ++i) {
+            sample.cumulative[i] += sample.cumulative[i - 1];
+        }
+        return sample;
+    }
+
+    std::string Label(std::string_view name, std::string_view value) {
+        std::string label(name);
+        label += "=\"";
+        label += Escape(value, true);
+        label += '"';
+        return label;
+    }
+
+    MetricsRegistry::Family& MetricsRegistry::GetFamily(const std::string& name,
+                                                        const std::string& help,
+                                                        MetricType         type) {
+        const auto [it, is_inserted] = _families.try_emplace(name, Family{type, help, {}, {}});
+        if (!is_inserted && it->second.type != type)
+            throw std::invalid_argument("metric " + name + " is registered with another type");
+
+        return it->second;
+    }
+
+    Counter& MetricsRegistry::GetCounter(const std::string& name,
+                                         const std::string& help,
+                                         const std::string& labels) {
+        std::lock_guard lock(_mutex);
+
+        auto& counter = GetFamily(name, help, MetricType::Counter).counters[labels];
+        if (!counter) {
+            counter = std::make_unique<Counter>();
+        }
+        return *counter;
+    }
+
+    Histogram& MetricsRegistry::GetHistogram(const std::string&      name,
+                                             const std::string&      help,
+                                             const HistogramOptions& options,
+                                             const std::string&      labels) {
+        std::lock_guard lock(_mutex);
+
+        auto& histogram = GetFamily(name, help, MetricType::Histogram).histograms[labels];
+        if (!histogram) {
+            histogram = std::make_unique<Histogram>(options);
+        }
+        return *histogram;
+    }
+
+    std::string MetricsRegistry::TextExposition() const {
+        std::lock_guard lock(_mutex);
+
+        std::string text;
+        for (const auto& [name, family] : _families) {
+            text += "# HELP " + name + " " + Escape(family.help, false) + "\n";
+            text += "# TYPE " + name +
+                    (family.type == MetricType::Counter ? " counter\n" : " histogram\n");
+
+            for (const auto& [labels, counter] : family.counters) {
+                AppendSeries(&text, name, "", labels);
+                AppendNumber(&text, counter->Value());
+                text += '\n';
+            }
+
+            for (const auto& [labels, histogram] : family.histograms) {
+                const Histogram::Sample    sample = histogram->Collect();
+                const std::vector<double>& bounds = histogram->Bounds();
+
+                for (size_t i = 0; i < sample.cumulative.size(); ++i) {
+                    std::string le = "le=\"";
+                    if (i < bounds.size()) {
+                        AppendNumber(&le, bounds[i]);
+                    } else {
+                        le += "+Inf";
+                    }
+                    le += '"';
+
+                    AppendSeries(&text, name, "_bucket", labels, le);
+                    AppendNumber(&text, sample.cumulative[i]);
+                    text += '\n';
+                }
+
+                AppendSeries(&text, name, "_sum", labels);
+                AppendNumber(&text, sample.sum);
+                text += '\n';
+
+                AppendSeries(&text, name, "_count", labels);
+                AppendNumber(&text, sample.cumulative.back());
+                text += '\n';
+            }
+        }
+        return text;
+    }
+} // namespace metrics
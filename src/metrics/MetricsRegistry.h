@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace metrics {
+    // Число копий значения: потоки пишут каждый в свою и не делят кеш-линию
+    inline constexpr size_t METRIC_SHARDS = 8;
+
+    // Копия метрики для текущего потока; потоки раздаются по копиям по кругу
+    size_t CurrentShard();
+
+    // Монотонный счетчик; увеличивается из любого потока без блокировок
+    class Counter {
+    public:
+        void Add(uint64_t value = 1) {
+            _shards[CurrentShard()].value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] uint64_t Value() const;
+
+    private:
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> value{0};
+        };
+
+        std::array<Shard, METRIC_SHARDS> _shards;
+    };
+
+    // Лог-линейные границы: октавы [first_bound * 2^k, first_bound * 2^(k+1)] делятся на
+    // steps_per_octave равных частей. Относительная погрешность - не больше 1 / steps_per_octave
+    struct HistogramOptions {
+        double first_bound      = 0.001;
+        size_t octaves          = 16;
+        size_t steps_per_octave = 2;
+    };
+
+    // Длительности в секундах: от 1 мс до 65 с
+    inline constexpr HistogramOptions LATENCY_SECONDS{0.001, 16, 2};
+
+    // Объемы в строках: от 100 до 100 млн
+    inline constexpr HistogramOptions ROW_COUNTS{100, 20, 2};
+
+    // Гистограмма Prometheus: счетчики по корзинам, сумма и количество наблюдений.
+    // Observe не блокирует, корзина находится двоичным поиском по границам
+    class Histogram {
+    public:
+        explicit Histogram(const HistogramOptions& options);
+
+        void Observe(double value);
+
+        struct Sample {
+            std::vector<uint64_t> cumulative; // по границам Bounds() и последняя - +Inf
+            double                sum = 0;
+        };
+
+        [[nodiscard]] const std::vector<double>& Bounds() const { return _bounds; }
+
+        [[nodiscard]] Sample Collect() const;
+
+    private:
+        struct alignas(64) Shard {
+            std::unique_ptr<std::atomic<uint64_t>[]> counts;
+            std::atomic<double>                      sum{0};
+        };
+
+        std::vector<double>              _bounds;
+        std::array<Shard, METRIC_SHARDS> _shards;
+    };
+
+    // Записывает в гистограмму секунды от создания до разрушения
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Histogram& histogram)
+            : _histogram(histogram), _started(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer() {
+            _histogram.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                             _started)
+                                   .count());
+        }
+
+        ScopedTimer(const ScopedTimer&)            = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Histogram&                            _histogram;
+        std::chrono::steady_clock::time_point _started;
+    };
+
+    // Метка в формате Prometheus: name="value" с экранированием
+    std::string Label(std::string_view name, std::string_view value);
+
+    // Именованные метрики плагина; labels - готовые метки (Label, через запятую).
+    // Регистрация - под мьютексом, поэтому на горячих путях ссылку на метрику стоит получить
+    // один раз; она действительна, пока жив реестр. Имя, уже занятое метрикой другого типа,
+    // дает std::invalid_argument
+    class MetricsRegistry {
+    public:
+        Counter& GetCounter(const std::string& name,
+                            const std::string& help,
+                            const std::string& labels = "");
+
+        Histogram& GetHistogram(const std::string&      name,
+                                const std::string&      help,
+                                const HistogramOptions& options,
+                                const std::string&      labels = "");
+
+        // Все метрики в текстовом формате Prometheus 0.0.4, семейства в порядке имен
+        [[nodiscard]] std::string TextExposition() const;
+
+    private:
+        enum class MetricType : uint8_t { Counter, Histogram };
+
+        struct Family {
+            MetricType                                        type;
+            std::string                                       help;
+            std::map<std::string, std::unique_ptr<Counter>>   counters;
+            std::map<std::string, std::unique_ptr<Histogram>> histograms;
+        };
+
+        Family& GetFamily(const std::string& name, const std::string& help, MetricType type);
+
+        mutable std::mutex            _mutex;
+        std::map<std::string, Family> _families;
+    };
+} // namespace metrics
@@ -0,0 +1,54 @@
+#include "ReportMetrics.h"
+
+#include <iterator>
+#include <string>
+
+namespace metrics {
+    namespace {
+        constexpr const char* PHASE_NAMES[] = {"validate", "fetch", "aggregate", "table", "render"};
+
+        static_assert(std::size(PHASE_NAMES) == static_cast<size_t>(ReportPhase::Count));
+
+        Counter& DeniedCounter(MetricsRegistry& registry, int code) {
+            return registry.GetCounter("daily_logs_reports_denied_total",
+                                       "Requests rejected by validation",
+                                       Label("code", std::to_string(code)));
+        }
+    } // namespace
+
+    ReportMetrics::ReportMetrics(MetricsRegistry& registry)
+        : _registry(registry),
+          _reports(registry.GetCounter("daily_logs_reports_total", "Reports started")),
+          _partial(registry.GetCounter("daily_logs_reports_partial_total",
+                                       "Reports cut by the deadline")),
+          _exports(registry.GetCounter("daily_logs_exports_total", "Export requests")),
+          _day_cache_hits(registry.GetCounter("daily_logs_day_cache_hits_total",
+                                              "Day cache lookups for the table")),
+          _day_cache_misses(registry.GetCounter("daily_logs_day_cache_misses_total",
+                                                "Day cache lookups for the table")),
+          _create_report_duration(
+              registry.GetHistogram("daily_logs_create_report_duration_seconds",
+                                    "CreateReport latency as seen by the host",
+                                    LATENCY_SECONDS)),
+          _fetched_rows(registry.GetHistogram("daily_logs_report_fetched_rows",
+                                              "Log rows returned by GetLogs per report",
+                                              ROW_COUNTS)) {
+        for (size_t i = 0; i < DENIED_CODES.size(); ++i) {
+            _denied[i] = &DeniedCounter(registry, DENIED_CODES[i]);
+        }
+        for (size_t i = 0; i < _phases.size(); ++i) {
+            _phases[i] = &registry.GetHistogram("daily_logs_phase_duration_seconds",
+                                                "Report phase latency",
+                                                LATENCY_SECONDS,
+                                                Label("phase", PHASE_NAMES[i]));
+        }
+    }
+
+    Counter& ReportMetrics::Denied(int code) {
+        for (size_t i = 0; i < DENIED_CODES.size(); ++i) {
+            if (DENIED_CODES[i] == code)
+                return *_denied[i];
+        }
+        return DeniedCounter(_registry, code);
+    }
+} // namespace metrics
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "metrics/MetricsRegistry.h"
+
+namespace metrics {
+    // Фазы отчета в daily_logs_phase_duration_seconds
+    enum class ReportPhase { Validate, Fetch, Aggregate, Table, Render, Count };
+
+    // Метрики отчета, разрешенные в реестре один раз при создании среды: CreateReport и
+    // конвейер пишут в них без мьютекса реестра. Ссылки действительны, пока жив registry
+    class ReportMetrics {
+    public:
+        explicit ReportMetrics(MetricsRegistry& registry);
+
+        ReportMetrics(const ReportMetrics&)            = delete;
+        ReportMetrics& operator=(const ReportMetrics&) = delete;
+
+        [[nodiscard]] Counter& Reports() { return _reports; }
+        [[nodiscard]] Counter& Partial() { return _partial; }
+        [[nodiscard]] Counter& Exports() { return _exports; }
+
+        // Отказ валидации; коды RequestValidator разрешены заранее, прочие ищутся в реестре
+        [[nodiscard]] Counter& Denied(int code);
+
+        [[nodiscard]] Counter& DayCacheLookup(bool is_hit) {
+            return is_hit ? _day_cache_hits : _day_cache_misses;
+        }
+
+        [[nodiscard]] Histogram& CreateReportDuration() { return _create_report_duration; }
+        [[nodiscard]] Histogram& FetchedRows() { return _fetched_rows; }
+
+        [[nodiscard]] Histogram& Phase(ReportPhase phase) {
+            return *_phases[static_cast<size_t>(phase)];
+        }
+
+    private:
+        static constexpr std::array DENIED_CODES = {400, 403, 404};
+
+        MetricsRegistry& _registry;
+
+        Counter&   _reports;
+        Counter&   _partial;
+        Counter&   _exports;
+        Counter&   _day_cache_hits;
+        Counter&   _day_cache_misses;
+        Histogram& _create_report_duration;
+        Histogram& _fetched_rows;
+
+        std::array<Counter*, DENIED_CODES.size()>                       _denied{};
+        std::array<Histogram*, static_cast<size_t>(ReportPhase::Count)> _phases{};
+    };
+} // namespace metrics
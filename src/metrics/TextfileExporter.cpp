@@ -0,0 +1,81 @@
+#include "TextfileExporter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace metrics {
+    TextfileOptions TextfileOptionsFromEnvironment() {
+        TextfileOptions options;
+
+        if (const char* path = std::getenv("DAILY_LOGS_METRICS_FILE")) {
+            options.path = path;
+        }
+
+        if (const char* interval = std::getenv("DAILY_LOGS_METRICS_INTERVAL")) {
+            char*      end   = nullptr;
+            const long value = std::strtol(interval, &end, 10);
+            if (*interval != '\0' && *end == '\0' && value > 0) {
+                options.interval = std::chrono::seconds(value);
+            }
+        }
+
+        return options;
+    }
+
+    TextfileExporter::TextfileExporter(const MetricsRegistry& registry,
+                                       logging::AsyncLogger&  logger,
+                                       TextfileOptions        options)
+        : _registry(registry), _logger(logger), _options(std::move(options)) {
+        _thread = std::thread([this] { Run(); });
+    }
+
+    TextfileExporter::~TextfileExporter() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wakeup.notify_all();
+        _thread.join();
+    }
+
+    bool TextfileExporter::Write() {
+        const std::string text      = _registry.TextExposition();
+        const std::string temporary = _options.path + ".tmp";
+
+        bool       is_written = false;
+        std::FILE* file       = std::fopen(temporary.c_str(), "w");
+        if (file != nullptr) {
+            is_written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+            is_written = std::fclose(file) == 0 && is_written;
+            is_written = is_written && std::rename(temporary.c_str(), _options.path.c_str()) == 0;
+        }
+
+        if (!is_written && !_is_failing) {
+            _logger.Log(logging::LogLevel::Error,
+                        "metrics file %s: %s",
+                        _options.path.c_str(),
+                        std::strerror(errno));
+        }
+        _is_failing = !is_written;
+        return is_written;
+    }
+
+    void TextfileExporter::Run() {
+        std::unique_lock lock(_mutex);
+
+        while (true) {
+            const bool is_stopping =
+                _wakeup.wait_for(lock, _options.interval, [this] { return _stopping; });
+
+            lock.unlock();
+            Write();
+            lock.lock();
+
+            if (is_stopping)
+                return;
+        }
+    }
+} // namespace metrics
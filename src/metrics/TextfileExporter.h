@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "logging/AsyncLogger.h"
+#include "metrics/MetricsRegistry.h"
+
+namespace metrics {
+    // Настройки из окружения: DAILY_LOGS_METRICS_FILE - файл для textfile collector
+    // node_exporter (*.prom; пустой - выгрузка выключена) и DAILY_LOGS_METRICS_INTERVAL -
+    // период в секундах (по умолчанию 15)
+    struct TextfileOptions {
+        std::string          path;
+        std::chrono::seconds interval{15};
+    };
+
+    TextfileOptions TextfileOptionsFromEnvironment();
+
+    // Фоновая выгрузка реестра в файл раз в interval и при разрушении. Файл заменяется
+    // атомарно (запись во временный рядом и rename), поэтому коллектор не видит половину файла
+    class TextfileExporter {
+    public:
+        TextfileExporter(const MetricsRegistry& registry,
+                         logging::AsyncLogger&  logger,
+                         TextfileOptions        options);
+
+        TextfileExporter(const TextfileExporter&)            = delete;
+        TextfileExporter& operator=(const TextfileExporter&) = delete;
+
+        // Последняя выгрузка и остановка потока
+        ~TextfileExporter();
+
+    private:
+        const MetricsRegistry& _registry;
+        logging::AsyncLogger&  _logger;
+        TextfileOptions        _options;
+        bool                   _is_failing = false; // об ошибке пишется один раз подряд
+
+        std::mutex              _mutex;
+        std::condition_variable _wakeup;
+        bool                    _stopping = false;
+        std::thread             _thread;
+
+        // false - файл не записан
+        bool Write();
+
+        void Run();
+    };
+} // namespace metrics
@@ -0,0 +1,336 @@
+#include "ReportPanels.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+#include "sessions/Sessionizer.h"
+#include "utils/Utils.h"
+
+using namespace ast;
+
+namespace panels {
+    namespace {
+        const std::vector<std::string> colors = {
+            "#4A90E2", "#50E3C2", "#F5A623", "#D0021B", "#9013FE"};
+        const std::string other_color = "#B8E986";
+
+        const JSONObject counters_style = {{"display", JSONValue("flex")},
+                                           {"gap", JSONValue("24px")}};
+
+        const JSONObject sample_note_style = {{"color", JSONValue("#8A6D3B")},
+                                              {"fontStyle", JSONValue("italic")}};
+
+        const std::vector<std::string> unique_keys = {"unique_clients", "unique_ips"};
+
+        // Линии сообщений и уникальных значений по дням; with_ci - усы интервала из "<key>_ci"
+        Node ServerLogsChart(const JSONArray& chart_data, bool with_ci) {
+            const std::vector<std::string> line_keys  = {"client", "manager", "system", "total"};
+            std::vector<Node>              line_nodes = {// Default nodes
+                                            XAxis({}, props({{"dataKey", "day"}})),
+                                            YAxis(),
+                                            Tooltip(),
+                                            Legend()};
+
+            // Формирование Line nodes
+            for (size_t i = 0; i < line_keys.size(); ++i) {
+                std::string color = (line_keys[i] == "total") ? other_color : colors[i];
+
+                std::vector<Node> error_bars;
+                if (with_ci) {
+                    error_bars.push_back(ErrorBar(
+                        {}, props({{"dataKey", line_keys[i] + "_ci"}, {"stroke", color}})));
+                }
+
+                line_nodes.push_back(Line(
+                    error_bars,
+                    props({{"type", "monotone"}, {"dataKey", line_keys[i]}, {"stroke", color}})));
+            }
+
+            // Уникальные клиенты и IP - пунктиром на правой оси
+            line_nodes.push_back(
+                YAxis({}, props({{"yAxisId", "uniques"}, {"orientation", "right"}})));
+            for (size_t i = 0; i < unique_keys.size(); ++i) {
+                line_nodes.push_back(Line({},
+                                          props({{"type", "monotone"},
+                                                 {"dataKey", unique_keys[i]},
+                                                 {"yAxisId", "uniques"},
+                                                 {"strokeDasharray", "4 2"},
+                                                 {"stroke", colors[i]}})));
+            }
+
+            return ResponsiveContainer({LineChart(line_nodes, props({{"data", chart_data}}))},
+                                       props({{"width", "100%"}, {"height", 300.0}}));
+        }
+
+        // Уникальные за все окно: объединение дневных эскизов. Только если эскизы есть
+        // для каждого дня графика, иначе счетчик занизил бы значение
+        std::vector<Node> UniquesCounters(const DailyUniques& day_uniques,
+                                          const JSONArray&    chart_data) {
+            DayUniques window_uniques;
+
+            for (const auto& row : chart_data) {
+                const auto& point = std::get<JSONObject>(row.value);
+                const auto  it = day_uniques.find(std::get<std::string>(point.at("day").value));
+                if (it == day_uniques.end())
+                    return {};
+
+                window_uniques.clients.Merge(it->second.clients);
+                window_uniques.ips.Merge(it->second.ips);
+            }
+
+            const std::vector<std::pair<std::string, double>> uniques_counters = {
+                {"Unique clients", window_uniques.clients.Estimate()},
+                {"Unique IPs", window_uniques.ips.Estimate()}};
+
+            std::vector<Node> counter_nodes;
+            for (const auto& [label, value] : uniques_counters) {
+                counter_nodes.push_back(
+                    div({h3({text(label)}), h2({text(std::to_string(std::llround(value)))})},
+                        props({{"style",
+                                JSONValue(JSONObject{{"minWidth", JSONValue("160px")}})}})));
+            }
+
+            return {div(counter_nodes, props({{"style", JSONValue(counters_style)}}))};
+        }
+
+        // Пояснение к панели, посчитанной по выборке
+        Node SampleNote(const sampling::StratifiedSample& sample) {
+            std::ostringstream note;
+            note << "Estimated from " << sample.SampledRows() << " of " << sample.Population()
+                 << " rows (" << (sample.IsStratified() ? "stratified by hour" : "uniform sample")
+                 << "), 95% confidence intervals";
+
+            return p({text(note.str())}, props({{"style", sample_note_style}}));
+        }
+
+        Node TopFloodersChart(const JSONArray& chart_data) {
+            // Вектор Cell с цветами для каждой записи
+            std::vector<Node> top_flooders_pie_cells;
+            for (size_t i = 0; i < chart_data.size(); ++i) {
+                std::string color = i < colors.size() ? colors[i] : other_color;
+                top_flooders_pie_cells.push_back(Cell({}, props({{"fill", color}})));
+            }
+
+            return ResponsiveContainer({PieChart({Tooltip(),
+                                                  Legend(),
+                                                  Pie(top_flooders_pie_cells,
+                                                      props({{"dataKey", "value"},
+                                                             {"nameKey", "label"},
+                                                             {"data", chart_data},
+                                                             {"cx", "50%"},
+                                                             {"cy", "50%"},
+                                                             {"outerRadius", 100.0},
+                                                             {"label", true}}))})},
+                                       props({{"width", "100%"}, {"height", 300.0}}));
+        }
+    } // namespace
+
+    std::vector<Node> ServerLogsPanel(CompactLogSpan week_logs, DailyUniques* day_uniques) {
+        // Server logs chart
+        const JSONArray server_logs_chart_data =
+            utils::CreateServerLogsChartData(week_logs, day_uniques);
+
+        std::vector<Node> nodes = {h2({text("Server Messages (last 2 weeks)")})};
+        for (auto& counters : UniquesCounters(*day_uniques, server_logs_chart_data)) {
+            nodes.push_back(std::move(counters));
+        }
+        nodes.push_back(ServerLogsChart(server_logs_chart_data, false));
+        return nodes;
+    }
+
+    std::vector<Node> ServerLogsPanel(CompactLogSpan                    week_logs,
+                                      const sampling::StratifiedSample& sample,
+                                      const DailyUniques&               day_uniques) {
+        JSONArray server_logs_chart_data =
+            sampling::CreateSampledServerLogsChartData(week_logs, sample);
+        utils::AddDailyUniquesToChartData(day_uniques, &server_logs_chart_data);
+
+        std::vector<Node> nodes = {h2({text("Server Messages (last 2 weeks, estimated)")}),
+                                   SampleNote(sample)};
+        for (auto& counters : UniquesCounters(day_uniques, server_logs_chart_data)) {
+            nodes.push_back(std::move(counters));
+        }
+        nodes.push_back(ServerLogsChart(server_logs_chart_data, true));
+        return nodes;
+    }
+
+    std::vector<Node> ErrorsPanel(CompactLogSpan week_logs, time_t from, time_t to) {
+        // Errors chart and counters
+        const JSONArray      errors_chart_data = utils::CreateErrorsChartData(week_logs);
+        const SeverityCounts severity_counts   = utils::CountSeverities(week_logs, from, to);
+
+        const std::vector<std::pair<std::string, std::string>> error_bars = {
+            {"warning", "#F5A623"}, {"error", "#D0021B"}, {"critical", "#9013FE"}};
+
+        std::vector<Node> error_bar_nodes = {XAxis({}, props({{"dataKey", "day"}})),
+                                             YAxis(),
+                                             Tooltip(),
+                                             Legend()};
+
+        for (const auto& [key, color] : error_bars) {
+            error_bar_nodes.push_back(Bar({}, props({{"dataKey", key}, {"fill", color}})));
+        }
+
+        Node errors_chart_node = ResponsiveContainer(
+            {BarChart(error_bar_nodes, props({{"data", errors_chart_data}}))},
+            props({{"width", "100%"}, {"height", 300.0}}));
+
+        const std::vector<std::tuple<std::string, uint64_t, std::string>> severity_counters = {
+            {"Regular", severity_counts.regular, "#4A90E2"},
+            {"Warnings", severity_counts.warning, "#F5A623"},
+            {"Errors", severity_counts.error, "#D0021B"},
+            {"Critical errors", severity_counts.critical, "#9013FE"}};
+
+        std::vector<Node> counter_nodes;
+        for (const auto& [label, value, color] : severity_counters) {
+            counter_nodes.push_back(div(
+                {h3({text(label)}),
+                 h2({text(std::to_string(value))},
+                    props({{"style", JSONValue(JSONObject{{"color", JSONValue(color)}})}}))},
+                props({{"style", JSONValue(JSONObject{{"minWidth", JSONValue("160px")}})}})));
+        }
+
+        const Node severity_counters_node =
+            div(counter_nodes, props({{"style", JSONValue(counters_style)}}));
+
+        return {h2({text("Errors / Critical errors (24h)")}),
+                severity_counters_node,
+                errors_chart_node};
+    }
+
+    std::vector<Node> ConnectionsPanel(CompactLogSpan             week_logs,
+                                       time_t                     from,
+                                       time_t                     to,
+                                       std::pmr::memory_resource* resource) {
+        // Connections
+        const ConnectionStats connection_stats =
+            sessions::BuildConnectionStats(week_logs, from, to, resource);
+
+        std::ostringstream average_duration;
+        average_duration << std::fixed << std::setprecision(1)
+                         << connection_stats.average_duration / 60.0;
+
+        const std::vector<std::pair<std::string, std::string>> connection_counters = {
+            {"Sessions", std::to_string(connection_stats.sessions)},
+            {"Unique actors", std::to_string(connection_stats.unique_actors)},
+            {"Peak concurrent", std::to_string(connection_stats.peak_concurrent)},
+            {"Peak at",
+             connection_stats.peak_concurrent == 0
+                 ? std::string("-")
+                 : utils::FormatLogTime(connection_stats.peak_time)},
+            {"Avg duration, min", average_duration.str()},
+            {"Still open", std::to_string(connection_stats.open_sessions)},
+            {"Orphan disconnects", std::to_string(connection_stats.orphan_disconnects)}};
+
+        std::vector<Node> connection_counter_nodes;
+        for (const auto& [label, value] : connection_counters) {
+            connection_counter_nodes.push_back(div(
+                {h3({text(label)}), h2({text(value)})},
+                props({{"style", JSONValue(JSONObject{{"minWidth", JSONValue("160px")}})}})));
+        }
+
+        const Node connection_counters_node =
+            div(connection_counter_nodes, props({{"style", JSONValue(counters_style)}}));
+
+        Node concurrent_sessions_chart = ResponsiveContainer(
+            {LineChart({XAxis({}, props({{"dataKey", "hour"}})),
+                        YAxis(),
+                        Tooltip(),
+                        Legend(),
+                        Line({},
+                             props({{"type", "stepAfter"},
+                                    {"dataKey", "concurrent"},
+                                    {"stroke", colors[0]}}))},
+                       props({{"data",
+                               utils::CreateConcurrentSessionsChartData(connection_stats)}}))},
+            props({{"width", "100%"}, {"height", 300.0}}));
+
+        Node connection_types_chart = ResponsiveContainer(
+            {BarChart({XAxis({}, props({{"dataKey", "type"}})),
+                       YAxis(),
+                       Tooltip(),
+                       Bar({}, props({{"dataKey", "sessions"}, {"fill", colors[1]}}))},
+                      props({{"data",
+                              utils::CreateConnectionTypesChartData(connection_stats)}}))},
+            props({{"width", "100%"}, {"height", 300.0}}));
+
+        Node session_types_chart = ResponsiveContainer(
+            {BarChart({XAxis({}, props({{"dataKey", "type"}})),
+                       YAxis(),
+                       Tooltip(),
+                       Bar({}, props({{"dataKey", "sessions"}, {"fill", colors[2]}}))},
+                      props({{"data", utils::CreateSessionTypesChartData(connection_stats)}}))},
+            props({{"width", "100%"}, {"height", 300.0}}));
+
+        return {h2({text("Connections (24h)")}),
+                connection_counters_node,
+                concurrent_sessions_chart,
+                h3({text("By connection type")}),
+                connection_types_chart,
+                h3({text("By session type")}),
+                session_types_chart};
+    }
+
+    std::vector<Node> TopFloodersPanel(CompactLogSpan             clients_logs,
+                                       std::pmr::memory_resource* resource) {
+        // Top flooder chart
+        const JSONArray top_flooders_chart_data =
+            utils::CreateTopFloodersChartData(clients_logs, resource);
+
+        return {h2({text("Top flooders (24h, %)")}), TopFloodersChart(top_flooders_chart_data)};
+    }
+
+    std::vector<Node> TopFloodersPanel(CompactLogSpan                    clients_logs,
+                                       const sampling::StratifiedSample& sample,
+                                       std::pmr::memory_resource*        resource) {
+        const JSONArray top_flooders_chart_data =
+            sampling::CreateSampledTopFloodersChartData(clients_logs, sample, resource);
+
+        return {h2({text("Top flooders (24h, %, estimated)")}),
+                SampleNote(sample),
+                TopFloodersChart(top_flooders_chart_data)};
+    }
+
+    std::vector<Node> ActivityHeatmapPanel(CompactLogSpan week_logs, time_t from) {
+        // Activity heatmap (minutes of the requested day)
+        const ActivityHeatmap activity_heatmap = utils::CountActivityHeatmap(week_logs, from);
+        const Node activity_heatmap_node = utils::CreateActivityHeatmapNode(activity_heatmap);
+
+        return {h2({text("Activity by minute (24h)")}), activity_heatmap_node};
+    }
+
+    std::vector<Node> RateAnomaliesPanel(const std::vector<RateAnomaly>& rate_anomalies) {
+        TableBuilder anomalies_table_builder("RateAnomalies");
+        anomalies_table_builder.SetIdColumn("id");
+        anomalies_table_builder.SetOrderBy("z_score", "DESC");
+        anomalies_table_builder.EnableAutoSave(false);
+        anomalies_table_builder.EnableRefreshButton(false);
+        anomalies_table_builder.EnableBookmarksButton(false);
+        anomalies_table_builder.EnableExportButton(true);
+
+        anomalies_table_builder.AddColumn({"minute", "MINUTE", 1, std::nullopt});
+        anomalies_table_builder.AddColumn({"kind", "KIND", 2, std::nullopt});
+        anomalies_table_builder.AddColumn({"key", "KEY", 3, std::nullopt});
+        anomalies_table_builder.AddColumn({"count", "COUNT", 4, std::nullopt});
+        anomalies_table_builder.AddColumn({"baseline", "BASELINE", 5, std::nullopt});
+        anomalies_table_builder.AddColumn({"z_score", "Z_SCORE", 6, std::nullopt});
+
+        for (const auto& anomaly : rate_anomalies) {
+            anomalies_table_builder.AddRow({utils::FormatLogTime(anomaly.minute),
+                                            anomaly.kind,
+                                            anomaly.key,
+                                            static_cast<double>(anomaly.count),
+                                            utils::TruncateDouble(anomaly.baseline, 2),
+                                            utils::TruncateDouble(anomaly.z_score, 1)});
+        }
+
+        const Node rate_anomalies_table_node =
+            Table({}, anomalies_table_builder.CreateTableProps());
+
+        return {h2({text("Rate anomalies (24h vs previous week)")}), rate_anomalies_table_node};
+    }
+} // namespace panels
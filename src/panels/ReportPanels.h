@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ctime>
+#include <memory_resource>
+#include <vector>
+
+#include "ast/Ast.hpp"
+#include "sampling/Sampling.h"
+#include "structures/CompactLog.h"
+#include "structures/DayUniques.h"
+#include "structures/RateAnomaly.h"
+
+// Панели отчета: заголовок и узлы UI, строятся независимо друг от друга.
+// resource - память под временные структуры панели (арена запроса); узлы UI в нее не попадают
+namespace panels {
+    using ast::Node;
+
+    // Сообщения сервера по дням за две недели и уникальные клиенты / IP. day_uniques
+    // пополняется эскизами дней, которых не было в свертках
+    std::vector<Node> ServerLogsPanel(CompactLogSpan week_logs, DailyUniques* day_uniques);
+
+    // То же по выборке: оценки с 95% интервалами на линиях и пометкой об объеме выборки.
+    // Уникальные значения выборка не оценивает - они берутся только из сверток
+    std::vector<Node> ServerLogsPanel(CompactLogSpan                    week_logs,
+                                      const sampling::StratifiedSample& sample,
+                                      const DailyUniques&               day_uniques);
+
+    // Счетчики и график предупреждений / ошибок / критических ошибок
+    std::vector<Node> ErrorsPanel(CompactLogSpan week_logs, time_t from, time_t to);
+
+    // Сессии подключений за сутки
+    std::vector<Node> ConnectionsPanel(
+        CompactLogSpan             week_logs,
+        time_t                     from,
+        time_t                     to,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    std::vector<Node> TopFloodersPanel(
+        CompactLogSpan             clients_logs,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Доли флудеров по выборке, интервалы - в подписях
+    std::vector<Node> TopFloodersPanel(
+        CompactLogSpan                    clients_logs,
+        const sampling::StratifiedSample& sample,
+        std::pmr::memory_resource*        resource = std::pmr::get_default_resource());
+
+    std::vector<Node> ActivityHeatmapPanel(CompactLogSpan week_logs, time_t from);
+
+    std::vector<Node> RateAnomaliesPanel(const std::vector<RateAnomaly>& rate_anomalies);
+} // namespace panels
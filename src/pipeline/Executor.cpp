@@ -0,0 +1,84 @@
+#include "Executor.h"
+
+#include <algorithm>
+
+#include "tracing/Tracer.h"
+
+namespace pipeline {
+    namespace {
+        constexpr size_t MAX_THREADS = 64;
+    } // namespace
+
+    Executor::Executor(size_t threads, size_t max_threads) {
+        threads      = std::clamp<size_t>(threads, 1, MAX_THREADS);
+        _max_threads = std::clamp<size_t>(max_threads, threads, MAX_THREADS);
+
+        _threads.reserve(_max_threads);
+        for (size_t i = 0; i < threads; ++i) {
+            _threads.emplace_back([this] { Run(); });
+        }
+    }
+
+    Executor::~Executor() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _ready.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+
+        // Поставленное после выхода последнего потока (из потоков других пулов)
+        while (true) {
+            std::function<void()> task;
+            {
+                std::lock_guard lock(_mutex);
+                if (_queue.empty())
+                    break;
+                task = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    void Executor::Post(std::coroutine_handle<> handle) {
+        // Дескриптор - один указатель и помещается в std::function без аллокации
+        Submit([handle] { handle.resume(); });
+    }
+
+    void Executor::Submit(std::function<void()> task) {
+        {
+            std::lock_guard lock(_mutex);
+            _queue.push_back(std::move(task));
+
+            // Задачи в очереди больше, чем свободных потоков: пул растет до предела
+            if (!_stopping && _queue.size() > _idle && _threads.size() < _max_threads) {
+                _threads.emplace_back([this] { Run(); });
+            }
+        }
+        _ready.notify_one();
+    }
+
+    void Executor::Run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(_mutex);
+                ++_idle;
+                _ready.wait(lock, [this] { return _stopping || !_queue.empty(); });
+                --_idle;
+                if (_queue.empty())
+                    return; // остановка, очередь разобрана
+
+                task = std::move(_queue.front());
+                _queue.pop_front();
+            }
+
+            tracing::Span span("Task", "pool");
+            task();
+        }
+    }
+} // namespace pipeline
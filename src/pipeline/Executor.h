@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pipeline {
+    // Пул потоков. co_await executor.Schedule() переносит продолжение корутины в очередь пула;
+    // Submit ставит в ту же очередь обычную задачу. С max_threads > threads пул растет: если
+    // свободных потоков нет, Submit добавляет поток (до max_threads). Так задачи, зависшие в
+    // блокирующем вызове, не останавливают очередь; добавленные потоки живут до разрушения
+    class Executor {
+    public:
+        explicit Executor(size_t threads, size_t max_threads = 0);
+
+        Executor(const Executor&)            = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        // Потоки дорабатывают очередь, включая задачи, поставленные во время остановки:
+        // корутина не теряется вместе со своим кадром, а отмененный отчет доходит до точки
+        // отмены и завершается. Новые потоки при остановке не добавляются
+        ~Executor();
+
+        [[nodiscard]] size_t Threads() const { return _threads.size(); }
+
+        void Post(std::coroutine_handle<> handle);
+
+        void Submit(std::function<void()> task);
+
+        auto Schedule() {
+            struct ScheduleAwaiter {
+                Executor* executor;
+
+                bool await_ready() const noexcept { return false; }
+                void await_suspend(std::coroutine_handle<> handle) { executor->Post(handle); }
+                void await_resume() const noexcept {}
+            };
+            return ScheduleAwaiter{this};
+        }
+
+    private:
+        std::mutex                          _mutex;
+        std::condition_variable             _ready;
+        std::deque<std::function<void()>> _queue;
+        std::vector<std::thread>          _threads;
+        size_t                            _max_threads = 0;
+        size_t                            _idle        = 0; // потоков ждут задачу
+        bool                              _stopping    = false;
+
+        void Run();
+    };
+} // namespace pipeline
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "pipeline/Executor.h"
+
+namespace pipeline {
+    // Блокирующий вызов хоста вне потоков конвейера: функция выполняется в пуле загрузки,
+    // ожидающая корутина продолжается в executor. Вызов можно начать заранее (Start) и
+    // дождаться позже; объект должен жить, пока вызов не завершится, - корутина дожидается
+    // каждого начатого вызова, в том числе при отмене
+    class HostCall {
+    public:
+        HostCall(Executor& pool, Executor& executor) : _pool(pool), _executor(executor) {}
+
+        HostCall(const HostCall&)            = delete;
+        HostCall& operator=(const HostCall&) = delete;
+
+        void Start(std::function<void()> call) {
+            _pool.Submit([this, call = std::move(call)] {
+                std::exception_ptr error;
+                try {
+                    call();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::coroutine_handle<> waiting;
+                Executor&               executor = _executor;
+                {
+                    std::lock_guard lock(_mutex);
+                    _error  = std::move(error);
+                    _done   = true;
+                    waiting = std::exchange(_waiting, nullptr);
+                }
+                // После _done корутина может освободить объект: дальше только локальные
+                if (waiting) {
+                    executor.Post(waiting);
+                }
+            });
+        }
+
+        // co_await call: исключение вызова пробрасывается в корутину
+        auto operator co_await() {
+            struct Awaiter {
+                HostCall* call;
+
+                bool await_ready() {
+                    std::lock_guard lock(call->_mutex);
+                    return call->_done;
+                }
+
+                bool await_suspend(std::coroutine_handle<> handle) {
+                    std::lock_guard lock(call->_mutex);
+                    if (call->_done)
+                        return false;
+                    call->_waiting = handle;
+                    return true;
+                }
+
+                void await_resume() {
+                    if (call->_error) {
+                        std::rethrow_exception(call->_error);
+                    }
+                }
+            };
+            return Awaiter{this};
+        }
+
+    private:
+        Executor& _pool;
+        Executor& _executor;
+
+        std::mutex              _mutex;
+        bool                    _done = false;
+        std::exception_ptr      _error;
+        std::coroutine_handle<> _waiting;
+    };
+} // namespace pipeline
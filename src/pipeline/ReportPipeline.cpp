@@ -0,0 +1,597 @@
+#include "ReportPipeline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#include "collapse/LogCollapser.h"
+#include "fetch/FetchScheduler.h"
+#include "filters/LogFilters.h"
+#include "panels/ReportPanels.h"
+#include "pipeline/HostCall.h"
+#include "pipeline/Task.h"
+#include "sampling/Sampling.h"
+#include "runtime/PluginRuntime.h"
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+#include "tracing/Tracer.h"
+#include "utils/Utils.h"
+
+using namespace ast;
+
+namespace pipeline {
+    namespace {
+        constexpr long   DEFAULT_TIMEOUT_MS = 60 * 1000;
+        constexpr size_t ROWS_PER_CHECK     = 1 << 16;
+        constexpr time_t SECONDS_PER_DAY    = 24 * 60 * 60;
+
+        // Точка отмены между шагами: продолжение уходит в очередь пула, чтобы долгий
+        // отчет не занимал поток, пока ждут другие запросы
+        Task<void> Checkpoint(ReportState& state, Executor& executor) {
+            state.Context().ThrowIfCancelled();
+            co_await executor.Schedule();
+            state.Context().ThrowIfCancelled();
+        }
+
+        // Сбой загрузки, как и раньше, не отменяет отчет: панель строится по тому, что есть.
+        // false - данные неполные
+        Task<bool> GuardedFetch(ReportState& state, Task<void> fetch) {
+            try {
+                co_await fetch;
+                co_return true;
+            } catch (const CancelledError&) {
+                throw;
+            } catch (const std::exception& e) {
+                state.Runtime().Logger().Log(logging::LogLevel::Error, "%s", e.what());
+                co_return false;
+            }
+        }
+
+        // GetLogs в пуле загрузки; корутина продолжается в executor после ответа хоста
+        Task<void> GetLogs(ReportState&                  state,
+                           Executor&                     executor,
+                           time_t                        from,
+                           time_t                        to,
+                           std::string                   type,
+                           std::string                   filter,
+                           std::vector<ReportServerLog>* logs) {
+            HostCall call(state.Runtime().FetchPool(), executor);
+            call.Start([&] {
+                tracing::Span span("GetLogs", "fetch");
+                span.SetArg("from", from);
+                state.Server().GetLogs(from, to, type, filter, logs);
+                span.SetArg("rows", static_cast<int64_t>(logs->size()));
+            });
+            co_await call;
+        }
+
+        // Панель считается без точек приостановки - спан целиком лежит в одном потоке
+        template <typename Build>
+        void BuildPanel(ReportState& state, ReportPanel panel, Build&& build) {
+            tracing::Span span(ReportPanelTitle(panel), "aggregate");
+            state.SetPanel(panel, build());
+        }
+
+        // Fetch: неделя для графиков; интервалы сразу идут в потоковый детектор всплесков
+        Task<void> FetchStage(ReportState& state, Executor& executor) {
+            co_await Checkpoint(state, executor);
+
+            const ReportInputs& inputs = state.Inputs();
+
+            // Строки интервала копируются в арену, вектор хоста освобождается сразу после.
+            // Интервалы приходят по порядку, но внутри интервала хост времени не упорядочивает:
+            // детектору строки подаются по возрастанию времени
+            auto add_shard = [&state](std::vector<ReportServerLog>&& logs) {
+                state.Context().ThrowIfCancelled();
+                state.fetched_rows += logs.size();
+
+                const size_t first = state.week_logs.Size();
+                state.week_logs.Append(logs);
+
+                const auto shard   = state.week_logs.Logs().subspan(first);
+                const auto by_time = [](const CompactLog& a, const CompactLog& b) {
+                    return a.time < b.time;
+                };
+                if (std::is_sorted(shard.begin(), shard.end(), by_time)) {
+                    for (const auto& log : shard) {
+                        state.rate_anomaly_detector.Add(log);
+                    }
+                    return;
+                }
+
+                std::vector<const CompactLog*> ordered;
+                ordered.reserve(shard.size());
+                for (const auto& log : shard) {
+                    ordered.push_back(&log);
+                }
+                std::stable_sort(ordered.begin(), ordered.end(), [&](auto a, auto b) {
+                    return by_time(*a, *b);
+                });
+                for (const CompactLog* log : ordered) {
+                    state.rate_anomaly_detector.Add(*log);
+                }
+            };
+
+            const fetch::FetchScheduler scheduler(
+                state.Server(), inputs.fetch_options, state.Runtime().FetchPool(), executor);
+            state.is_week_fetched = co_await GuardedFetch(
+                state, scheduler.Fetch(inputs.from_week_ago, inputs.to, "", "", add_shard));
+        }
+
+        // Свертки дней окна, уже посчитанные предыдущими отчетами
+        DailyUniques LoadRollups(DayCache& cache, const ReportInputs& inputs) {
+            DailyUniques day_uniques;
+
+            const time_t first_day = inputs.from_week_ago - inputs.from_week_ago % SECONDS_PER_DAY;
+            for (time_t day_from = first_day; day_from <= inputs.to; day_from += SECONDS_PER_DAY) {
+                const std::string day = utils::FormatLogTime(day_from).substr(0, 10);
+                if (const auto rollup = cache.FindRollup(day)) {
+                    day_uniques.emplace(day, *rollup);
+                }
+            }
+
+            return day_uniques;
+        }
+
+        // В кеш попадают только дни, целиком вошедшие в окно и уже закончившиеся
+        void StoreRollups(DayCache&           cache,
+                          const ReportInputs& inputs,
+                          const DailyUniques& day_uniques) {
+            const time_t now = std::time(nullptr);
+
+            for (const auto& [day, uniques] : day_uniques) {
+                const int64_t day_from = utils::ParseLogTimestamp(day + "T00:00:00Z");
+                const int64_t day_to   = day_from + SECONDS_PER_DAY - 1;
+
+                if (uniques.is_rollup || day_from < inputs.from_week_ago || day_to > inputs.to ||
+                    day_to >= now)
+                    continue;
+
+                cache.StoreRollup(day, uniques);
+            }
+        }
+
+        // Выборка включается, когда неделя больше бюджета строк или загрузка съела бюджет времени
+        bool ExceedsBudget(ReportState& state) {
+            const SamplingOptions& options = state.Inputs().sampling_options;
+            if (options.mode == SamplingMode::Off)
+                return false;
+
+            const auto elapsed = RequestContext::Clock::now() - state.Context().Started();
+            return state.week_logs.Size() > options.row_budget ||
+                   (options.time_budget_ms > 0 &&
+                    elapsed >= std::chrono::milliseconds(options.time_budget_ms));
+        }
+
+        // Один и тот же день дает одну и ту же выборку: повторный отчет не "прыгает"
+        uint64_t SampleSeed(const ReportInputs& inputs, uint64_t stream) {
+            return static_cast<uint64_t>(inputs.from) * 0x9E3779B97F4A7C15ULL + stream;
+        }
+
+        // Aggregate: панели по неделе, затем флудеры по отдельной выборке клиентов
+        Task<void> PanelsStage(ReportState& state, Executor& executor) {
+            const ReportInputs&    inputs           = state.Inputs();
+            const SamplingOptions& sampling_options = inputs.sampling_options;
+
+            state.is_sampled = ExceedsBudget(state);
+
+            const CompactLogSpan       week_logs = state.week_logs.Logs();
+            std::pmr::memory_resource* arena     = state.arena.Resource();
+
+            co_await Checkpoint(state, executor);
+            DailyUniques day_uniques = LoadRollups(state.Runtime().Cache(), inputs);
+
+            if (state.is_sampled) {
+                const sampling::StratifiedSample week_sample(week_logs,
+                                                             sampling_options.mode,
+                                                             sampling_options.sample_rows,
+                                                             SampleSeed(inputs, 0));
+                BuildPanel(state, ReportPanel::ServerLogs, [&] {
+                    return panels::ServerLogsPanel(week_logs, week_sample, day_uniques);
+                });
+            } else {
+                BuildPanel(state, ReportPanel::ServerLogs, [&] {
+                    return panels::ServerLogsPanel(week_logs, &day_uniques);
+                });
+
+                // Неполная неделя дала бы заниженные свертки
+                if (state.is_week_fetched) {
+                    StoreRollups(state.Runtime().Cache(), inputs, day_uniques);
+                }
+            }
+
+            co_await Checkpoint(state, executor);
+            BuildPanel(state, ReportPanel::Errors, [&] {
+                return panels::ErrorsPanel(week_logs, inputs.from, inputs.to);
+            });
+
+            co_await Checkpoint(state, executor);
+            BuildPanel(state, ReportPanel::Connections, [&] {
+                return panels::ConnectionsPanel(week_logs, inputs.from, inputs.to, arena);
+            });
+
+            co_await Checkpoint(state, executor);
+            BuildPanel(state, ReportPanel::ActivityHeatmap, [&] {
+                return panels::ActivityHeatmapPanel(week_logs, inputs.from);
+            });
+
+            co_await Checkpoint(state, executor);
+            BuildPanel(state, ReportPanel::RateAnomalies, [&] {
+                return panels::RateAnomaliesPanel(state.rate_anomaly_detector.Finish());
+            });
+
+            co_await Checkpoint(state, executor);
+            co_await GuardedFetch(state,
+                                  GetLogs(state,
+                                          executor,
+                                          inputs.from,
+                                          inputs.to,
+                                          "CLIENT",
+                                          "",
+                                          &state.clients_logs));
+            state.fetched_rows += state.clients_logs.size();
+            state.clients_view.AppendView(state.clients_logs);
+            const CompactLogSpan clients_logs = state.clients_view.Logs();
+
+            co_await Checkpoint(state, executor);
+            if (state.is_sampled) {
+                const sampling::StratifiedSample clients_sample(clients_logs,
+                                                                sampling_options.mode,
+                                                                sampling_options.sample_rows,
+                                                                SampleSeed(inputs, 1));
+                BuildPanel(state, ReportPanel::TopFlooders, [&] {
+                    return panels::TopFloodersPanel(clients_logs, clients_sample, arena);
+                });
+            } else {
+                BuildPanel(state, ReportPanel::TopFlooders, [&] {
+                    return panels::TopFloodersPanel(clients_logs, arena);
+                });
+            }
+        }
+
+        // Table: день из кеша либо с сервера с переносом фильтров в GetLogs
+        Task<void> TableStage(ReportState& state, Executor& executor) {
+            const ReportInputs&     inputs         = state.Inputs();
+            runtime::PluginRuntime& plugin_runtime = state.Runtime();
+
+            co_await Checkpoint(state, executor);
+
+            // Загруженный ранее день отвечает на повторные поиски без обращения к серверу
+            state.today_slice = plugin_runtime.Cache().Find(inputs.from, inputs.to);
+            plugin_runtime.ReportMetrics().DayCacheLookup(state.today_slice != nullptr).Add();
+
+            const LogQuery& query = inputs.table_query;
+
+            if (state.today_slice == nullptr && inputs.table_filters.empty()) {
+                std::vector<ReportServerLog> day_logs;
+                if (co_await GuardedFetch(
+                        state,
+                        GetLogs(state, executor, inputs.from, inputs.to, "", "", &day_logs))) {
+                    state.fetched_rows += day_logs.size();
+                    state.today_slice =
+                        plugin_runtime.Cache().Store(inputs.from, inputs.to, std::move(day_logs));
+                }
+            } else if (state.today_slice == nullptr && query.from <= query.to) {
+                if (co_await GuardedFetch(state,
+                                          GetLogs(state,
+                                                  executor,
+                                                  query.from,
+                                                  query.to,
+                                                  query.type,
+                                                  query.filter,
+                                                  &state.today_logs))) {
+                    state.fetched_rows += state.today_logs.size();
+                }
+            }
+
+            co_await Checkpoint(state, executor);
+
+            // Main table: список строк - в арене запроса, значения переносятся в ответ
+            std::pmr::memory_resource* arena = state.arena.Resource();
+            TableBuilder               table_builder("DailyLogsReport", arena);
+
+            // Main table props
+            table_builder.SetIdColumn("id");
+            table_builder.SetOrderBy("id", "DESC");
+            table_builder.EnableAutoSave(false);
+            table_builder.EnableRefreshButton(false);
+            table_builder.EnableBookmarksButton(false);
+            table_builder.EnableExportButton(true);
+
+            // Compact payload: словари для повторяющихся колонок, время - UNIX-секунды дельтами
+            const bool is_compact_payload = inputs.is_compact_payload;
+            if (is_compact_payload) {
+                table_builder.SetPayloadFormat(TablePayload::Compact);
+            }
+
+            // Filters
+            FilterConfig search_filter;
+            search_filter.type = FilterType::Search;
+
+            FilterConfig date_time_filter;
+            date_time_filter.type = FilterType::DateTime;
+
+            table_builder.AddColumn(
+                {"time", "TIME", 1, date_time_filter, true, true, ColumnEncoding::Delta});
+            table_builder.AddColumn({"actor_id", "ACTOR_ID", 2, search_filter});
+            table_builder.AddColumn({"actor_type", "ACTOR_TYPE", 3, search_filter});
+            table_builder.AddColumn({"action", "ACTION", 4, search_filter});
+            table_builder.AddColumn({"status", "STATUS", 5, search_filter});
+            table_builder.AddColumn({"source", "SOURCE", 6, search_filter});
+            table_builder.AddColumn({"detail", "DETAIL", 7, search_filter});
+
+            // Collapse: повторы строки сворачиваются в одну с count / first_seen / last_seen
+            const CollapseOptions& collapse_options = inputs.collapse_options;
+
+            if (collapse_options.enabled) {
+                table_builder.AddColumn({"count", "COUNT", 8, std::nullopt});
+                table_builder.AddColumn({"first_seen",
+                                         "FIRST_SEEN",
+                                         9,
+                                         std::nullopt,
+                                         true,
+                                         true,
+                                         ColumnEncoding::Delta});
+                table_builder.AddColumn({"last_seen",
+                                         "LAST_SEEN",
+                                         10,
+                                         std::nullopt,
+                                         true,
+                                         true,
+                                         ColumnEncoding::Delta});
+            }
+
+            auto time_value = [is_compact_payload](const int64_t timestamp) {
+                return is_compact_payload ? JSONValue(static_cast<double>(timestamp))
+                                          : JSONValue(utils::FormatLogTime(timestamp));
+            };
+
+            // Время строки разобрано при загрузке; исходный текст нужен только для rows
+            auto log_time_value = [&time_value, is_compact_payload](int64_t          time,
+                                                                    std::string_view text) {
+                return is_compact_payload ? time_value(time)
+                                          : JSONValue(utils::NormalizeLogTime(text));
+            };
+
+            collapse::LogCollapser collapser(collapse_options, [&](CollapsedLog&& collapsed) {
+                const ReportServerLog& log = collapsed.log;
+
+                table_builder.EmplaceRow(
+                    log_time_value(utils::ParseLogTimestamp(log.time), log.time),
+                    log.actor_id,
+                    log.actor_type,
+                    log.action,
+                    log.status,
+                    log.source,
+                    log.detail,
+                    static_cast<double>(collapsed.count),
+                    time_value(collapsed.first_seen),
+                    time_value(collapsed.last_seen));
+            });
+
+            auto add_table_row = [&](const CompactLog& log) {
+                if (collapse_options.enabled) {
+                    collapser.Add(log);
+                    return;
+                }
+
+                table_builder.EmplaceRow(log_time_value(log.time, log.time_text),
+                                         log.actor_id,
+                                         log.actor_type,
+                                         log.action,
+                                         log.status,
+                                         log.source,
+                                         log.detail);
+            };
+
+            // Degraded: в таблицу идет равномерная выборка строк дня (до свертки повторов),
+            // в исходном порядке. Кандидат - номер строки в потоке и сама строка
+            const bool is_sampled = state.is_sampled;
+            size_t     rows       = 0;
+
+            sampling::ReservoirSampler reservoir(inputs.sampling_options.table_rows,
+                                                 SampleSeed(inputs, 2));
+            std::pmr::vector<std::pair<uint64_t, const CompactLog*>> reservoir_rows(arena);
+
+            auto add_log_row = [&](const CompactLog& log) {
+                // Построение большой таблицы тоже прерывается по дедлайну
+                if (++rows % ROWS_PER_CHECK == 0) {
+                    state.Context().ThrowIfCancelled();
+                }
+
+                if (!is_sampled) {
+                    add_table_row(log);
+                    return;
+                }
+
+                const size_t slot = reservoir.Offer();
+                if (slot == sampling::ReservoirSampler::npos)
+                    return;
+
+                const auto candidate = std::make_pair(reservoir.Seen() - 1, &log);
+                if (slot < reservoir_rows.size()) {
+                    reservoir_rows[slot] = candidate;
+                } else {
+                    reservoir_rows.push_back(candidate);
+                }
+            };
+
+            {
+                tracing::Span span("TableRows", "table");
+
+                if (state.today_slice != nullptr) {
+                    const LogSlice&            slice = *state.today_slice;
+                    const filters::TokenIndex* index =
+                        inputs.table_filters.empty() ? nullptr : &slice.Index();
+                    const filters::Bitmap selected =
+                        filters::SelectLogs(slice.Columns(), index, inputs.table_filters);
+
+                    const CompactLogSpan       logs  = slice.Compact();
+
+                    selected.ForEach([&](size_t row) { add_log_row(logs[row]); });
+                } else {
+                    filters::ApplyLogFilters(state.today_logs, inputs.table_query.residual);
+                    state.today_view.AppendView(state.today_logs);
+
+                    for (const auto& today_log : state.today_view.Logs()) {
+                        add_log_row(today_log);
+                    }
+                }
+
+                std::sort(reservoir_rows.begin(), reservoir_rows.end());
+                for (const auto& [sequence, log] : reservoir_rows) {
+                    add_table_row(*log);
+                }
+
+                collapser.Flush();
+                span.SetArg("rows", static_cast<int64_t>(rows));
+            }
+
+            co_await Checkpoint(state, executor);
+
+            // Выборка помечается в заголовке, только если строк больше емкости резервуара
+            std::string title = "All Logs";
+            if (is_sampled && reservoir.Seen() > reservoir.Capacity()) {
+                title += " (random sample of " + std::to_string(reservoir_rows.size()) + " of " +
+                         std::to_string(reservoir.Seen()) + " rows)";
+            }
+
+            // Таблица - самая большая панель: узлы собираются переносом, без копий списка
+            std::vector<Node> all_logs_nodes;
+            all_logs_nodes.reserve(2);
+            all_logs_nodes.push_back(h2({text(title)}));
+            {
+                tracing::Span span("CreateTableProps", "table");
+                all_logs_nodes.push_back(Table({}, std::move(table_builder).CreateTableProps()));
+            }
+            state.SetPanel(ReportPanel::AllLogs, std::move(all_logs_nodes));
+        }
+
+        // Длительность завершенной стадии; started переносится на ее конец
+        void ObservePhase(ReportState&                       state,
+                          metrics::ReportPhase               phase,
+                          RequestContext::Clock::time_point* started) {
+            const auto now = RequestContext::Clock::now();
+            state.Runtime()
+                .ReportMetrics()
+                .Phase(phase)
+                .Observe(std::chrono::duration<double>(now - *started).count());
+            *started = now;
+        }
+
+        DetachedTask RunReport(std::shared_ptr<ReportState> state, Executor& executor) {
+            co_await executor.Schedule();
+
+            try {
+                auto started = RequestContext::Clock::now();
+                co_await FetchStage(*state, executor);
+                ObservePhase(*state, metrics::ReportPhase::Fetch, &started);
+
+                co_await PanelsStage(*state, executor);
+                ObservePhase(*state, metrics::ReportPhase::Aggregate, &started);
+
+                co_await TableStage(*state, executor);
+                ObservePhase(*state, metrics::ReportPhase::Table, &started);
+            } catch (const CancelledError&) {
+                // Готовые к этому моменту панели уже опубликованы
+            } catch (const std::exception& e) {
+                state->Runtime().Logger().Log(logging::LogLevel::Error, "%s", e.what());
+            }
+
+            // Включая отмененные отчеты: загруженное до отмены тоже нагружало хост
+            state->Runtime().ReportMetrics().FetchedRows().Observe(
+                static_cast<double>(state->fetched_rows));
+
+            state->Finish();
+        }
+    } // namespace
+
+    const char* ReportPanelTitle(ReportPanel panel) {
+        switch (panel) {
+            case ReportPanel::ServerLogs:
+                return "Server Messages";
+            case ReportPanel::Errors:
+                return "Errors";
+            case ReportPanel::Connections:
+                return "Connections";
+            case ReportPanel::TopFlooders:
+                return "Top flooders";
+            case ReportPanel::ActivityHeatmap:
+                return "Activity by minute";
+            case ReportPanel::RateAnomalies:
+                return "Rate anomalies";
+            case ReportPanel::AllLogs:
+                return "All Logs";
+        }
+        return "";
+    }
+
+    std::chrono::milliseconds ReportTimeout(const rapidjson::Value& request) {
+        if (request.HasMember("deadline_ms") && request["deadline_ms"].IsNumber()) {
+            return std::chrono::milliseconds(request["deadline_ms"].GetInt64());
+        }
+
+        const char* value = std::getenv("DAILY_LOGS_DEADLINE_MS");
+        if (value != nullptr && *value != '\0') {
+            const long timeout = std::strtol(value, nullptr, 10);
+            if (timeout > 0)
+                return std::chrono::milliseconds(timeout);
+        }
+
+        return std::chrono::milliseconds(DEFAULT_TIMEOUT_MS);
+    }
+
+    ReportState::ReportState(ReportInputs                      inputs,
+                             RequestContext::Clock::time_point deadline,
+                             runtime::PluginRuntime&           runtime)
+        : arena(runtime.Slabs()), rate_anomaly_detector(inputs.from, inputs.to),
+          _inputs(std::move(inputs)), _context(deadline), _server(_inputs.server, _context),
+          _runtime(runtime) {}
+
+    void ReportState::SetPanel(ReportPanel panel, std::vector<ast::Node> nodes) {
+        std::lock_guard lock(_mutex);
+        _panels[static_cast<size_t>(panel)] = std::move(nodes);
+    }
+
+    void ReportState::Finish() {
+        {
+            std::lock_guard lock(_mutex);
+            _finished = true;
+        }
+        _finished_condition.notify_all();
+    }
+
+    bool ReportState::WaitUntilDeadline() {
+        std::unique_lock lock(_mutex);
+        return _finished_condition.wait_until(
+            lock, _context.Deadline(), [this] { return _finished; });
+    }
+
+    bool ReportState::WaitUntilFinished(RequestContext::Clock::time_point deadline) {
+        std::unique_lock lock(_mutex);
+        return _finished_condition.wait_until(lock, deadline, [this] { return _finished; });
+    }
+
+    std::vector<ast::Node> ReportState::TakeCompletedPanels(std::vector<ReportPanel>* missing) {
+        std::lock_guard lock(_mutex);
+
+        std::vector<ast::Node> nodes;
+        for (size_t i = 0; i < _panels.size(); ++i) {
+            if (!_panels[i]) {
+                missing->push_back(static_cast<ReportPanel>(i));
+                continue;
+            }
+            nodes.insert(nodes.end(),
+                         std::make_move_iterator(_panels[i]->begin()),
+                         std::make_move_iterator(_panels[i]->end()));
+            _panels[i].reset();
+        }
+        return nodes;
+    }
+
+    void StartReport(std::shared_ptr<ReportState> state, Executor& executor) {
+        RunReport(std::move(state), executor);
+    }
+} // namespace pipeline
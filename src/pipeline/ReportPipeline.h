@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <rapidjson/document.h>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "anomalies/RateAnomalyDetector.h"
+#include "ast/Ast.hpp"
+#include "cache/DayCache.h"
+#include "memory/RequestArena.h"
+#include "pipeline/Executor.h"
+#include "pipeline/RequestContext.h"
+#include "pipeline/ServerGate.h"
+#include "records/CompactLogStore.h"
+#include "structures/CollapsedLog.h"
+#include "structures/FetchOptions.h"
+#include "structures/LogFilter.h"
+#include "structures/SamplingOptions.h"
+
+namespace runtime {
+    class PluginRuntime;
+} // namespace runtime
+
+namespace pipeline {
+    // Панели отчета в порядке вывода
+    enum class ReportPanel : uint8_t {
+        ServerLogs,
+        Errors,
+        Connections,
+        TopFlooders,
+        ActivityHeatmap,
+        RateAnomalies,
+        AllLogs,
+    };
+
+    inline constexpr size_t REPORT_PANELS_COUNT = 7;
+
+    const char* ReportPanelTitle(ReportPanel panel);
+
+    // Параметры запроса, скопированные до запуска: конвейер может пережить CreateReport
+    struct ReportInputs {
+        // server вызывается только через ReportState::Server(); server_proxy - обертка над
+        // ним (capture), живет вместе с конвейером
+        ReportServerInterface*                 server        = nullptr;
+        std::shared_ptr<ReportServerInterface> server_proxy;
+        time_t                                 from          = 0;
+        time_t                                 to            = 0;
+        time_t                                 from_week_ago = 0;
+        std::vector<LogFilter>                 table_filters;
+        LogQuery                               table_query;
+        bool                                   is_compact_payload = false;
+        CollapseOptions                        collapse_options;
+        FetchOptions                           fetch_options;
+        SamplingOptions                        sampling_options;
+    };
+
+    // Время на отчет: request["deadline_ms"], иначе DAILY_LOGS_DEADLINE_MS, иначе 60 с
+    std::chrono::milliseconds ReportTimeout(const rapidjson::Value& request);
+
+    // Общее состояние запроса. Готовые панели и признак завершения защищены мьютексом;
+    // промежуточные данные стадий используются только корутиной конвейера
+    class ReportState {
+    public:
+        ReportState(ReportInputs                      inputs,
+                    RequestContext::Clock::time_point deadline,
+                    runtime::PluginRuntime&           runtime);
+
+        ReportState(const ReportState&)            = delete;
+        ReportState& operator=(const ReportState&) = delete;
+
+        [[nodiscard]] const ReportInputs& Inputs() const { return _inputs; }
+        [[nodiscard]] RequestContext&     Context() { return _context; }
+
+        // Хост для стадий: GetLogs проверяет отмену и после Close не вызывается
+        [[nodiscard]] ServerGate& Server() { return _server; }
+
+        // Среда, запустившая отчет. Стадии обращаются к ней, а не к Instance(): отчет,
+        // переживший Shutdown, работает со своей средой, а не с новой
+        [[nodiscard]] runtime::PluginRuntime& Runtime() { return _runtime; }
+
+        void SetPanel(ReportPanel panel, std::vector<ast::Node> nodes);
+
+        void Finish();
+
+        // false - дедлайн наступил раньше завершения конвейера
+        bool WaitUntilDeadline();
+
+        // Для остановки плагина после Context().Cancel(); false - конвейер не завершился
+        // к deadline (ждет зависший GetLogs)
+        bool WaitUntilFinished(RequestContext::Clock::time_point deadline);
+
+        // Узлы готовых панелей в порядке вывода переносятся в ответ без копирования;
+        // missing - панели, которые не успели. Вызывается один раз
+        std::vector<ast::Node> TakeCompletedPanels(std::vector<ReportPanel>* missing);
+
+        // Временные структуры стадий; освобождается вместе с состоянием, куски остаются
+        // в кеше среды для следующего отчета. Объявлена первой - разрушается последней
+        memory::RequestArena arena;
+
+        // Данные стадий
+        records::CompactLogStore        week_logs;      // арена на каждый загруженный интервал
+        std::vector<ReportServerLog>    clients_logs;   // как отдал хост
+        records::CompactLogStore        clients_view;   // без копирования поверх clients_logs
+        std::vector<ReportServerLog>    today_logs;
+        records::CompactLogStore        today_view;     // без копирования поверх today_logs
+        std::shared_ptr<const LogSlice> today_slice;
+        anomalies::RateAnomalyDetector  rate_anomaly_detector;
+        bool                            is_week_fetched = false;
+        size_t                          fetched_rows    = 0; // строк, отданных хостом
+
+        // Неделя превысила бюджет: графики и флудеры - по выборке, таблица - резервуар.
+        // Читается и после дедлайна, поэтому атомарный
+        std::atomic<bool> is_sampled{false};
+
+    private:
+        ReportInputs            _inputs;
+        RequestContext          _context;
+        ServerGate              _server;
+        runtime::PluginRuntime& _runtime;
+
+        mutable std::mutex      _mutex;
+        std::condition_variable _finished_condition;
+        bool                    _finished = false;
+
+        std::array<std::optional<std::vector<ast::Node>>, REPORT_PANELS_COUNT> _panels;
+    };
+
+    // Запуск конвейера fetch -> panels -> table на executor. Стадии - корутины; между шагами
+    // проверяются дедлайн и отмена, готовые панели сразу публикуются в state. GetLogs
+    // выполняются в пуле загрузки: потоки executor не ждут хост
+    void StartReport(std::shared_ptr<ReportState> state, Executor& executor);
+} // namespace pipeline
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+namespace pipeline {
+    // Отмена запроса: стадии прекращают работу в ближайшей точке проверки
+    class CancelledError : public std::runtime_error {
+    public:
+        CancelledError() : std::runtime_error("request cancelled") {}
+    };
+
+    // Дедлайн и флаг кооперативной отмены одного запроса
+    class RequestContext {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit RequestContext(Clock::time_point deadline)
+            : _started(Clock::now()), _deadline(deadline) {}
+
+        [[nodiscard]] Clock::time_point Started() const { return _started; }
+        [[nodiscard]] Clock::time_point Deadline() const { return _deadline; }
+
+        void Cancel() { _cancelled.store(true, std::memory_order_relaxed); }
+
+        [[nodiscard]] bool IsCancelled() const {
+            return _cancelled.load(std::memory_order_relaxed) || Clock::now() >= _deadline;
+        }
+
+        void ThrowIfCancelled() const {
+            if (IsCancelled()) {
+                throw CancelledError();
+            }
+        }
+
+    private:
+        Clock::time_point _started;
+        Clock::time_point _deadline;
+        std::atomic<bool> _cancelled{false};
+    };
+} // namespace pipeline
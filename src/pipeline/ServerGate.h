@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "pipeline/RequestContext.h"
+
+namespace pipeline {
+    // Доступ конвейера к хосту. Хост гарантирует server только на время своего CreateReport,
+    // а конвейер может его пережить (дедлайн): после Close новые вызовы не начинаются.
+    // Перед каждым вызовом проверяется и отмена запроса. Начатый GetLogs не прерывается -
+    // он уже выполняется внутри хоста
+    class ServerGate {
+    public:
+        ServerGate(ReportServerInterface* server, const RequestContext& context)
+            : _server(server), _context(context) {}
+
+        ServerGate(const ServerGate&)            = delete;
+        ServerGate& operator=(const ServerGate&) = delete;
+
+        // CancelledError - запрос отменен или CreateReport уже вернул управление
+        int GetLogs(time_t                        from,
+                    time_t                        to,
+                    const std::string&            type,
+                    const std::string&            filter,
+                    std::vector<ReportServerLog>* logs) {
+            if (_closed.load(std::memory_order_acquire))
+                throw CancelledError();
+            _context.ThrowIfCancelled();
+
+            return _server->GetLogs(from, to, type, filter, logs);
+        }
+
+        // CreateReport возвращает управление: server больше не используется
+        void Close() { _closed.store(true, std::memory_order_release); }
+
+    private:
+        ReportServerInterface* _server;
+        const RequestContext&  _context;
+        std::atomic<bool>      _closed{false};
+    };
+} // namespace pipeline
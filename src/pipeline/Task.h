@@ -0,0 +1,158 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace pipeline {
+    // Ленивая корутина-стадия: запускается при co_await и по завершении возобновляет
+    // ожидающего (symmetric transfer, без роста стека)
+    template <typename T>
+    class Task {
+    public:
+        struct promise_type {
+            std::optional<T>        value;
+            std::exception_ptr      error;
+            std::coroutine_handle<> continuation;
+
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            auto final_suspend() noexcept {
+                struct FinalAwaiter {
+                    bool await_ready() noexcept { return false; }
+
+                    std::coroutine_handle<>
+                    await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                        const auto continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+
+            template <typename U>
+            void return_value(U&& result) {
+                value.emplace(std::forward<U>(result));
+            }
+
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+
+        Task(const Task&)            = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&&)      = delete;
+
+        ~Task() {
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+            _handle.promise().continuation = continuation;
+            return _handle;
+        }
+
+        T await_resume() {
+            if (_handle.promise().error) {
+                std::rethrow_exception(_handle.promise().error);
+            }
+            return std::move(*_handle.promise().value);
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    template <>
+    class Task<void> {
+    public:
+        struct promise_type {
+            std::exception_ptr      error;
+            std::coroutine_handle<> continuation;
+
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            auto final_suspend() noexcept {
+                struct FinalAwaiter {
+                    bool await_ready() noexcept { return false; }
+
+                    std::coroutine_handle<>
+                    await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                        const auto continuation = handle.promise().continuation;
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+                return FinalAwaiter{};
+            }
+
+            void return_void() {}
+
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        Task(Task&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+
+        Task(const Task&)            = delete;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&&)      = delete;
+
+        ~Task() {
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+            _handle.promise().continuation = continuation;
+            return _handle;
+        }
+
+        void await_resume() {
+            if (_handle.promise().error) {
+                std::rethrow_exception(_handle.promise().error);
+            }
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    // Корутина верхнего уровня, которую никто не ожидает: стартует сразу и сама освобождает
+    // кадр по завершении. Исключения должны обрабатываться внутри
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() noexcept { return {}; }
+
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+
+            void return_void() noexcept {}
+
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+} // namespace pipeline
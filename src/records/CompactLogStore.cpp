@@ -0,0 +1,93 @@
+#include "CompactLogStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/Utils.h"
+
+namespace records {
+    namespace {
+        // Рост емкости не меньше чем вдвое: store пополняется пачками, и резерв ровно под
+        // очередную пачку переносил бы все записи на каждом Append
+        void Grow(std::vector<CompactLog>& logs, size_t added) {
+            const size_t needed = logs.size() + added;
+            if (needed > logs.capacity()) {
+                logs.reserve(std::max(needed, 2 * logs.capacity()));
+            }
+        }
+
+        size_t PayloadBytes(const ReportServerLog& log) {
+            return log.time.size() + log.actor_type.size() + log.actor_id.size() +
+                   log.action.size() + log.status.size() + log.source.size() + log.detail.size();
+        }
+    } // namespace
+
+    void CompactLogStore::Append(std::span<const ReportServerLog> logs) {
+        if (logs.empty())
+            return;
+
+        // Размер арены известен заранее: одна аллокация на пачку вместо двух-трех на строку
+        size_t bytes = 0;
+        for (const auto& log : logs) {
+            bytes += PayloadBytes(log);
+        }
+
+        auto  arena  = std::make_unique_for_overwrite<char[]>(bytes == 0 ? 1 : bytes);
+        char* cursor = arena.get();
+
+        auto copy = [&cursor](const std::string& value) {
+            std::memcpy(cursor, value.data(), value.size());
+            const std::string_view view(cursor, value.size());
+            cursor += value.size();
+            return view;
+        };
+
+        Grow(_logs, logs.size());
+        for (const auto& log : logs) {
+            CompactLog compact;
+            compact.time_text  = copy(log.time);
+            compact.time       = utils::ParseLogTimestamp(compact.time_text);
+            compact.actor_type = copy(log.actor_type);
+            compact.actor_id   = copy(log.actor_id);
+            compact.action     = copy(log.action);
+            compact.status     = copy(log.status);
+            compact.source     = copy(log.source);
+            compact.detail     = copy(log.detail);
+
+            _logs.push_back(compact);
+        }
+
+        _arena_bytes += bytes;
+        _arenas.push_back(std::move(arena));
+    }
+
+    void CompactLogStore::AppendView(const std::vector<ReportServerLog>& logs) {
+        Grow(_logs, logs.size());
+        for (const auto& log : logs) {
+            _logs.push_back(ViewLog(log));
+        }
+    }
+
+    CompactLog ViewLog(const ReportServerLog& log) {
+        return {utils::ParseLogTimestamp(log.time),
+                log.time,
+                log.actor_type,
+                log.actor_id,
+                log.action,
+                log.status,
+                log.source,
+                log.detail};
+    }
+
+    ReportServerLog ToReportServerLog(const CompactLog& log) {
+        ReportServerLog result;
+        result.time       = log.time_text;
+        result.actor_type = log.actor_type;
+        result.actor_id   = log.actor_id;
+        result.action     = log.action;
+        result.status     = log.status;
+        result.source     = log.source;
+        result.detail     = log.detail;
+        return result;
+    }
+} // namespace records
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "structures/CompactLog.h"
+
+namespace records {
+    // Хранилище CompactLog: записи подряд в одном векторе, строки - в аренах по одной на
+    // загруженную пачку.
+    //
+    // Время жизни:
+    //  - Append копирует строки пачки в новую арену; пачку можно освободить сразу после вызова,
+    //    записи действительны, пока жив store (арены не перемещаются и при перемещении store);
+    //  - AppendView не копирует: записи ссылаются на строки logs (или log), которые должны
+    //    пережить store и не изменяться.
+    // Span из Logs() действителен до следующего Append / AppendView
+    class CompactLogStore {
+    public:
+        CompactLogStore() = default;
+
+        CompactLogStore(CompactLogStore&&)            = default;
+        CompactLogStore& operator=(CompactLogStore&&) = default;
+
+        CompactLogStore(const CompactLogStore&)            = delete;
+        CompactLogStore& operator=(const CompactLogStore&) = delete;
+
+        void Append(std::span<const ReportServerLog> logs);
+
+        void AppendView(const std::vector<ReportServerLog>& logs);
+
+        void AppendView(const CompactLog& log) { _logs.push_back(log); }
+
+        [[nodiscard]] CompactLogSpan Logs() const { return _logs; }
+        [[nodiscard]] size_t         Size() const { return _logs.size(); }
+        [[nodiscard]] bool           Empty() const { return _logs.empty(); }
+        [[nodiscard]] size_t         ArenaBytes() const { return _arena_bytes; }
+
+        void Reserve(size_t rows) { _logs.reserve(rows); }
+
+    private:
+        std::vector<std::unique_ptr<char[]>> _arenas;
+        std::vector<CompactLog>              _logs;
+        size_t                               _arena_bytes = 0;
+    };
+
+    // Запись без копирования строк: действительна, пока жив и не изменен log
+    CompactLog ViewLog(const ReportServerLog& log);
+
+    // Владеющая копия - для кода, который хранит строку дольше источника
+    ReportServerLog ToReportServerLog(const CompactLog& log);
+} // namespace records
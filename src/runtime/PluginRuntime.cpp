@@ -0,0 +1,140 @@
+#include "PluginRuntime.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include "fetch/FetchScheduler.h"
+#include "pipeline/ReportPipeline.h"
+#include "tracing/Tracer.h"
+
+namespace runtime {
+    namespace {
+        constexpr size_t DEFAULT_PIPELINE_THREADS = 4;
+        constexpr size_t MAX_PIPELINE_THREADS     = 64;
+
+        // Зависший GetLogs держит поток пула загрузки; пул растет, пока потоков не станет столько
+        constexpr size_t MAX_FETCH_THREADS = 64;
+
+        constexpr long DEFAULT_SHUTDOWN_TIMEOUT_MS = 10 * 1000;
+
+        size_t PipelineThreads() {
+            const char* value = std::getenv("DAILY_LOGS_PIPELINE_THREADS");
+            if (value == nullptr || *value == '\0')
+                return DEFAULT_PIPELINE_THREADS;
+
+            const long threads = std::strtol(value, nullptr, 10);
+            return threads > 0 ? std::min<size_t>(threads, MAX_PIPELINE_THREADS)
+                               : DEFAULT_PIPELINE_THREADS;
+        }
+
+        std::chrono::milliseconds ShutdownTimeout() {
+            const char* value = std::getenv("DAILY_LOGS_SHUTDOWN_TIMEOUT_MS");
+            if (value == nullptr || *value == '\0')
+                return std::chrono::milliseconds(DEFAULT_SHUTDOWN_TIMEOUT_MS);
+
+            const long timeout = std::strtol(value, nullptr, 10);
+            return std::chrono::milliseconds(timeout >= 0 ? timeout : DEFAULT_SHUTDOWN_TIMEOUT_MS);
+        }
+
+        std::mutex                     runtime_mutex;
+        std::unique_ptr<PluginRuntime> runtime_instance;
+    } // namespace
+
+    PluginRuntime::PluginRuntime()
+        : _logger(logging::LoggerOptionsFromEnvironment()), _report_metrics(_metrics),
+          _cache(DayCacheOptionsFromEnvironment()),
+          _slabs(std::make_shared<memory::SlabCache>()),
+          _fetch_pool(fetch::FetchOptionsFromEnvironment().concurrency, MAX_FETCH_THREADS),
+          _pipeline(PipelineThreads()) {
+        tracing::Start(tracing::TracePathFromEnvironment());
+
+        metrics::TextfileOptions textfile_options = metrics::TextfileOptionsFromEnvironment();
+        if (!textfile_options.path.empty()) {
+            _metrics_exporter = std::make_unique<metrics::TextfileExporter>(
+                _metrics, _logger, std::move(textfile_options));
+        }
+
+        capture::CaptureOptions capture_options = capture::CaptureOptionsFromEnvironment();
+        if (!capture_options.directory.empty()) {
+            _capture_writer = std::make_unique<capture::CaptureWriter>(
+                std::move(capture_options), _logger, _metrics);
+        }
+    }
+
+    PluginRuntime& PluginRuntime::Instance() {
+        std::lock_guard lock(runtime_mutex);
+        if (!runtime_instance) {
+            runtime_instance.reset(new PluginRuntime());
+        }
+        return *runtime_instance;
+    }
+
+    void PluginRuntime::Shutdown() {
+        PluginRuntime* runtime = nullptr;
+        {
+            std::lock_guard lock(runtime_mutex);
+            runtime = runtime_instance.get();
+        }
+        if (runtime == nullptr)
+            return;
+
+        // Без мьютекса: отменяемые стадии еще обращаются к Instance()
+        const bool is_finished =
+            runtime->FinishReports(std::chrono::steady_clock::now() + ShutdownTimeout());
+
+        std::unique_ptr<PluginRuntime> released;
+        {
+            std::lock_guard lock(runtime_mutex);
+            released = std::move(runtime_instance);
+        }
+
+        // Отчеты, которые еще ждут хост, дальше освобождают куски своих арен сами
+        released->_slabs->Release();
+
+        if (!is_finished) {
+            // Потоки пулов еще ждут хост и ссылаются на среду: она остается в памяти
+            released->Logger().Log(logging::LogLevel::Warning,
+                                   "DestroyReport: GetLogs still running after %lld ms, runtime "
+                                   "left alive; do not unload the plugin until the host returns",
+                                   static_cast<long long>(ShutdownTimeout().count()));
+            static_cast<void>(released.release());
+            return;
+        }
+
+        // Разрушение вне мьютекса: пулы дожидаются своих потоков
+        released.reset();
+
+        // Потоки пулов остановлены - их спаны уже не пополнятся
+        tracing::Stop();
+    }
+
+    void PluginRuntime::TrackReport(const std::shared_ptr<pipeline::ReportState>& state) {
+        std::lock_guard lock(_reports_mutex);
+
+        std::erase_if(_reports, [](const auto& report) { return report.expired(); });
+        _reports.push_back(state);
+    }
+
+    bool PluginRuntime::FinishReports(std::chrono::steady_clock::time_point deadline) {
+        std::vector<std::shared_ptr<pipeline::ReportState>> reports;
+        {
+            std::lock_guard lock(_reports_mutex);
+            for (const auto& report : _reports) {
+                if (auto state = report.lock()) {
+                    reports.push_back(std::move(state));
+                }
+            }
+            _reports.clear();
+        }
+
+        for (const auto& state : reports) {
+            state->Context().Cancel();
+        }
+        bool is_finished = true;
+        for (const auto& state : reports) {
+            is_finished = state->WaitUntilFinished(deadline) && is_finished;
+        }
+        return is_finished;
+    }
+} // namespace runtime
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cache/DayCache.h"
+#include "capture/CaptureWriter.h"
+#include "logging/AsyncLogger.h"
+#include "memory/RequestArena.h"
+#include "metrics/MetricsRegistry.h"
+#include "metrics/ReportMetrics.h"
+#include "metrics/TextfileExporter.h"
+#include "pipeline/Executor.h"
+
+namespace pipeline {
+    class ReportState;
+} // namespace pipeline
+
+namespace runtime {
+    // Состояние плагина между вызовами: пул конвейера отчетов, пул параллельной загрузки,
+    // кеш дней, кеш кусков арен, метрики и журнал. Создается при первом обращении;
+    // DestroyReport разбирает его через Shutdown, и следующий CreateReport начнет с чистой среды
+    class PluginRuntime {
+    public:
+        PluginRuntime(const PluginRuntime&)            = delete;
+        PluginRuntime& operator=(const PluginRuntime&) = delete;
+
+        static PluginRuntime& Instance();
+
+        // Отменяет отчеты, пережившие свой CreateReport, и ждет их (в том числе начатые GetLogs)
+        // не дольше DAILY_LOGS_SHUTDOWN_TIMEOUT_MS (по умолчанию 10 с), затем останавливает
+        // пулы и освобождает кеши. Куски арен освобождаются в любом случае. Повторный вызов
+        // ничего не делает.
+        //
+        // Если хост за это время не вернул GetLogs, среда не разрушается: она остается в
+        // памяти вместе с потоками, которые еще внутри хоста, и отчеты доработают с ней, когда
+        // хост ответит (новых GetLogs они не начнут). DestroyReport возвращается вовремя,
+        // следующий CreateReport создает новую среду. Библиотеку нельзя выгружать, пока хост
+        // не вернул эти вызовы - об этом в журнал пишется предупреждение
+        static void Shutdown();
+
+        // Корутины отчетов; DAILY_LOGS_PIPELINE_THREADS потоков (по умолчанию 4)
+        [[nodiscard]] pipeline::Executor& Pipeline() { return _pipeline; }
+
+        // Все GetLogs конвейера: корутина ждет ответа хоста приостановленной, не занимая поток
+        // Pipeline. DAILY_LOGS_FETCH_CONCURRENCY потоков; если все заняты (в том числе
+        // зависшими вызовами), пул растет до 64
+        [[nodiscard]] pipeline::Executor& FetchPool() { return _fetch_pool; }
+
+        [[nodiscard]] DayCache&                 Cache() { return _cache; }
+
+        // Куски арен отчетов (memory::RequestArena); арена держит кеш, пока жива
+        [[nodiscard]] const std::shared_ptr<memory::SlabCache>& Slabs() const { return _slabs; }
+
+        [[nodiscard]] metrics::MetricsRegistry& Metrics() { return _metrics; }
+
+        // Метрики отчета, разрешенные при создании среды
+        [[nodiscard]] metrics::ReportMetrics& ReportMetrics() { return _report_metrics; }
+
+        [[nodiscard]] logging::AsyncLogger&     Logger() { return _logger; }
+
+        // Запись отчетов для воспроизведения; nullptr без DAILY_LOGS_CAPTURE_DIR
+        [[nodiscard]] capture::CaptureWriter* Capture() { return _capture_writer.get(); }
+
+        // Конвейер может пережить CreateReport (дедлайн), а значит и хост: Shutdown отменит
+        // его и дождется завершения
+        void TrackReport(const std::shared_ptr<pipeline::ReportState>& state);
+
+    private:
+        PluginRuntime();
+
+        // false - не все отчеты завершились к deadline
+        bool FinishReports(std::chrono::steady_clock::time_point deadline);
+
+        logging::AsyncLogger     _logger;
+        metrics::MetricsRegistry _metrics;
+        metrics::ReportMetrics   _report_metrics;
+
+        // Выгрузка метрик для node_exporter; nullptr без DAILY_LOGS_METRICS_FILE.
+        // Разрушается после пулов - последний файл включает отмененные отчеты
+        std::unique_ptr<metrics::TextfileExporter> _metrics_exporter;
+
+        DayCache _cache;
+
+        std::shared_ptr<memory::SlabCache> _slabs;
+
+        // Разрушается после пулов: записи отчетов, завершенных при остановке, дописываются
+        std::unique_ptr<capture::CaptureWriter> _capture_writer;
+
+        std::mutex                                        _reports_mutex;
+        std::vector<std::weak_ptr<pipeline::ReportState>> _reports;
+
+        // Пулы объявлены последними: потоки останавливаются раньше, чем кеш, метрики и журнал
+        pipeline::Executor _fetch_pool;
+        pipeline::Executor _pipeline;
+    };
+} // namespace runtime
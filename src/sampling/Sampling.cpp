@@ -0,0 +1,373 @@
+#include "Sampling.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "utils/Utils.h"
+
+using namespace ast;
+
+namespace sampling {
+    namespace {
+        constexpr int64_t SECONDS_PER_HOUR = 60 * 60;
+        constexpr size_t MAX_STRATA         = 4096;
+        constexpr size_t MIN_STRATUM_SAMPLE = 2;
+        constexpr size_t MAX_SAMPLE_ROWS    = 50'000'000;
+        constexpr double MAX_BUDGET_MS      = 24.0 * 60 * 60 * 1000;
+        constexpr size_t TOP_FLOODERS       = 5;
+
+        long EnvironmentNumber(const char* name, long default_value) {
+            const char* value = std::getenv(name);
+            if (value == nullptr || *value == '\0')
+                return default_value;
+
+            char*      end    = nullptr;
+            const long number = std::strtol(value, &end, 10);
+            return *end == '\0' && number >= 0 ? number : default_value;
+        }
+
+        bool ParseCount(const rapidjson::Value& object,
+                        const char*             name,
+                        double                  min,
+                        double                  max,
+                        double*                 value) {
+            if (!object.HasMember(name))
+                return true;
+            if (!object[name].IsNumber())
+                return false;
+
+            *value = object[name].GetDouble();
+            return *value >= min && *value <= max;
+        }
+
+        int64_t HourOf(const CompactLog& log) {
+            return log.time < 0 ? -1 : log.time / SECONDS_PER_HOUR;
+        }
+
+        // Равномерное число из (0, 1): логарифм нуля недопустим в алгоритме L
+        double OpenUniform(std::mt19937_64& random) {
+            return (static_cast<double>(random() >> 11) + 0.5) * 0x1.0p-53;
+        }
+
+        // Алгоритм Флойда: k различных индексов из [0, n) за O(k)
+        std::vector<size_t> ChooseRows(size_t first, size_t n, size_t k, std::mt19937_64& random) {
+            std::vector<size_t> rows;
+            rows.reserve(k);
+
+            if (k == n) {
+                for (size_t i = 0; i < n; ++i) {
+                    rows.push_back(first + i);
+                }
+                return rows;
+            }
+
+            std::unordered_set<size_t> chosen;
+            chosen.reserve(k * 2);
+
+            for (size_t j = n - k; j < n; ++j) {
+                const size_t t = std::uniform_int_distribution<size_t>(0, j)(random);
+                chosen.insert(chosen.count(t) ? j : t);
+            }
+
+            for (const size_t row : chosen) {
+                rows.push_back(first + row);
+            }
+            std::sort(rows.begin(), rows.end());
+            return rows;
+        }
+
+        double RoundTo(double value, double scale) {
+            return std::round(value * scale) / scale;
+        }
+    } // namespace
+
+    bool ParseSamplingOptions(const rapidjson::Value& request, SamplingOptions* options) {
+        options->row_budget = static_cast<size_t>(
+            EnvironmentNumber("DAILY_LOGS_ROW_BUDGET", static_cast<long>(options->row_budget)));
+        options->time_budget_ms =
+            EnvironmentNumber("DAILY_LOGS_TIME_BUDGET_MS", options->time_budget_ms);
+
+        if (!request.HasMember("sampling"))
+            return true;
+
+        const rapidjson::Value& sampling_value = request["sampling"];
+        if (!sampling_value.IsObject())
+            return false;
+
+        if (sampling_value.HasMember("mode")) {
+            if (!sampling_value["mode"].IsString())
+                return false;
+
+            const std::string mode = sampling_value["mode"].GetString();
+            if (mode == "off") {
+                options->mode = SamplingMode::Off;
+            } else if (mode == "uniform") {
+                options->mode = SamplingMode::Uniform;
+            } else if (mode == "stratified") {
+                options->mode = SamplingMode::Stratified;
+            } else {
+                return false;
+            }
+        }
+
+        double row_budget     = static_cast<double>(options->row_budget);
+        double time_budget_ms = static_cast<double>(options->time_budget_ms);
+        double sample_rows    = static_cast<double>(options->sample_rows);
+        double table_rows     = static_cast<double>(options->table_rows);
+
+        if (!ParseCount(sampling_value, "row_budget", 0, 1e12, &row_budget) ||
+            !ParseCount(sampling_value, "time_budget_ms", 0, MAX_BUDGET_MS, &time_budget_ms) ||
+            !ParseCount(sampling_value, "sample_rows", 1, MAX_SAMPLE_ROWS, &sample_rows) ||
+            !ParseCount(sampling_value, "table_rows", 1, MAX_SAMPLE_ROWS, &table_rows))
+            return false;
+
+        options->row_budget     = static_cast<size_t>(row_budget);
+        options->time_budget_ms = static_cast<int64_t>(time_budget_ms);
+        options->sample_rows    = static_cast<size_t>(sample_rows);
+        options->table_rows     = static_cast<size_t>(table_rows);
+        return true;
+    }
+
+    StratifiedSample::StratifiedSample(CompactLogSpan logs,
+                                       SamplingMode   mode,
+                                       size_t         sample_rows,
+                                       uint64_t       seed)
+        : _population(logs.size()) {
+        if (logs.empty())
+            return;
+
+        // Границы часовых страт: логи приходят упорядоченными, поэтому час - непрерывный отрезок
+        std::vector<size_t> bounds = {0};
+        if (mode == SamplingMode::Stratified) {
+            for (size_t i = 1; i < logs.size() && bounds.size() <= MAX_STRATA; ++i) {
+                if (HourOf(logs[i]) != HourOf(logs[i - 1])) {
+                    bounds.push_back(i);
+                }
+            }
+            // Неупорядоченный ввод дробится на слишком много отрезков - одна общая страта
+            if (bounds.size() > MAX_STRATA) {
+                bounds = {0};
+            }
+        }
+        bounds.push_back(logs.size());
+
+        std::mt19937_64 random(seed);
+        const double    fraction = std::min(1.0, static_cast<double>(sample_rows) / _population);
+
+        _strata.reserve(bounds.size() - 1);
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            const size_t population = bounds[i + 1] - bounds[i];
+            const size_t allocated  = static_cast<size_t>(std::llround(population * fraction));
+            const size_t rows       = std::min(
+                population, std::max(allocated, std::min(population, MIN_STRATUM_SAMPLE)));
+
+            Stratum stratum;
+            stratum.population = population;
+            stratum.rows       = ChooseRows(bounds[i], population, rows, random);
+
+            _sampled_rows += rows;
+            _strata.push_back(std::move(stratum));
+        }
+    }
+
+    double StratumVariance(double population, double sampled, double sum, double sum_squares) {
+        if (sampled < 2 || sampled >= population)
+            return 0.0;
+
+        const double variance = std::max(0.0, (sum_squares - sum * sum / sampled) / (sampled - 1));
+        return population * population * (1.0 - sampled / population) * variance / sampled;
+    }
+
+    ReservoirSampler::ReservoirSampler(size_t capacity, uint64_t seed)
+        : _capacity(std::max<size_t>(capacity, 1)), _random(seed) {
+        _weight = std::exp(std::log(OpenUniform(_random)) / _capacity);
+        _next   = _capacity;
+        AdvanceSkip();
+    }
+
+    void ReservoirSampler::AdvanceSkip() {
+        // Число пропускаемых строк до следующей замены распределено геометрически
+        const double skip = std::floor(std::log(OpenUniform(_random)) / std::log1p(-_weight));
+        _next += skip < 1e18 ? static_cast<uint64_t>(skip) : static_cast<uint64_t>(1e18);
+    }
+
+    size_t ReservoirSampler::Offer() {
+        const uint64_t index = _seen++;
+        if (index < _capacity)
+            return index;
+        if (index != _next)
+            return npos;
+
+        const size_t slot = std::uniform_int_distribution<size_t>(0, _capacity - 1)(_random);
+        _weight *= std::exp(std::log(OpenUniform(_random)) / _capacity);
+        _next = index + 1;
+        AdvanceSkip();
+        return slot;
+    }
+
+    JSONArray CreateSampledServerLogsChartData(CompactLogSpan          logs,
+                                               const StratifiedSample& sample) {
+        static const std::array<const char*, 4> keys = {"client", "manager", "system", "total"};
+
+        struct DayEstimate {
+            std::array<double, 4> value{};
+            std::array<double, 4> variance{};
+        };
+        std::map<std::string, DayEstimate> estimates;
+
+        for (const auto& stratum : sample.Strata()) {
+            const double population = static_cast<double>(stratum.population);
+            const double sampled    = static_cast<double>(stratum.rows.size());
+
+            // Счетчики выборки страты по дням; индикатор категории - 0/1, так что сумма
+            // квадратов совпадает с суммой
+            std::map<std::string, std::array<double, 4>> counts;
+            for (const size_t row : stratum.rows) {
+                const CompactLog& log   = logs[row];
+                auto&             point = counts[utils::ExtractDate(log.time_text)];
+
+                if (log.actor_type == "CLIENT") {
+                    point[0]++;
+                } else if (log.actor_type == "MANAGER") {
+                    point[1]++;
+                } else if (log.actor_type == "SYSTEM") {
+                    point[2]++;
+                }
+                point[3]++;
+            }
+
+            for (const auto& [day, point] : counts) {
+                auto& estimate = estimates[day];
+                for (size_t k = 0; k < keys.size(); ++k) {
+                    estimate.value[k] += population / sampled * point[k];
+                    estimate.variance[k] +=
+                        StratumVariance(population, sampled, point[k], point[k]);
+                }
+            }
+        }
+
+        JSONArray chart_data;
+        for (const auto& [day, estimate] : estimates) {
+            JSONObject row;
+            row["day"] = JSONValue(day);
+
+            for (size_t k = 0; k < keys.size(); ++k) {
+                const std::string key    = keys[k];
+                const double      margin = CONFIDENCE_Z * std::sqrt(estimate.variance[k]);
+
+                row[key]         = JSONValue(std::round(estimate.value[k]));
+                row[key + "_ci"] = JSONValue(std::round(margin));
+            }
+
+            chart_data.emplace_back(row);
+        }
+
+        return chart_data;
+    }
+
+    JSONArray CreateSampledTopFloodersChartData(CompactLogSpan             logs,
+                                                const StratifiedSample&    sample,
+                                                std::pmr::memory_resource* resource) {
+        // Оценка числа сообщений каждого IP: вес строки страты - N_h / n_h
+        std::pmr::unordered_map<std::string_view, double> ip_estimates(resource);
+        double                                            total = 0.0;
+
+        for (const auto& stratum : sample.Strata()) {
+            const double weight =
+                static_cast<double>(stratum.population) / static_cast<double>(stratum.rows.size());
+
+            for (const size_t row : stratum.rows) {
+                if (utils::IsValidIpAddress(logs[row].source)) {
+                    ip_estimates[logs[row].source] += weight;
+                    total += weight;
+                }
+            }
+        }
+
+        if (ip_estimates.empty()) {
+            JSONArray empty;
+
+            JSONObject other_item;
+            other_item["label"] = "No data";
+            other_item["value"] = 100.0;
+
+            empty.emplace_back(other_item);
+            return empty;
+        }
+
+        std::pmr::vector<std::pair<std::string_view, double>> sorted_ips(
+            ip_estimates.begin(), ip_estimates.end(), resource);
+        std::sort(sorted_ips.begin(), sorted_ips.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second;
+        });
+
+        // Доли топ-5 и "Other"; последний элемент - все остальные IP
+        const size_t        limit = std::min(sorted_ips.size(), TOP_FLOODERS);
+        std::vector<double> shares(limit + 1, 0.0);
+        std::vector<double> variances(limit + 1, 0.0);
+
+        std::unordered_map<std::string_view, size_t> top_index;
+
+        double top_share = 0.0;
+        for (size_t i = 0; i < limit; ++i) {
+            shares[i] = sorted_ips[i].second / total;
+            top_share += shares[i];
+            top_index.emplace(sorted_ips[i].first, i);
+        }
+        shares[limit] = std::max(0.0, 1.0 - top_share);
+
+        // Дисперсия доли p = Y / V линеаризацией: оценка суммы d = y - p * v, деленная на V
+        for (const auto& stratum : sample.Strata()) {
+            std::vector<double> counts(limit + 1, 0.0);
+            double              valid = 0.0;
+
+            for (const size_t row : stratum.rows) {
+                const std::string_view source = logs[row].source;
+                if (!utils::IsValidIpAddress(source))
+                    continue;
+
+                valid++;
+                const auto it = top_index.find(source);
+                counts[it == top_index.end() ? limit : it->second]++;
+            }
+
+            const double population = static_cast<double>(stratum.population);
+            const double sampled    = static_cast<double>(stratum.rows.size());
+
+            for (size_t i = 0; i <= limit; ++i) {
+                const double p           = shares[i];
+                const double sum         = counts[i] - p * valid;
+                const double sum_squares =
+                    counts[i] * (1 - p) * (1 - p) + (valid - counts[i]) * p * p;
+
+                variances[i] += StratumVariance(population, sampled, sum, sum_squares);
+            }
+        }
+
+        JSONArray result;
+        for (size_t i = 0; i <= limit; ++i) {
+            const double percent = RoundTo(shares[i] * 100.0, 100.0);
+            const double margin =
+                RoundTo(CONFIDENCE_Z * std::sqrt(variances[i]) / total * 100.0, 100.0);
+
+            std::ostringstream label;
+            label << (i < limit ? sorted_ips[i].first : std::string_view("Other")) << " (±"
+                  << margin << "%)";
+
+            JSONObject item;
+            item["label"] = label.str();
+            item["value"] = percent;
+
+            result.emplace_back(item);
+        }
+
+        return result;
+    }
+} // namespace sampling
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <rapidjson/document.h>
+#include <vector>
+
+#include "ast/Ast.hpp"
+#include "structures/CompactLog.h"
+#include "structures/SamplingOptions.h"
+
+namespace sampling {
+    // Квантиль нормального распределения для интервала 95%
+    inline constexpr double CONFIDENCE_Z = 1.96;
+
+    // Разбор request["sampling"]; false - некорректное значение.
+    // Бюджет строк по умолчанию переопределяется DAILY_LOGS_ROW_BUDGET
+    bool ParseSamplingOptions(const rapidjson::Value& request, SamplingOptions* options);
+
+    // Стратифицированная выборка строк без возвращения. Страты - непрерывные отрезки строк
+    // одного часа (логи приходят по времени); объем выборки распределяется пропорционально
+    // размеру страты, не меньше двух строк на страту для оценки дисперсии
+    class StratifiedSample {
+    public:
+        struct Stratum {
+            size_t              population = 0;
+            std::vector<size_t> rows; // индексы выбранных строк по возрастанию
+        };
+
+        StratifiedSample(CompactLogSpan logs,
+                         SamplingMode   mode,
+                         size_t         sample_rows,
+                         uint64_t       seed);
+
+        [[nodiscard]] const std::vector<Stratum>& Strata() const { return _strata; }
+        [[nodiscard]] size_t Population() const { return _population; }
+        [[nodiscard]] size_t SampledRows() const { return _sampled_rows; }
+        [[nodiscard]] bool   IsStratified() const { return _strata.size() > 1; }
+
+    private:
+        std::vector<Stratum> _strata;
+        size_t               _population   = 0;
+        size_t               _sampled_rows = 0;
+    };
+
+    // Вклад страты в дисперсию оценки суммы: N^2 (1 - n/N) s^2 / n
+    double StratumVariance(double population, double sampled, double sum, double sum_squares);
+
+    // Reservoir sampling (алгоритм L): Offer() возвращает слот для очередной строки либо npos.
+    // Номер следующей принятой строки разыгрывается заранее, так что пропуск стоит одного
+    // сравнения, а строка таблицы строится только для принятых кандидатов
+    class ReservoirSampler {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        ReservoirSampler(size_t capacity, uint64_t seed);
+
+        size_t Offer();
+
+        [[nodiscard]] uint64_t Seen() const { return _seen; }
+        [[nodiscard]] size_t   Capacity() const { return _capacity; }
+
+    private:
+        void AdvanceSkip();
+
+        size_t          _capacity;
+        uint64_t        _seen = 0;
+        uint64_t        _next = 0;
+        double          _weight = 0.0;
+        std::mt19937_64 _random;
+    };
+
+    // Оценка графика сообщений по дням с интервалами: поля client/manager/system/total и
+    // *_ci - половина ширины интервала
+    ast::JSONArray CreateSampledServerLogsChartData(CompactLogSpan          logs,
+                                                    const StratifiedSample& sample);
+
+    // Доли топ-5 источников (отношение оценок) с интервалами в подписи
+    ast::JSONArray CreateSampledTopFloodersChartData(
+        CompactLogSpan             logs,
+        const StratifiedSample&    sample,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+} // namespace sampling
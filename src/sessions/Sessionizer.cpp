@@ -0,0 +1,264 @@
+#include "Sessionizer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "classifiers/SeverityClassifier.h"
+#include "utils/Utils.h"
+
+namespace sessions {
+    namespace {
+        struct ConnectionKey {
+            std::string_view actor_id;
+            std::string_view source;
+
+            bool operator==(const ConnectionKey& other) const {
+                return actor_id == other.actor_id && source == other.source;
+            }
+        };
+
+        struct ConnectionKeyHash {
+            size_t operator()(const ConnectionKey& key) const {
+                const size_t h1 = std::hash<std::string_view>{}(key.actor_id);
+                const size_t h2 = std::hash<std::string_view>{}(key.source);
+                return h1 ^ (h2 + 0x9E3779B97F4A7C15ULL + (h1 << 6) + (h1 >> 2));
+            }
+        };
+
+        struct Event {
+            int64_t  time;
+            uint32_t row;
+            bool     connect;
+        };
+
+        // Граница интервала сессии: время и знак (+1 начало, -1 конец)
+        struct Endpoint {
+            int64_t time;
+            int     delta;
+        };
+    } // namespace
+
+    ConnectionEvent ClassifyConnectionAction(std::string_view action) {
+        static constexpr std::string_view connect_actions[] = {
+            "connect", "connected", "login", "logon", "auth", "session_start", "session_open"};
+        static constexpr std::string_view disconnect_actions[] = {"disconnect",
+                                                                  "disconnected",
+                                                                  "logout",
+                                                                  "logoff",
+                                                                  "session_end",
+                                                                  "session_close",
+                                                                  "session_closed"};
+
+        for (const auto token : connect_actions) {
+            if (classifiers::EqualsIgnoreCase(action, token))
+                return ConnectionEvent::Connect;
+        }
+        for (const auto token : disconnect_actions) {
+            if (classifiers::EqualsIgnoreCase(action, token))
+                return ConnectionEvent::Disconnect;
+        }
+        return ConnectionEvent::None;
+    }
+
+    int DetectConnectionType(std::string_view detail) {
+        static constexpr std::pair<std::string_view, int> keywords[] = {
+            {"desktop", CONNECTION_TYPE_CLIENT_DESKTOP},
+            {"winphone", CONNECTION_TYPE_CLIENT_WINPHONE},
+            {"iphone", CONNECTION_TYPE_CLIENT_IPHONE},
+            {"ios", CONNECTION_TYPE_CLIENT_IPHONE},
+            {"android", CONNECTION_TYPE_CLIENT_ANDROID},
+            {"blackberry", CONNECTION_TYPE_CLIENT_BLACKBERRY},
+            {"web", CONNECTION_TYPE_CLIENT_WEB},
+            {"webterminal", CONNECTION_TYPE_CLIENT_WEB},
+            {"rest", CONNECTION_TYPE_REST},
+            {"tcp", CONNECTION_TYPE_TCP},
+            {"fix", CONNECTION_TYPE_FIX}};
+
+        // Явное указание: connection_type=N, N - номер из ConnectionType целиком
+        constexpr std::string_view explicit_key = "connection_type=";
+        const size_t               explicit_pos = detail.find(explicit_key);
+        if (explicit_pos != std::string_view::npos) {
+            const char* begin = detail.data() + explicit_pos + explicit_key.size();
+            const char* end   = detail.data() + detail.size();
+
+            int        type   = -1;
+            const auto parsed = std::from_chars(begin, end, type);
+            if (parsed.ec == std::errc() && parsed.ptr != begin &&
+                (parsed.ptr == end || !std::isalnum(static_cast<unsigned char>(*parsed.ptr))) &&
+                type >= CONNECTION_TYPE_CLIENT_DESKTOP && type <= CONNECTION_TYPE_FIX) {
+                return type;
+            }
+        }
+
+        // Иначе - первое ключевое слово среди токенов detail
+        size_t i = 0;
+        while (i < detail.size()) {
+            while (i < detail.size() && !std::isalnum(static_cast<unsigned char>(detail[i]))) {
+                ++i;
+            }
+            const size_t begin = i;
+            while (i < detail.size() && std::isalnum(static_cast<unsigned char>(detail[i]))) {
+                ++i;
+            }
+
+            const std::string_view token = detail.substr(begin, i - begin);
+            for (const auto& [keyword, type] : keywords) {
+                if (classifiers::EqualsIgnoreCase(token, keyword))
+                    return type;
+            }
+        }
+
+        return -1;
+    }
+
+    int DetectSessionType(std::string_view actor_type) {
+        static constexpr std::pair<std::string_view, int> session_types[] = {
+            {"client", SESSION_USER},
+            {"user", SESSION_USER},
+            {"manager", SESSION_MANAGER},
+            {"dealer", SESSION_DEALER},
+            {"admin", SESSION_ADMIN},
+            {"system", SESSION_SYSTEM},
+            {"fix", SESSION_FIX},
+            {"customer", SESSION_CUSTOMER},
+            {"crm_manager", SESSION_CRM_MANAGER},
+            {"crm_admin", SESSION_CRM_ADMIN}};
+
+        for (const auto& [name, type] : session_types) {
+            if (classifiers::EqualsIgnoreCase(actor_type, name))
+                return type;
+        }
+        return -1;
+    }
+
+    ConnectionStats BuildConnectionStats(CompactLogSpan             logs_vector,
+                                         time_t                     from,
+                                         time_t                     to,
+                                         std::pmr::memory_resource* resource) {
+        ConnectionStats stats;
+
+        // Только события подключения - обычно малая доля журнала
+        std::pmr::vector<Event> events(resource);
+        for (size_t row = 0; row < logs_vector.size(); ++row) {
+            const ConnectionEvent event = ClassifyConnectionAction(logs_vector[row].action);
+            if (event == ConnectionEvent::None)
+                continue;
+
+            const int64_t time = logs_vector[row].time;
+            if (time < 0 || time > to)
+                continue;
+
+            events.push_back({time, static_cast<uint32_t>(row), event == ConnectionEvent::Connect});
+        }
+
+        std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.time < b.time;
+        });
+
+        std::pmr::vector<Endpoint>                endpoints(resource);
+        std::pmr::unordered_set<std::string_view> actors(resource);
+        double                                    closed_duration = 0.0;
+        uint64_t                                  closed_sessions = 0;
+
+        // Сессия [start, end], row - запись, по которой определяется тип
+        auto add_session = [&](int64_t start, int64_t end, uint32_t row, bool closed) {
+            if (end < from || start > to)
+                return;
+
+            const CompactLog& log = logs_vector[row];
+
+            stats.sessions++;
+            stats.by_connection_type[DetectConnectionType(log.detail)]++;
+            stats.by_session_type[DetectSessionType(log.actor_type)]++;
+            actors.insert(log.actor_id);
+
+            if (closed) {
+                closed_duration += static_cast<double>(end - start);
+                closed_sessions++;
+            } else {
+                stats.open_sessions++;
+            }
+
+            endpoints.push_back({std::max<int64_t>(start, from), +1});
+            endpoints.push_back({std::min<int64_t>(end, to), -1});
+        };
+
+        // Хеш-соединение: открытая сессия на каждую пару (actor_id, source)
+        std::pmr::unordered_map<ConnectionKey, Event, ConnectionKeyHash> open(resource);
+
+        for (const auto& event : events) {
+            const CompactLog&   log = logs_vector[event.row];
+            const ConnectionKey key{log.actor_id, log.source};
+
+            if (event.connect) {
+                const auto [it, inserted] = open.try_emplace(key, event);
+                if (!inserted) {
+                    // Повторное подключение без отключения закрывает предыдущую сессию
+                    add_session(it->second.time, event.time, it->second.row, true);
+                    it->second = event;
+                }
+                continue;
+            }
+
+            const auto it = open.find(key);
+            if (it == open.end()) {
+                // Начало сессии за пределами окна выборки
+                if (event.time >= from) {
+                    stats.orphan_disconnects++;
+                    add_session(from, event.time, event.row, true);
+                }
+                continue;
+            }
+
+            add_session(it->second.time, event.time, it->second.row, true);
+            open.erase(it);
+        }
+
+        for (const auto& [key, event] : open) {
+            add_session(event.time, to, event.row, false);
+        }
+
+        stats.unique_actors    = actors.size();
+        stats.average_duration = closed_sessions == 0 ? 0.0 : closed_duration / closed_sessions;
+
+        // Проход по отсортированным границам; при равном времени конец раньше начала,
+        // чтобы сессии "встык" не считались одновременными
+        std::sort(endpoints.begin(), endpoints.end(), [](const Endpoint& a, const Endpoint& b) {
+            return a.time != b.time ? a.time < b.time : a.delta < b.delta;
+        });
+
+        int64_t current = 0;
+        for (const auto& endpoint : endpoints) {
+            current += endpoint.delta;
+
+            const auto concurrent = static_cast<uint64_t>(std::max<int64_t>(current, 0));
+            const auto hour =
+                static_cast<size_t>(std::clamp<int64_t>((endpoint.time - from) / 3600, 0, 23));
+
+            if (endpoint.delta > 0 && concurrent > stats.peak_concurrent) {
+                stats.peak_concurrent = concurrent;
+                stats.peak_time       = static_cast<time_t>(endpoint.time);
+            }
+            stats.hourly_peak[hour] = std::max(stats.hourly_peak[hour], concurrent);
+        }
+
+        // Сессии, активные весь час без событий, переносятся из предыдущего часа
+        current = 0;
+        size_t next = 0;
+        for (size_t hour = 0; hour < 24; ++hour) {
+            const int64_t hour_start = from + static_cast<int64_t>(hour) * 3600;
+            while (next < endpoints.size() &&
+                   (endpoints[next].time < hour_start ||
+                    (endpoints[next].time == hour_start && endpoints[next].delta < 0))) {
+                current += endpoints[next++].delta;
+            }
+            const auto carried      = static_cast<uint64_t>(std::max<int64_t>(current, 0));
+            stats.hourly_peak[hour] = std::max(stats.hourly_peak[hour], carried);
+        }
+
+        return stats;
+    }
+} // namespace sessions
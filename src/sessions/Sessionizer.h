@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ctime>
+#include <memory_resource>
+#include <string_view>
+
+#include "structures/CompactLog.h"
+#include "structures/ConnectionStats.h"
+
+namespace sessions {
+    enum class ConnectionEvent { None, Connect, Disconnect };
+
+    ConnectionEvent ClassifyConnectionAction(std::string_view action);
+
+    // ConnectionType по тексту detail, -1 если тип не указан
+    int DetectConnectionType(std::string_view detail);
+
+    // SESSION_* по типу актора, -1 для неизвестного
+    int DetectSessionType(std::string_view actor_type);
+
+    // Склейка подключений и отключений по (actor_id, source) и подсчет пиковой
+    // одновременности за [from, to]. События до from открывают сессии, активные на начало суток.
+    // resource - память под события и открытые сессии (арена запроса)
+    ConnectionStats BuildConnectionStats(
+        CompactLogSpan             logs_vector,
+        time_t                     from,
+        time_t                     to,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+} // namespace sessions
@@ -0,0 +1,189 @@
+#include "HyperLogLog.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace sketches {
+    namespace {
+        constexpr uint32_t MAX_RANK    = 64 - HyperLogLog::PRECISION + 1;
+        constexpr uint32_t INDEX_SHIFT = 8; // запись разреженного списка: регистр << 8 | ранг
+        constexpr uint64_t FNV_OFFSET  = 14695981039346656037ULL;
+        constexpr uint64_t FNV_PRIME   = 1099511628211ULL;
+
+        // Оценка Ertl (2017) по гистограмме рангов заменяет таблицы поправок HLL++ и
+        // линейный подсчет: одна формула точна и на малых, и на больших множествах
+        double Sigma(double x) {
+            if (x == 1.0)
+                return std::numeric_limits<double>::infinity();
+
+            double y = 1.0;
+            double z = x;
+            for (;;) {
+                x *= x;
+                const double previous = z;
+                z += x * y;
+                y += y;
+                if (z == previous)
+                    return z;
+            }
+        }
+
+        double Tau(double x) {
+            if (x == 0.0 || x == 1.0)
+                return 0.0;
+
+            double y = 1.0;
+            double z = 1.0 - x;
+            for (;;) {
+                x = std::sqrt(x);
+                const double previous = z;
+                y *= 0.5;
+                z -= (1.0 - x) * (1.0 - x) * y;
+                if (z == previous)
+                    return z / 3.0;
+            }
+        }
+
+        double EstimateFromHistogram(const std::array<double, MAX_RANK + 1>& histogram) {
+            const double m = HyperLogLog::REGISTERS;
+
+            double z = m * Tau(1.0 - histogram[MAX_RANK] / m);
+            for (uint32_t rank = MAX_RANK - 1; rank >= 1; --rank) {
+                z = 0.5 * (z + histogram[rank]);
+            }
+            z += m * Sigma(histogram[0] / m);
+
+            return m * m / (2.0 * std::log(2.0) * z);
+        }
+
+        // Слияние отсортированных списков с сохранением максимального ранга регистра
+        std::vector<uint32_t> MergeSparse(const std::vector<uint32_t>& a,
+                                          const std::vector<uint32_t>& b) {
+            std::vector<uint32_t> merged;
+            merged.reserve(a.size() + b.size());
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged));
+
+            // При равном регистре последней идет запись с большим рангом
+            auto last = std::unique(merged.rbegin(), merged.rend(), [](uint32_t x, uint32_t y) {
+                return x >> INDEX_SHIFT == y >> INDEX_SHIFT;
+            });
+            merged.erase(merged.begin(), last.base());
+            return merged;
+        }
+    } // namespace
+
+    uint64_t HyperLogLog::Hash(std::string_view value) {
+        uint64_t hash = FNV_OFFSET;
+        for (const char symbol : value) {
+            hash = (hash ^ static_cast<unsigned char>(symbol)) * FNV_PRIME;
+        }
+
+        // Финализатор murmur3: регистр выбирается по старшим битам, а у FNV-1a они слабые
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    void HyperLogLog::AddHash(uint64_t hash) {
+        const auto index = static_cast<uint32_t>(hash >> (64 - PRECISION));
+        const auto rank  = static_cast<uint8_t>(
+            std::min<uint32_t>(std::countl_zero(hash << PRECISION) + 1, MAX_RANK));
+
+        if (!IsSparse()) {
+            _registers[index] = std::max(_registers[index], rank);
+            return;
+        }
+
+        _pending.push_back(Encode(index, rank));
+        if (_pending.size() >= MAX_PENDING) {
+            FlushPending();
+        }
+    }
+
+    void HyperLogLog::FlushPending() {
+        if (_pending.empty())
+            return;
+
+        std::sort(_pending.begin(), _pending.end());
+        _sparse = MergeSparse(_sparse, _pending);
+        _pending.clear();
+
+        if (_sparse.size() > MAX_SPARSE) {
+            ToDense();
+        }
+    }
+
+    void HyperLogLog::ToDense() {
+        _registers.assign(REGISTERS, 0);
+
+        for (const uint32_t entry : _sparse) {
+            _registers[entry >> RANK_BITS] = static_cast<uint8_t>(entry & 0xFF);
+        }
+        for (const uint32_t entry : _pending) {
+            uint8_t& rank = _registers[entry >> RANK_BITS];
+            rank          = std::max(rank, static_cast<uint8_t>(entry & 0xFF));
+        }
+
+        std::vector<uint32_t>().swap(_sparse);
+        std::vector<uint32_t>().swap(_pending);
+    }
+
+    void HyperLogLog::Merge(const HyperLogLog& other) {
+        if (IsSparse() && other.IsSparse()) {
+            _pending.insert(_pending.end(), other._sparse.begin(), other._sparse.end());
+            _pending.insert(_pending.end(), other._pending.begin(), other._pending.end());
+            FlushPending();
+            return;
+        }
+
+        if (IsSparse()) {
+            ToDense();
+        }
+
+        if (!other.IsSparse()) {
+            for (uint32_t i = 0; i < REGISTERS; ++i) {
+                _registers[i] = std::max(_registers[i], other._registers[i]);
+            }
+            return;
+        }
+
+        for (const auto* entries : {&other._sparse, &other._pending}) {
+            for (const uint32_t entry : *entries) {
+                uint8_t& rank = _registers[entry >> RANK_BITS];
+                rank          = std::max(rank, static_cast<uint8_t>(entry & 0xFF));
+            }
+        }
+    }
+
+    double HyperLogLog::Estimate() const {
+        std::array<double, MAX_RANK + 1> histogram{};
+
+        if (!IsSparse()) {
+            for (const uint8_t rank : _registers) {
+                histogram[rank]++;
+            }
+            return EstimateFromHistogram(histogram);
+        }
+
+        std::vector<uint32_t> pending = _pending;
+        std::sort(pending.begin(), pending.end());
+        const std::vector<uint32_t> entries = MergeSparse(_sparse, pending);
+
+        histogram[0] = static_cast<double>(REGISTERS - entries.size());
+        for (const uint32_t entry : entries) {
+            histogram[entry & 0xFF]++;
+        }
+        return EstimateFromHistogram(histogram);
+    }
+
+    size_t HyperLogLog::MemoryBytes() const {
+        return _registers.capacity() +
+               (_sparse.capacity() + _pending.capacity()) * sizeof(uint32_t);
+    }
+} // namespace sketches
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace sketches {
+    // HyperLogLog++ (p = 14, 64-битный хеш): оценка числа различных значений с относительной
+    // ошибкой ~0.8% в 16 КБ. Малые множества хранятся разреженно - отсортированным списком
+    // пар (регистр, ранг), поэтому день с сотней клиентов занимает сотни байт. Эскизы с
+    // одинаковой точностью объединяются покомпонентным максимумом без потери точности
+    class HyperLogLog {
+    public:
+        static constexpr uint32_t PRECISION = 14;
+        static constexpr uint32_t REGISTERS = 1U << PRECISION;
+
+        void Add(std::string_view value) { AddHash(Hash(value)); }
+
+        void AddHash(uint64_t hash);
+
+        // Объединение множеств: результат тот же, что при добавлении всех значений в один эскиз
+        void Merge(const HyperLogLog& other);
+
+        [[nodiscard]] double Estimate() const;
+
+        [[nodiscard]] bool   IsSparse() const { return _registers.empty(); }
+        [[nodiscard]] size_t MemoryBytes() const;
+
+        static uint64_t Hash(std::string_view value);
+
+    private:
+        static constexpr uint32_t RANK_BITS   = 8;
+        static constexpr size_t   MAX_SPARSE  = REGISTERS / 8; // с буфером не больше плотного
+        static constexpr size_t   MAX_PENDING = 1024;
+
+        static uint32_t Encode(uint32_t index, uint8_t rank) { return index << RANK_BITS | rank; }
+
+        void FlushPending();
+        void ToDense();
+
+        std::vector<uint8_t>  _registers; // плотное представление; пусто, пока разреженное
+        std::vector<uint32_t> _sparse;    // по возрастанию регистра, по одной записи на регистр
+        std::vector<uint32_t> _pending;   // новые записи до слияния с _sparse
+    };
+} // namespace sketches
@@ -0,0 +1,585 @@
+#include "LogSnapshot.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "snapshots/SnapshotFormat.h"
+
+static_assert(std::endian::native == std::endian::little, "snapshot layout is little-endian");
+
+namespace snapshots {
+    using namespace format;
+
+    namespace {
+        constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+        constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+        constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+        constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+        constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+        uint64_t Round(uint64_t accumulator, uint64_t input) {
+            accumulator += input * PRIME2;
+            accumulator = std::rotl(accumulator, 31);
+            return accumulator * PRIME1;
+        }
+
+        uint64_t MergeRound(uint64_t accumulator, uint64_t value) {
+            accumulator ^= Round(0, value);
+            return accumulator * PRIME1 + PRIME4;
+        }
+
+        template <typename Number>
+        Number Load(const unsigned char* data) {
+            Number value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+    } // namespace
+
+    uint64_t format::Checksum(const void* data, size_t size) {
+        const auto*       position = static_cast<const unsigned char*>(data);
+        const auto* const end      = position + size;
+
+        uint64_t hash = 0;
+        if (size >= 32) {
+            uint64_t lanes[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+            for (; position + 32 <= end; position += 32) {
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    lanes[lane] = Round(lanes[lane], Load<uint64_t>(position + lane * 8));
+                }
+            }
+
+            hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) +
+                   std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+            for (const uint64_t lane : lanes) {
+                hash = MergeRound(hash, lane);
+            }
+        } else {
+            hash = PRIME5;
+        }
+
+        hash += size;
+
+        for (; position + 8 <= end; position += 8) {
+            hash ^= Round(0, Load<uint64_t>(position));
+            hash = std::rotl(hash, 27) * PRIME1 + PRIME4;
+        }
+        if (position + 4 <= end) {
+            hash ^= Load<uint32_t>(position) * PRIME1;
+            hash = std::rotl(hash, 23) * PRIME2 + PRIME3;
+            position += 4;
+        }
+        for (; position < end; ++position) {
+            hash ^= *position * PRIME5;
+            hash = std::rotl(hash, 11) * PRIME1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= PRIME2;
+        hash ^= hash >> 29;
+        hash *= PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    namespace {
+        [[noreturn]] void Fail(const std::string& path, const std::string& reason) {
+            throw std::runtime_error("snapshot " + path + ": " + reason);
+        }
+
+        template <typename Number>
+        void AppendArray(std::string* section, const std::vector<Number>& values) {
+            section->append(reinterpret_cast<const char*>(values.data()),
+                            values.size() * sizeof(Number));
+        }
+
+        void PadSection(std::string* section) { section->resize(Align8(section->size()), '\0'); }
+    } // namespace
+
+    bool IsSnapshotFile(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+            return false;
+
+        char         magic[SNAPSHOT_MAGIC.size()];
+        const size_t read = std::fread(magic, 1, sizeof(magic), file);
+        std::fclose(file);
+        return read == sizeof(magic) && std::string_view(magic, read) == SNAPSHOT_MAGIC;
+    }
+
+    std::string_view FormatHostTime(int64_t time, char* buffer) {
+        const int64_t days    = time >= 0 ? time / 86400 : (time - 86399) / 86400;
+        const int64_t seconds = time - days * 86400;
+
+        // Дата по дням от 1970-01-01, пролептический григорианский календарь
+        const int64_t shifted     = days + 719468;
+        const int64_t era         = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+        const int64_t day_of_era  = shifted - era * 146097;
+        const int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+                                     day_of_era / 146096) /
+                                    365;
+        const int64_t day_of_year =
+            day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+        const int64_t month_index = (5 * day_of_year + 2) / 153;
+        const int64_t day         = day_of_year - (153 * month_index + 2) / 5 + 1;
+        const int64_t month       = month_index < 10 ? month_index + 3 : month_index - 9;
+        const int64_t year        = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+
+        if (year < 0 || year > 9999)
+            return {};
+
+        auto put = [buffer](size_t pos, int64_t value, size_t digits) {
+            for (size_t i = digits; i > 0; --i) {
+                buffer[pos + i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        };
+
+        put(0, year, 4);
+        buffer[4] = '-';
+        put(5, month, 2);
+        buffer[7] = '-';
+        put(8, day, 2);
+        buffer[10] = 'T';
+        put(11, seconds / 3600, 2);
+        buffer[13] = ':';
+        put(14, seconds / 60 % 60, 2);
+        buffer[16] = ':';
+        put(17, seconds % 60, 2);
+        buffer[19] = 'Z';
+        return {buffer, HOST_TIME_SIZE};
+    }
+
+    // SnapshotBlock
+
+    CompactLog SnapshotBlock::Log(size_t row) const {
+        CompactLog log;
+        log.time       = _times[row];
+        log.time_text  = TimeText(row);
+        log.actor_type = _actor_type.Value(row);
+        log.actor_id   = _actor_id.Value(row);
+        log.action     = _action.Value(row);
+        log.status     = _status.Value(row);
+        log.source     = _source.Value(row);
+        log.detail     = _detail.Value(row);
+        return log;
+    }
+
+    ReportServerLog SnapshotBlock::ToReportServerLog(size_t row) const {
+        char buffer[HOST_TIME_SIZE];
+
+        ReportServerLog log;
+        log.time       = HasTimeText() ? std::string(_time_text.Value(row))
+                                       : std::string(FormatHostTime(_times[row], buffer));
+        log.actor_type = _actor_type.Value(row);
+        log.actor_id   = _actor_id.Value(row);
+        log.action     = _action.Value(row);
+        log.status     = _status.Value(row);
+        log.source     = _source.Value(row);
+        log.detail     = _detail.Value(row);
+        return log;
+    }
+
+    // LogSnapshot
+
+    LogSnapshot LogSnapshot::Open(const std::string& path, bool is_verify) {
+        LogSnapshot snapshot;
+        snapshot._path = path;
+        snapshot.Map(is_verify);
+        return snapshot;
+    }
+
+    LogSnapshot::LogSnapshot(LogSnapshot&& other) noexcept { *this = std::move(other); }
+
+    LogSnapshot& LogSnapshot::operator=(LogSnapshot&& other) noexcept {
+        if (this != &other) {
+            Unmap();
+            // Отображение не перемещается, поэтому view блоков остаются действительными
+            _data            = std::exchange(other._data, nullptr);
+            _bytes           = std::exchange(other._bytes, 0);
+            _path            = std::move(other._path);
+            _rows            = other._rows;
+            _min_time        = other._min_time;
+            _max_time        = other._max_time;
+            _is_time_ordered = other._is_time_ordered;
+            _blocks          = std::move(other._blocks);
+            _stats           = other._stats;
+        }
+        return *this;
+    }
+
+    LogSnapshot::~LogSnapshot() { Unmap(); }
+
+    std::vector<ReportServerLog> LogSnapshot::ReadLogs() const {
+        std::vector<ReportServerLog> logs;
+        logs.reserve(_rows);
+
+        for (const SnapshotBlock& block : _blocks) {
+            for (size_t row = 0; row < block.Rows(); ++row) {
+                logs.push_back(block.ToReportServerLog(row));
+            }
+        }
+        return logs;
+    }
+
+    void LogSnapshot::Map(bool is_verify) {
+        const int descriptor = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor < 0)
+            Fail(_path, std::strerror(errno));
+
+        struct stat status {};
+        if (::fstat(descriptor, &status) != 0) {
+            const int error = errno;
+            ::close(descriptor);
+            Fail(_path, std::strerror(error));
+        }
+
+        _bytes = static_cast<size_t>(status.st_size);
+        if (_bytes < sizeof(FileHeader)) {
+            ::close(descriptor);
+            Fail(_path, "not a snapshot");
+        }
+
+        void* data = ::mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        const int error = errno;
+        ::close(descriptor);
+        if (data == MAP_FAILED)
+            Fail(_path, std::strerror(error));
+        _data = data;
+
+        const auto* base = static_cast<const char*>(_data);
+
+        FileHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        if (std::string_view(header.magic, sizeof(header.magic)) != SNAPSHOT_MAGIC)
+            Fail(_path, "not a snapshot");
+        if (header.version != SNAPSHOT_VERSION)
+            Fail(_path, "unsupported version " + std::to_string(header.version));
+        if (header.header_checksum != Checksum(base, offsetof(FileHeader, header_checksum)))
+            Fail(_path, "header checksum mismatch");
+
+        const uint64_t directory_bytes = header.blocks * sizeof(BlockEntry);
+        if (header.blocks > _bytes / sizeof(BlockEntry) ||
+            header.directory_offset > _bytes - directory_bytes)
+            Fail(_path, "directory is out of bounds");
+        if (header.directory_checksum != Checksum(base + header.directory_offset, directory_bytes))
+            Fail(_path, "directory checksum mismatch");
+
+        _rows            = header.rows;
+        _min_time        = header.min_time;
+        _max_time        = header.max_time;
+        _is_time_ordered = (header.flags & FLAG_TIME_ORDERED) != 0;
+        std::copy(std::begin(header.stats), std::end(header.stats), _stats.begin());
+
+        // Секция колонки: место в файле, кодировка и контрольная сумма
+        auto section = [&](const BlockEntry& block, SnapshotColumn column) {
+            const ColumnEntry& entry = block.columns[static_cast<size_t>(column)];
+            if (entry.encoding == Encoding::None && column == SnapshotColumn::TimeText)
+                return static_cast<const char*>(nullptr);
+
+            if (entry.encoding != COLUMN_ENCODINGS[static_cast<size_t>(column)] ||
+                entry.offset % 8 != 0 || entry.offset < sizeof(FileHeader) ||
+                entry.offset > _bytes || entry.bytes > _bytes - entry.offset)
+                Fail(_path, "column is out of bounds");
+            if (is_verify && entry.checksum != Checksum(base + entry.offset, entry.bytes))
+                Fail(_path, "column checksum mismatch");
+            return base + entry.offset;
+        };
+
+        auto strings = [&](const BlockEntry& block, SnapshotColumn column, SnapshotStrings* out) {
+            const char* data = section(block, column);
+            if (data == nullptr)
+                return;
+
+            const uint64_t bytes         = block.columns[static_cast<size_t>(column)].bytes;
+            const uint64_t offsets_bytes = (block.rows + 1) * sizeof(uint64_t);
+            const auto*    offsets       = reinterpret_cast<const uint64_t*>(data);
+            if (offsets_bytes > bytes || offsets[block.rows] > bytes - offsets_bytes)
+                Fail(_path, "column is truncated");
+            if (is_verify && !std::is_sorted(offsets, offsets + block.rows + 1))
+                Fail(_path, "column offsets are not ordered");
+
+            out->_offsets = offsets;
+            out->_bytes   = data + offsets_bytes;
+        };
+
+        auto dictionary = [&](const BlockEntry&   block,
+                              SnapshotColumn      column,
+                              SnapshotDictionary* out) {
+            const char*        data  = section(block, column);
+            const ColumnEntry& entry = block.columns[static_cast<size_t>(column)];
+
+            const uint64_t codes_bytes = Align8(block.rows * sizeof(uint32_t));
+            const uint64_t offsets_bytes =
+                Align8((uint64_t{entry.distinct} + 1) * sizeof(uint32_t));
+            if (codes_bytes + offsets_bytes > entry.bytes)
+                Fail(_path, "column is truncated");
+
+            const auto* codes   = reinterpret_cast<const uint32_t*>(data);
+            const auto* offsets = reinterpret_cast<const uint32_t*>(data + codes_bytes);
+            if (offsets[entry.distinct] > entry.bytes - codes_bytes - offsets_bytes)
+                Fail(_path, "column is truncated");
+            if (is_verify && (!std::is_sorted(offsets, offsets + entry.distinct + 1) ||
+                              std::any_of(codes, codes + block.rows, [&](uint32_t code) {
+                                  return code >= entry.distinct;
+                              })))
+                Fail(_path, "dictionary codes are out of range");
+
+            out->_codes   = codes;
+            out->_offsets = offsets;
+            out->_bytes   = data + codes_bytes + offsets_bytes;
+            out->_size    = entry.distinct;
+        };
+
+        uint64_t rows = 0;
+        _blocks.resize(header.blocks);
+        for (size_t i = 0; i < _blocks.size(); ++i) {
+            BlockEntry entry;
+            std::memcpy(&entry, base + header.directory_offset + i * sizeof(BlockEntry),
+                        sizeof(entry));
+            if (entry.rows > _bytes / sizeof(int64_t))
+                Fail(_path, "block is out of bounds");
+
+            SnapshotBlock& block = _blocks[i];
+            block._min_time      = entry.min_time;
+            block._max_time      = entry.max_time;
+
+            const char* times = section(entry, SnapshotColumn::Time);
+            if (entry.rows * sizeof(int64_t) > entry.columns[0].bytes)
+                Fail(_path, "column is truncated");
+            block._times = {reinterpret_cast<const int64_t*>(times), entry.rows};
+
+            strings(entry, SnapshotColumn::TimeText, &block._time_text);
+            dictionary(entry, SnapshotColumn::ActorType, &block._actor_type);
+            strings(entry, SnapshotColumn::ActorId, &block._actor_id);
+            dictionary(entry, SnapshotColumn::Action, &block._action);
+            dictionary(entry, SnapshotColumn::Status, &block._status);
+            dictionary(entry, SnapshotColumn::Source, &block._source);
+            strings(entry, SnapshotColumn::Detail, &block._detail);
+
+            rows += entry.rows;
+        }
+
+        if (rows != _rows)
+            Fail(_path, "row count mismatch");
+    }
+
+    void LogSnapshot::Unmap() {
+        if (_data != nullptr) {
+            ::munmap(_data, _bytes);
+            _data = nullptr;
+        }
+        _blocks.clear();
+    }
+
+    // LogSnapshotWriter
+
+    void LogSnapshotWriter::DictionaryBuilder::Add(std::string_view value) {
+        auto it = lookup.find(value);
+        if (it == lookup.end()) {
+            it = lookup.emplace(std::string(value), static_cast<uint32_t>(lookup.size())).first;
+            bytes.append(value);
+            offsets.push_back(static_cast<uint32_t>(bytes.size()));
+            max_length = std::max<uint64_t>(max_length, value.size());
+        }
+        codes.push_back(it->second);
+    }
+
+    void LogSnapshotWriter::DictionaryBuilder::Clear() {
+        codes.clear();
+        offsets.assign(1, 0);
+        bytes.clear();
+        lookup.clear();
+    }
+
+    void LogSnapshotWriter::StringsBuilder::Add(std::string_view value) {
+        bytes.append(value);
+        offsets.push_back(bytes.size());
+        max_length = std::max<uint64_t>(max_length, value.size());
+    }
+
+    void LogSnapshotWriter::StringsBuilder::Clear() {
+        offsets.assign(1, 0);
+        bytes.clear();
+    }
+
+    LogSnapshotWriter::LogSnapshotWriter(std::string path, size_t block_rows)
+        : _path(std::move(path)), _temporary_path(_path + ".tmp"),
+          _block_rows(std::max<size_t>(block_rows, 1)) {
+        _file = std::fopen(_temporary_path.c_str(), "wb");
+        if (_file == nullptr)
+            Fail(_temporary_path, std::strerror(errno));
+
+        // Место под заголовок; он пишется в Finish
+        _section.assign(sizeof(FileHeader), '\0');
+        WriteBytes(_section.data(), _section.size());
+    }
+
+    LogSnapshotWriter::~LogSnapshotWriter() {
+        if (_file != nullptr) {
+            std::fclose(_file);
+            std::remove(_temporary_path.c_str());
+        }
+    }
+
+    void LogSnapshotWriter::Add(const CompactLog& log) {
+        if (_file == nullptr)
+            Fail(_path, "writer is finished");
+
+        if (_rows == 0) {
+            _min_time = log.time;
+            _max_time = log.time;
+        } else {
+            _min_time = std::min(_min_time, log.time);
+            _max_time = std::max(_max_time, log.time);
+            _is_time_ordered = _is_time_ordered && log.time >= _last_time;
+        }
+        _last_time = log.time;
+        ++_rows;
+
+        // Текст времени хранится, только если его не восстановить по числу
+        char buffer[HOST_TIME_SIZE];
+        if (!_has_time_text && FormatHostTime(log.time, buffer) != log.time_text) {
+            for (const int64_t time : _times) {
+                _time_text.Add(FormatHostTime(time, buffer));
+            }
+            _has_time_text = true;
+        }
+
+        _times.push_back(log.time);
+        if (_has_time_text) {
+            _time_text.Add(log.time_text);
+        }
+        _actor_type.Add(log.actor_type);
+        _actor_id.Add(log.actor_id);
+        _action.Add(log.action);
+        _status.Add(log.status);
+        _source.Add(log.source);
+        _detail.Add(log.detail);
+
+        if (_times.size() >= _block_rows) {
+            FlushBlock();
+        }
+    }
+
+    void LogSnapshotWriter::Finish() {
+        if (_file == nullptr)
+            Fail(_path, "writer is finished");
+
+        FlushBlock();
+
+        FileHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC.data(), sizeof(header.magic));
+        header.version            = SNAPSHOT_VERSION;
+        header.flags              = _is_time_ordered ? FLAG_TIME_ORDERED : 0;
+        header.rows               = _rows;
+        header.blocks             = _directory.size() / sizeof(BlockEntry);
+        header.min_time           = _min_time;
+        header.max_time           = _max_time;
+        header.directory_offset   = _offset;
+        header.directory_checksum = Checksum(_directory.data(), _directory.size());
+        std::copy(_stats.begin(), _stats.end(), header.stats);
+        header.header_checksum =
+            Checksum(&header, offsetof(FileHeader, header_checksum));
+
+        WriteBytes(_directory.data(), _directory.size());
+
+        if (std::fseek(_file, 0, SEEK_SET) != 0)
+            Fail(_temporary_path, std::strerror(errno));
+        WriteBytes(&header, sizeof(header));
+
+        std::FILE* file = std::exchange(_file, nullptr);
+        if (std::fclose(file) != 0 || std::rename(_temporary_path.c_str(), _path.c_str()) != 0) {
+            const int error = errno;
+            std::remove(_temporary_path.c_str());
+            Fail(_path, std::strerror(error));
+        }
+    }
+
+    void LogSnapshotWriter::FlushBlock() {
+        if (_times.empty())
+            return;
+
+        BlockEntry block{};
+        block.rows     = _times.size();
+        block.min_time = *std::min_element(_times.begin(), _times.end());
+        block.max_time = *std::max_element(_times.begin(), _times.end());
+
+        auto write = [&](SnapshotColumn column, uint32_t distinct, uint64_t max_length) {
+            PadSection(&_section);
+
+            ColumnEntry& entry = block.columns[static_cast<size_t>(column)];
+            entry.encoding     = COLUMN_ENCODINGS[static_cast<size_t>(column)];
+            entry.distinct     = distinct;
+            entry.offset       = _offset;
+            entry.bytes        = _section.size();
+            entry.checksum     = Checksum(_section.data(), _section.size());
+            entry.max_length   = max_length;
+            WriteBytes(_section.data(), _section.size());
+
+            SnapshotColumnStats& stats = _stats[static_cast<size_t>(column)];
+            stats.bytes += entry.bytes;
+            stats.distinct += distinct;
+            stats.max_length = std::max(stats.max_length, max_length);
+        };
+
+        auto write_strings = [&](SnapshotColumn column, const StringsBuilder& builder) {
+            _section.clear();
+            AppendArray(&_section, builder.offsets);
+            _section.append(builder.bytes);
+            write(column, 0, builder.max_length);
+        };
+
+        auto write_dictionary = [&](SnapshotColumn column, const DictionaryBuilder& builder) {
+            _section.clear();
+            AppendArray(&_section, builder.codes);
+            PadSection(&_section);
+            AppendArray(&_section, builder.offsets);
+            PadSection(&_section);
+            _section.append(builder.bytes);
+            write(column, static_cast<uint32_t>(builder.lookup.size()), builder.max_length);
+        };
+
+        _section.clear();
+        AppendArray(&_section, _times);
+        write(SnapshotColumn::Time, 0, 0);
+
+        if (_has_time_text) {
+            write_strings(SnapshotColumn::TimeText, _time_text);
+        }
+        write_dictionary(SnapshotColumn::ActorType, _actor_type);
+        write_strings(SnapshotColumn::ActorId, _actor_id);
+        write_dictionary(SnapshotColumn::Action, _action);
+        write_dictionary(SnapshotColumn::Status, _status);
+        write_dictionary(SnapshotColumn::Source, _source);
+        write_strings(SnapshotColumn::Detail, _detail);
+
+        _directory.append(reinterpret_cast<const char*>(&block), sizeof(block));
+
+        _times.clear();
+        _time_text.Clear();
+        _has_time_text = false;
+        _actor_type.Clear();
+        _actor_id.Clear();
+        _action.Clear();
+        _status.Clear();
+        _source.Clear();
+        _detail.Clear();
+    }
+
+    void LogSnapshotWriter::WriteBytes(const void* data, size_t size) {
+        if (std::fwrite(data, 1, size, _file) != size)
+            Fail(_temporary_path, "write failed");
+        _offset += size;
+    }
+} // namespace snapshots
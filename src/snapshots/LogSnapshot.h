@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "structures/CompactLog.h"
+
+// Колоночный снимок логов - общий формат для генератора, хостов-заглушек и дискового кеша
+// дней. Файл читается через mmap, строки отдаются как string_view прямо из отображения.
+//
+// Раскладка (little-endian, все секции выровнены на 8):
+//   заголовок: magic "DLLOGSNP", версия, флаги, число строк и блоков, min/max время, место
+//              и контрольная сумма каталога, статистика колонок, контрольная сумма заголовка;
+//   блоки по DEFAULT_BLOCK_ROWS строк, у каждого колонки подряд:
+//     Time        - int64[rows], UNIX-секунды;
+//     TimeText    - строки, только если исходный текст времени не совпал с FormatHostTime;
+//     ActorType, Action, Status, Source - словарь: uint32 коды[rows], uint32 смещения[n+1],
+//                   байты значений;
+//     ActorId, Detail - uint64 смещения[rows+1] и байты подряд;
+//   каталог блоков в конце: строки, min/max время и для каждой колонки место, размер,
+//   контрольная сумма (XXH64) и статистика.
+//
+// Writer пишет поток блоками и собирает заголовок в Finish, поэтому снимок не держит в
+// памяти больше одного блока. Ошибки чтения и записи - std::runtime_error
+namespace snapshots {
+    inline constexpr uint32_t SNAPSHOT_VERSION   = 1;
+    inline constexpr size_t   DEFAULT_BLOCK_ROWS = 1 << 18;
+
+    // Текст времени в формате хоста "YYYY-MM-DDTHH:MM:SSZ"
+    inline constexpr size_t HOST_TIME_SIZE = 20;
+
+    enum class SnapshotColumn : uint32_t {
+        Time,
+        TimeText,
+        ActorType,
+        ActorId,
+        Action,
+        Status,
+        Source,
+        Detail
+    };
+
+    inline constexpr size_t SNAPSHOT_COLUMNS = 8;
+
+    // true - файл начинается с magic снимка
+    bool IsSnapshotFile(const std::string& path);
+
+    // Пишет время в buffer (HOST_TIME_SIZE байт) и возвращает view на него
+    std::string_view FormatHostTime(int64_t time, char* buffer);
+
+    // Статистика колонки по всему файлу
+    struct SnapshotColumnStats {
+        uint64_t bytes      = 0; // размер секций колонки
+        uint64_t distinct   = 0; // сумма размеров словарей блоков
+        uint64_t max_length = 0; // самое длинное значение
+    };
+
+    // Словарная колонка блока: код строки и значения по кодам
+    class SnapshotDictionary {
+    public:
+        [[nodiscard]] uint32_t Size() const { return _size; }
+        [[nodiscard]] uint32_t Code(size_t row) const { return _codes[row]; }
+
+        [[nodiscard]] std::string_view Entry(uint32_t code) const {
+            return {_bytes + _offsets[code], _offsets[code + 1] - _offsets[code]};
+        }
+
+        [[nodiscard]] std::string_view Value(size_t row) const { return Entry(_codes[row]); }
+
+    private:
+        friend class LogSnapshot;
+
+        const uint32_t* _codes   = nullptr;
+        const uint32_t* _offsets = nullptr;
+        const char*     _bytes   = nullptr;
+        uint32_t        _size    = 0;
+    };
+
+    // Колонка строк блока: значения подряд и смещения
+    class SnapshotStrings {
+    public:
+        [[nodiscard]] bool Empty() const { return _offsets == nullptr; }
+
+        [[nodiscard]] std::string_view Value(size_t row) const {
+            return {_bytes + _offsets[row], static_cast<size_t>(_offsets[row + 1] - _offsets[row])};
+        }
+
+    private:
+        friend class LogSnapshot;
+
+        const uint64_t* _offsets = nullptr;
+        const char*     _bytes   = nullptr;
+    };
+
+    // Блок строк снимка; все view действительны, пока жив LogSnapshot
+    class SnapshotBlock {
+    public:
+        [[nodiscard]] size_t  Rows() const { return _times.size(); }
+        [[nodiscard]] int64_t MinTime() const { return _min_time; }
+        [[nodiscard]] int64_t MaxTime() const { return _max_time; }
+
+        [[nodiscard]] std::span<const int64_t> Times() const { return _times; }
+
+        // false - время всех строк блока в каноническом виде (FormatHostTime) и текст не хранится
+        [[nodiscard]] bool HasTimeText() const { return !_time_text.Empty(); }
+
+        // Исходный текст времени; пустой без HasTimeText
+        [[nodiscard]] std::string_view TimeText(size_t row) const {
+            return HasTimeText() ? _time_text.Value(row) : std::string_view();
+        }
+
+        [[nodiscard]] const SnapshotDictionary& ActorType() const { return _actor_type; }
+        [[nodiscard]] const SnapshotStrings&    ActorId() const { return _actor_id; }
+        [[nodiscard]] const SnapshotDictionary& Action() const { return _action; }
+        [[nodiscard]] const SnapshotDictionary& Status() const { return _status; }
+        [[nodiscard]] const SnapshotDictionary& Source() const { return _source; }
+        [[nodiscard]] const SnapshotStrings&    Detail() const { return _detail; }
+
+        // Запись без копирования; time_text пуст без HasTimeText
+        [[nodiscard]] CompactLog Log(size_t row) const;
+
+        // Владеющая копия с текстом времени
+        [[nodiscard]] ReportServerLog ToReportServerLog(size_t row) const;
+
+    private:
+        friend class LogSnapshot;
+
+        int64_t                  _min_time = 0;
+        int64_t                  _max_time = 0;
+        std::span<const int64_t> _times;
+        SnapshotStrings          _time_text;
+        SnapshotDictionary       _actor_type;
+        SnapshotStrings          _actor_id;
+        SnapshotDictionary       _action;
+        SnapshotDictionary       _status;
+        SnapshotDictionary       _source;
+        SnapshotStrings          _detail;
+    };
+
+    // Снимок, отображенный в память. is_verify - сверить контрольные суммы и границы всех
+    // колонок при открытии (один проход по файлу); заголовок и каталог проверяются всегда
+    class LogSnapshot {
+    public:
+        static LogSnapshot Open(const std::string& path, bool is_verify = true);
+
+        LogSnapshot(LogSnapshot&& other) noexcept;
+        LogSnapshot& operator=(LogSnapshot&& other) noexcept;
+
+        LogSnapshot(const LogSnapshot&)            = delete;
+        LogSnapshot& operator=(const LogSnapshot&) = delete;
+
+        ~LogSnapshot();
+
+        [[nodiscard]] uint64_t Rows() const { return _rows; }
+        [[nodiscard]] int64_t  MinTime() const { return _min_time; }
+        [[nodiscard]] int64_t  MaxTime() const { return _max_time; }
+        [[nodiscard]] size_t   Bytes() const { return _bytes; } // размер отображения
+
+        // Строки всего файла не убывают по времени: окно ищется двоичным поиском
+        [[nodiscard]] bool IsTimeOrdered() const { return _is_time_ordered; }
+
+        [[nodiscard]] const std::vector<SnapshotBlock>& Blocks() const { return _blocks; }
+
+        [[nodiscard]] const SnapshotColumnStats& Stats(SnapshotColumn column) const {
+            return _stats[static_cast<size_t>(column)];
+        }
+
+        // Все строки владеющими копиями
+        [[nodiscard]] std::vector<ReportServerLog> ReadLogs() const;
+
+    private:
+        LogSnapshot() = default;
+
+        void*       _data  = nullptr;
+        size_t      _bytes = 0;
+        std::string _path;
+
+        uint64_t                                          _rows            = 0;
+        int64_t                                           _min_time        = 0;
+        int64_t                                           _max_time        = 0;
+        bool                                              _is_time_ordered = false;
+        std::vector<SnapshotBlock>                        _blocks;
+        std::array<SnapshotColumnStats, SNAPSHOT_COLUMNS> _stats{};
+
+        void Map(bool is_verify);
+
+        void Unmap();
+    };
+
+    // Потоковая запись снимка. Файл пишется рядом с путем (path + ".tmp") и переименовывается
+    // в Finish - читатель не увидит недописанный снимок; без Finish временный файл удаляется
+    class LogSnapshotWriter {
+    public:
+        explicit LogSnapshotWriter(std::string path, size_t block_rows = DEFAULT_BLOCK_ROWS);
+
+        LogSnapshotWriter(const LogSnapshotWriter&)            = delete;
+        LogSnapshotWriter& operator=(const LogSnapshotWriter&) = delete;
+
+        ~LogSnapshotWriter();
+
+        // Строки копируются; time - разобранное время, time_text - исходный текст
+        void Add(const CompactLog& log);
+
+        // Дописывает последний блок, каталог и заголовок
+        void Finish();
+
+        [[nodiscard]] uint64_t Rows() const { return _rows; }
+
+    private:
+        struct StringHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view value) const {
+                return std::hash<std::string_view>()(value);
+            }
+        };
+
+        struct DictionaryBuilder {
+            std::vector<uint32_t> codes;
+            std::vector<uint32_t> offsets{0};
+            std::string           bytes;
+            uint64_t              max_length = 0;
+
+            std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> lookup;
+
+            void Add(std::string_view value);
+            void Clear();
+        };
+
+        struct StringsBuilder {
+            std::vector<uint64_t> offsets{0};
+            std::string           bytes;
+            uint64_t              max_length = 0;
+
+            void Add(std::string_view value);
+            void Clear();
+        };
+
+        std::string _path;
+        std::string _temporary_path;
+        std::FILE*  _file       = nullptr;
+        size_t      _block_rows = DEFAULT_BLOCK_ROWS;
+        uint64_t    _offset     = 0;
+
+        uint64_t _rows            = 0;
+        int64_t  _min_time        = 0;
+        int64_t  _max_time        = 0;
+        int64_t  _last_time       = 0;
+        bool     _is_time_ordered = true;
+
+        // Текущий блок
+        std::vector<int64_t> _times;
+        StringsBuilder       _time_text;
+        bool                 _has_time_text = false;
+        DictionaryBuilder    _actor_type;
+        StringsBuilder       _actor_id;
+        DictionaryBuilder    _action;
+        DictionaryBuilder    _status;
+        DictionaryBuilder    _source;
+        StringsBuilder       _detail;
+
+        std::string                                       _directory; // записи блоков подряд
+        std::array<SnapshotColumnStats, SNAPSHOT_COLUMNS> _stats{};
+        std::string                                       _section;   // буфер секции колонки
+
+        void FlushBlock();
+
+        void WriteBytes(const void* data, size_t size);
+    };
+} // namespace snapshots
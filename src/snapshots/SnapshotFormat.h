@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "snapshots/LogSnapshot.h"
+
+// Раскладка файла снимка (см. LogSnapshot.h) - для LogSnapshot.cpp и тестов формата,
+// которые собирают поврежденные файлы
+namespace snapshots::format {
+    inline constexpr std::string_view SNAPSHOT_MAGIC    = "DLLOGSNP";
+    inline constexpr uint32_t         FLAG_TIME_ORDERED = 1;
+
+    enum class Encoding : uint32_t { None, Int64, Dictionary, Strings };
+
+    inline constexpr std::array<Encoding, SNAPSHOT_COLUMNS> COLUMN_ENCODINGS = {
+        Encoding::Int64,      // Time
+        Encoding::Strings,    // TimeText
+        Encoding::Dictionary, // ActorType
+        Encoding::Strings,    // ActorId
+        Encoding::Dictionary, // Action
+        Encoding::Dictionary, // Status
+        Encoding::Dictionary, // Source
+        Encoding::Strings     // Detail
+    };
+
+    struct FileHeader {
+        char                magic[8];
+        uint32_t            version;
+        uint32_t            flags;
+        uint64_t            rows;
+        uint64_t            blocks;
+        int64_t             min_time;
+        int64_t             max_time;
+        uint64_t            directory_offset;
+        uint64_t            directory_checksum;
+        SnapshotColumnStats stats[SNAPSHOT_COLUMNS];
+        uint64_t            header_checksum; // по всем байтам заголовка до этого поля
+    };
+
+    struct ColumnEntry {
+        Encoding encoding;
+        uint32_t distinct; // размер словаря блока
+        uint64_t offset;
+        uint64_t bytes;    // с выравниванием
+        uint64_t checksum;
+        uint64_t max_length;
+    };
+
+    struct BlockEntry {
+        uint64_t    rows;
+        int64_t     min_time;
+        int64_t     max_time;
+        ColumnEntry columns[SNAPSHOT_COLUMNS];
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(BlockEntry) % 8 == 0);
+
+    inline uint64_t Align8(uint64_t value) { return (value + 7) & ~uint64_t{7}; }
+
+    // XXH64 с нулевым seed
+    uint64_t Checksum(const void* data, size_t size);
+} // namespace snapshots::format
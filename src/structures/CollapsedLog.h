@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "ReportServerInterface.h"
+
+// Повторы одной строки лога (все поля, кроме времени), слитые в одну запись
+struct CollapsedLog {
+    ReportServerLog log; // первая строка группы
+    uint64_t        count      = 0;
+    int64_t         first_seen = 0;
+    int64_t         last_seen  = 0;
+};
+
+// Параметры сворачивания: request["collapse"] = true | { "window", "max_groups" }
+struct CollapseOptions {
+    bool   enabled    = false;
+    time_t window     = 60;   // повтор позже last_seen + window начинает новую группу
+    size_t max_groups = 4096; // открытых групп одновременно; старейшая закрывается досрочно
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Запись лога без собственных строк: поля ссылаются на арену CompactLogStore либо на строки
+// исходного ReportServerLog. Время разобрано заранее
+struct CompactLog {
+    int64_t          time = -1; // UNIX-секунды (UTC), -1 - нераспознанное значение
+    std::string_view time_text; // исходная строка времени
+    std::string_view actor_type;
+    std::string_view actor_id;
+    std::string_view action;
+    std::string_view status;
+    std::string_view source;
+    std::string_view detail;
+};
+
+using CompactLogSpan = std::span<const CompactLog>;
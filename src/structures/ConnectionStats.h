@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <map>
+
+// Сводка по сессиям подключений за сутки
+struct ConnectionStats {
+    uint64_t sessions           = 0; // сессии, пересекающиеся с сутками
+    uint64_t open_sessions      = 0; // без отключения до конца суток
+    uint64_t orphan_disconnects = 0; // отключения без найденного подключения
+    uint64_t unique_actors      = 0;
+    uint64_t peak_concurrent    = 0;
+    time_t   peak_time          = 0;
+    double   average_duration   = 0.0; // секунды, только по закрытым сессиям
+
+    std::map<int, uint64_t> by_connection_type; // ConnectionType, -1 - не определен
+    std::map<int, uint64_t> by_session_type;    // SESSION_*, -1 - не определен
+
+    std::array<uint64_t, 24> hourly_peak{}; // максимум одновременных сессий по часам
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "sketches/HyperLogLog.h"
+
+// Эскизы различных клиентов и IP-адресов за сутки. Свертка завершенного дня неизменна,
+// поэтому хранится в DayCache и объединяется с соседними днями без повторного прохода
+struct DayUniques {
+    sketches::HyperLogLog clients;
+    sketches::HyperLogLog ips;
+    bool                  is_rollup = false; // взята из кеша: строки дня уже учтены
+};
+
+// День "YYYY-MM-DD" -> эскизы
+using DailyUniques = std::map<std::string, DayUniques>;
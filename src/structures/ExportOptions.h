@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+enum class ExportFormat { Csv, Ndjson };
+
+// Параметры потоковой выгрузки: request["export"] = { "format", "chunk_size", "fetch_step" }
+struct ExportOptions {
+    ExportFormat format     = ExportFormat::Csv;
+    size_t       chunk_size = 1 << 20; // байт в буфере до записи в файл
+    time_t       fetch_step = 60 * 60; // секунд логов за один вызов GetLogs
+};
+
+struct ExportResult {
+    std::string path;
+    uint64_t    rows   = 0;
+    uint64_t    bytes  = 0;
+    uint64_t    chunks = 0;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+
+// Разбиение окна GetLogs на интервалы и число одновременных запросов к серверу
+struct FetchOptions {
+    time_t shard       = 24 * 60 * 60; // секунд на один вызов GetLogs
+    size_t concurrency = 1;            // 1 - последовательная загрузка в вызывающем потоке
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "sbxTableBuilder/SBXTableBuilder.hpp"
+
+// Активный фильтр колонки таблицы, пришедший вместе с запросом
+struct LogFilter {
+    std::string              column;
+    SearchType               search_type = SearchType::Like;
+    std::vector<std::string> values;
+};
+
+// План выборки логов: часть фильтров уходит в GetLogs, остальное проверяется в плагине
+struct LogQuery {
+    time_t                 from = 0;
+    time_t                 to   = 0;
+    std::string            type;   // аргумент type для GetLogs
+    std::string            filter; // аргумент filter для GetLogs
+    std::vector<LogFilter> residual;
+};
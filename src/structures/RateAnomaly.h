@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// Минута, в которую частота сообщений актора или источника отклонилась от базовой
+struct RateAnomaly {
+    std::string kind; // "actor" или "source"
+    std::string key;
+    time_t      minute   = 0;
+    uint32_t    count    = 0;   // сообщений за минуту
+    double      baseline = 0.0; // EWMA сообщений в минуту за предыдущие дни
+    double      z_score  = 0.0;
+};
@@ -1,9 +1,38 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <string>
+
 struct LogCountPoint {
     std::string date;
     int         client  = 0;
     int         manager = 0;
     int         system  = 0;
     int         total   = 0;
-};
\ No newline at end of file
+};
+
+// Количество сообщений по минутам суток (час * 60 + минута)
+struct ActivityHeatmap {
+    static constexpr int MINUTES_PER_DAY = 24 * 60;
+
+    std::array<uint32_t, MINUTES_PER_DAY> client{};
+    std::array<uint32_t, MINUTES_PER_DAY> manager{};
+    std::array<uint32_t, MINUTES_PER_DAY> system{};
+    std::array<uint32_t, MINUTES_PER_DAY> total{};
+};
+
+struct ErrorCountPoint {
+    std::string date;
+    int         warning  = 0;
+    int         error    = 0;
+    int         critical = 0;
+};
+
+// Количество сообщений по важности
+struct SeverityCounts {
+    uint64_t regular  = 0;
+    uint64_t warning  = 0;
+    uint64_t error    = 0;
+    uint64_t critical = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+enum class SamplingMode {
+    Off,        // всегда точный подсчет
+    Uniform,    // простая случайная выборка по всему окну
+    Stratified, // выборка внутри каждого часа пропорционально его объему
+};
+
+// Деградированный режим: request["sampling"] = { "mode", "row_budget", "time_budget_ms",
+// "sample_rows", "table_rows" }. Ниже бюджета отчет считается точно
+struct SamplingOptions {
+    SamplingMode mode           = SamplingMode::Stratified;
+    size_t       row_budget     = 5'000'000; // строк недели, после которых включается выборка
+    int64_t      time_budget_ms = 0;         // время загрузки, после которого тоже; 0 - нет
+    size_t       sample_rows    = 200'000;   // объем выборки для графиков
+    size_t       table_rows     = 10'000;    // строк таблицы в резервуаре
+};
+
+// Оценка с половиной ширины доверительного интервала 95%
+struct SampledEstimate {
+    double value  = 0.0;
+    double margin = 0.0;
+};
@@ -0,0 +1,240 @@
+#include "Tracer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace tracing {
+    namespace {
+        // Поток, не дождавшийся Flush, не копит спаны бесконечно
+        constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+        struct TraceEvent {
+            const char*                         name;
+            const char*                         category;
+            int64_t                             start_ns;
+            int64_t                             duration_ns;
+            std::array<TraceArg, MAX_SPAN_ARGS> args;
+        };
+
+        struct ThreadBuffer {
+            std::mutex              mutex;
+            std::vector<TraceEvent> events;
+            uint32_t                tid     = 0;
+            uint64_t                dropped = 0;
+        };
+
+        struct Tracer {
+            std::atomic<bool> enabled{false};
+
+            std::mutex                                 mutex; // файл и список буферов
+            std::FILE*                                 file = nullptr;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            std::atomic<uint32_t>                      next_tid{1};
+
+            // Меняется, когда Stop освобождает буферы: ссылки потоков на них устаревают
+            std::atomic<uint64_t> generation{1};
+        };
+
+        // Ссылка потока на свой буфер. Без деструктора: поток хоста может пережить
+        // выгрузку библиотеки, и в его TLS не должно остаться кода плагина
+        struct LocalSlot {
+            ThreadBuffer* buffer     = nullptr;
+            uint64_t      generation = 0;
+        };
+
+        static_assert(std::is_trivially_destructible_v<LocalSlot>);
+
+        Tracer& Instance() {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        int64_t NowNs() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        // Буфер потока создается при первом спане и принадлежит трассировщику; Stop
+        // освобождает все буферы, в том числе завершившихся потоков. nullptr - трассировка
+        // уже остановлена
+        ThreadBuffer* LocalBuffer() {
+            thread_local LocalSlot slot;
+
+            Tracer&        tracer     = Instance();
+            const uint64_t generation = tracer.generation.load(std::memory_order_acquire);
+            if (slot.buffer != nullptr && slot.generation == generation)
+                return slot.buffer;
+
+            std::lock_guard lock(tracer.mutex);
+            if (!tracer.enabled.load(std::memory_order_relaxed))
+                return nullptr;
+
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->tid = tracer.next_tid.fetch_add(1, std::memory_order_relaxed);
+
+            slot.buffer     = buffer.get();
+            slot.generation = tracer.generation.load(std::memory_order_relaxed);
+            tracer.buffers.push_back(std::move(buffer));
+            return slot.buffer;
+        }
+
+        void WriteEvent(std::FILE* file, const TraceEvent& event, uint32_t tid) {
+            std::fprintf(file,
+                         "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                         "\"pid\":%d,\"tid\":%u",
+                         event.name,
+                         event.category,
+                         static_cast<double>(event.start_ns) / 1000.0,
+                         static_cast<double>(event.duration_ns) / 1000.0,
+                         static_cast<int>(getpid()),
+                         tid);
+
+            const char* separator = ",\"args\":{";
+            for (const TraceArg& arg : event.args) {
+                if (arg.name == nullptr)
+                    break;
+                std::fprintf(file,
+                             "%s\"%s\":%lld",
+                             separator,
+                             arg.name,
+                             static_cast<long long>(arg.value));
+                separator = ",";
+            }
+            std::fputs(event.args[0].name != nullptr ? "}},\n" : "},\n", file);
+        }
+
+        // Под мьютексом трассировщика
+        void FlushLocked(Tracer& tracer) {
+            std::vector<TraceEvent> events;
+
+            for (const auto& entry : tracer.buffers) {
+                ThreadBuffer& buffer  = *entry;
+                uint64_t      dropped = 0;
+                {
+                    std::lock_guard lock(buffer.mutex);
+                    events.swap(buffer.events);
+                    dropped = std::exchange(buffer.dropped, 0);
+                }
+
+                if (tracer.file != nullptr) {
+                    for (const TraceEvent& event : events) {
+                        WriteEvent(tracer.file, event, buffer.tid);
+                    }
+                    if (dropped > 0) {
+                        // Мгновенное событие на месте потерянных спанов
+                        std::fprintf(tracer.file,
+                                     "{\"name\":\"dropped %llu spans\",\"ph\":\"i\",\"s\":\"t\","
+                                     "\"ts\":%.3f,\"pid\":%d,\"tid\":%u},\n",
+                                     static_cast<unsigned long long>(dropped),
+                                     static_cast<double>(NowNs()) / 1000.0,
+                                     static_cast<int>(getpid()),
+                                     buffer.tid);
+                    }
+                }
+                events.clear();
+            }
+
+            if (tracer.file != nullptr) {
+                std::fflush(tracer.file);
+            }
+        }
+    } // namespace
+
+    std::string TracePathFromEnvironment() {
+        const char* path = std::getenv("DAILY_LOGS_TRACE_FILE");
+        return path == nullptr ? std::string() : std::string(path);
+    }
+
+    void Start(const std::string& path) {
+        Tracer&         tracer = Instance();
+        std::lock_guard lock(tracer.mutex);
+
+        if (tracer.file != nullptr || path.empty())
+            return;
+
+        tracer.file = std::fopen(path.c_str(), "a");
+        if (tracer.file == nullptr)
+            return;
+
+        // Новый файл начинается с открывающей скобки массива событий
+        if (std::ftell(tracer.file) == 0) {
+            std::fputs("[\n", tracer.file);
+        }
+        tracer.enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void Flush() {
+        Tracer& tracer = Instance();
+        if (!tracer.enabled.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard lock(tracer.mutex);
+        FlushLocked(tracer);
+    }
+
+    void Stop() {
+        Tracer&         tracer = Instance();
+        std::lock_guard lock(tracer.mutex);
+
+        tracer.enabled.store(false, std::memory_order_relaxed);
+        FlushLocked(tracer);
+
+        // Спанов в полете нет (Stop вызывается после остановки пулов): ссылки потоков
+        // устаревают вместе с буферами
+        tracer.buffers.clear();
+        tracer.generation.fetch_add(1, std::memory_order_release);
+
+        if (tracer.file != nullptr) {
+            std::fclose(tracer.file);
+            tracer.file = nullptr;
+        }
+    }
+
+    bool IsEnabled() {
+        return Instance().enabled.load(std::memory_order_relaxed);
+    }
+
+    Span::Span(const char* name, const char* category) : _name(name), _category(category) {
+        if (IsEnabled()) {
+            _start_ns = NowNs();
+        }
+    }
+
+    Span::~Span() {
+        if (_start_ns < 0)
+            return;
+
+        const int64_t end_ns = NowNs();
+        ThreadBuffer* buffer = LocalBuffer();
+        if (buffer == nullptr)
+            return;
+
+        std::lock_guard lock(buffer->mutex);
+        if (buffer->events.size() >= MAX_EVENTS_PER_THREAD) {
+            ++buffer->dropped;
+            return;
+        }
+        buffer->events.push_back({_name, _category, _start_ns, end_ns - _start_ns, _args});
+    }
+
+    void Span::SetArg(const char* name, int64_t value) {
+        if (_start_ns < 0)
+            return;
+
+        for (TraceArg& arg : _args) {
+            if (arg.name == nullptr) {
+                arg = {name, value};
+                return;
+            }
+        }
+    }
+} // namespace tracing
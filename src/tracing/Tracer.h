@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Профилирование выполнения отчета: спаны в формате Chrome trace-event (JSON Array Format),
+// открываются в chrome://tracing и ui.perfetto.dev.
+//
+// Спан пишется в буфер своего потока (мьютекс буфера без конкуренции); Flush дописывает
+// накопленное в файл. Файл только дописывается и не закрывается скобкой - формат это
+// допускает, поэтому несколько отчетов и даже аварийное завершение дают читаемый файл.
+// Выключенная трассировка стоит одной атомарной загрузки на спан
+namespace tracing {
+    // Числовой аргумент спана; name - строковый литерал
+    struct TraceArg {
+        const char* name  = nullptr;
+        int64_t     value = 0;
+    };
+
+    inline constexpr size_t MAX_SPAN_ARGS = 2;
+
+    // Путь из DAILY_LOGS_TRACE_FILE; пустой - трассировка выключена
+    std::string TracePathFromEnvironment();
+
+    // Включает запись в path (дописывание). Пустой path или ошибка открытия - выключено
+    void Start(const std::string& path);
+
+    // Дописывает спаны всех потоков в файл
+    void Flush();
+
+    // Flush, закрытие файла и освобождение буферов потоков. Вызывается, когда спанов в
+    // полете нет (пулы остановлены)
+    void Stop();
+
+    bool IsEnabled();
+
+    // Интервал [создание, разрушение] в потоке. name и category - строковые литералы
+    class Span {
+    public:
+        Span(const char* name, const char* category);
+        ~Span();
+
+        Span(const Span&)            = delete;
+        Span& operator=(const Span&) = delete;
+
+        // Аргументы сверх MAX_SPAN_ARGS отбрасываются
+        void SetArg(const char* name, int64_t value);
+
+    private:
+        const char*                         _name;
+        const char*                         _category;
+        int64_t                             _start_ns = -1; // -1 - трассировка выключена
+        std::array<TraceArg, MAX_SPAN_ARGS> _args{};
+    };
+} // namespace tracing
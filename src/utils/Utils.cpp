@@ -1,12 +1,55 @@
 #include "Utils.h"
 
+#include "tracing/Tracer.h"
+
 namespace utils {
+    namespace {
+        // "YYYY-MM-DDTHH:MM:SSZ" с существующей датой и годом из четырех значащих цифр -
+        // для такой строки std::get_time + std::put_time дают ее же с пробелом вместо 'T'
+        bool IsCanonicalLogTime(std::string_view time_string) {
+            if (time_string.size() != 20 || time_string[4] != '-' || time_string[7] != '-' ||
+                time_string[10] != 'T' || time_string[13] != ':' || time_string[16] != ':' ||
+                time_string[19] != 'Z')
+                return false;
+
+            auto number = [time_string](size_t pos, size_t count) {
+                int value = 0;
+                for (size_t i = pos; i < pos + count; ++i) {
+                    if (time_string[i] < '0' || time_string[i] > '9')
+                        return -1;
+                    value = value * 10 + (time_string[i] - '0');
+                }
+                return value;
+            };
+
+            const int year   = number(0, 4);
+            const int month  = number(5, 2);
+            const int day    = number(8, 2);
+            const int hour   = number(11, 2);
+            const int minute = number(14, 2);
+            const int second = number(17, 2);
+
+            if (year < 1000 || month < 1 || month > 12 || day < 1 || hour < 0 || hour > 23 ||
+                minute < 0 || minute > 59 || second < 0 || second > 59)
+                return false;
+
+            static constexpr int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+            const bool is_leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+            return day <= days_in_month[month - 1] + (month == 2 && is_leap ? 1 : 0);
+        }
+    } // namespace
+
     void CreateUI(const ast::Node&                    node,
                   rapidjson::Value&                   response,
                   rapidjson::Document::AllocatorType& allocator) {
+        tracing::Span span("CreateUI", "render");
+
         // Content
         Value node_object(kObjectType);
-        to_json(node, node_object, allocator);
+        {
+            tracing::Span to_json_span("to_json", "render");
+            to_json(node, node_object, allocator);
+        }
 
         Value content_array(kArrayType);
         content_array.PushBack(node_object, allocator);
@@ -113,22 +156,43 @@ namespace utils {
         return timestamp - one_week_interval;
     }
 
-    std::string ExtractDate(const std::string& date_string) {
+    std::string ExtractDate(std::string_view date_string) {
         if (date_string.size() > 10) {
-            return date_string.substr(0, 10);
+            return std::string(date_string.substr(0, 10));
         }
-        return date_string;
+        return std::string(date_string);
     }
 
-    JSONArray CreateServerLogsChartData(const std::vector<ReportServerLog>& logs_vector) {
+    JSONArray CreateServerLogsChartData(CompactLogSpan logs_vector, DailyUniques* day_uniques) {
         std::map<std::string, LogCountPoint> logs_map;
 
+        // Логи идут по времени: эскизы дня ищутся один раз на смену дня
+        DayUniques* uniques = nullptr;
+        std::string uniques_day;
+
         for (const auto& log : logs_vector) {
-            std::string day = ExtractDate(log.time);
+            std::string day = ExtractDate(log.time_text);
 
             auto& point = logs_map[day];
             point.date  = day;
 
+            if (day_uniques != nullptr) {
+                if (uniques == nullptr || uniques_day != day) {
+                    uniques     = &(*day_uniques)[day];
+                    uniques_day = day;
+                }
+
+                // День из свертки кеша уже учтен целиком
+                if (!uniques->is_rollup) {
+                    if (log.actor_type == "CLIENT") {
+                        uniques->clients.Add(log.actor_id);
+                    }
+                    if (IsValidIpAddress(log.source)) {
+                        uniques->ips.Add(log.source);
+                    }
+                }
+            }
+
             if (log.actor_type == "CLIENT") {
                 point.client++;
             } else if (log.actor_type == "MANAGER") {
@@ -163,11 +227,300 @@ namespace utils {
             chart_data.emplace_back(row);
         }
 
+        if (day_uniques != nullptr) {
+            AddDailyUniquesToChartData(*day_uniques, &chart_data);
+        }
+
         return chart_data;
     }
 
-    JSONArray CreateTopFloodersChartData(const std::vector<ReportServerLog>& logs_vector) {
-        std::unordered_map<std::string, int> ip_counts;
+    void AddDailyUniquesToChartData(const DailyUniques& day_uniques, JSONArray* chart_data) {
+        for (auto& row : *chart_data) {
+            auto&      point = std::get<JSONObject>(row.value);
+            const auto it    = day_uniques.find(std::get<std::string>(point["day"].value));
+            if (it == day_uniques.end())
+                continue;
+
+            point["unique_clients"] = JSONValue(std::round(it->second.clients.Estimate()));
+            point["unique_ips"]     = JSONValue(std::round(it->second.ips.Estimate()));
+        }
+    }
+
+    JSONArray CreateErrorsChartData(CompactLogSpan logs_vector) {
+        std::map<std::string, ErrorCountPoint> errors_map;
+
+        for (const auto& log : logs_vector) {
+            const LogSeverity severity = classifiers::ClassifyLog(log.status, log.action);
+
+            // Дни без ошибок тоже попадают на график - с нулевыми значениями
+            auto& point = errors_map[ExtractDate(log.time_text)];
+
+            if (severity == LogSeverity::Warning) {
+                point.warning++;
+            } else if (severity == LogSeverity::Error) {
+                point.error++;
+            } else if (severity == LogSeverity::Critical) {
+                point.critical++;
+            }
+        }
+
+        JSONArray chart_data;
+        for (const auto& [date, point] : errors_map) {
+            JSONObject row;
+            row["day"]      = JSONValue(date);
+            row["warning"]  = JSONValue(static_cast<double>(point.warning));
+            row["error"]    = JSONValue(static_cast<double>(point.error));
+            row["critical"] = JSONValue(static_cast<double>(point.critical));
+
+            chart_data.emplace_back(row);
+        }
+
+        return chart_data;
+    }
+
+    SeverityCounts CountSeverities(CompactLogSpan logs_vector, time_t from, time_t to) {
+        SeverityCounts counts;
+
+        for (const auto& log : logs_vector) {
+            const int64_t timestamp = log.time;
+            if (timestamp < from || timestamp > to)
+                continue;
+
+            switch (classifiers::ClassifyLog(log.status, log.action)) {
+                case LogSeverity::Warning:
+                    counts.warning++;
+                    break;
+                case LogSeverity::Error:
+                    counts.error++;
+                    break;
+                case LogSeverity::Critical:
+                    counts.critical++;
+                    break;
+                default:
+                    counts.regular++;
+                    break;
+            }
+        }
+
+        return counts;
+    }
+
+    JSONArray CreateConnectionTypesChartData(const ConnectionStats& stats) {
+        static const std::map<int, std::string> connection_names = {
+            {-1, "Unknown"},
+            {CONNECTION_TYPE_CLIENT_DESKTOP, "Desktop"},
+            {CONNECTION_TYPE_CLIENT_WINPHONE, "WinPhone"},
+            {CONNECTION_TYPE_CLIENT_IPHONE, "iPhone"},
+            {CONNECTION_TYPE_CLIENT_ANDROID, "Android"},
+            {CONNECTION_TYPE_CLIENT_BLACKBERRY, "BlackBerry"},
+            {CONNECTION_TYPE_CLIENT_WEB, "Web"},
+            {CONNECTION_TYPE_REST, "REST"},
+            {CONNECTION_TYPE_TCP, "TCP"},
+            {CONNECTION_TYPE_FIX, "FIX"}};
+
+        JSONArray chart_data;
+        for (const auto& [type, count] : stats.by_connection_type) {
+            const auto name = connection_names.find(type);
+
+            JSONObject row;
+            row["type"]     = name != connection_names.end() ? name->second : std::to_string(type);
+            row["sessions"] = JSONValue(static_cast<double>(count));
+
+            chart_data.emplace_back(row);
+        }
+
+        return chart_data;
+    }
+
+    JSONArray CreateSessionTypesChartData(const ConnectionStats& stats) {
+        static const std::map<int, std::string> session_names = {
+            {-1, "Unknown"},
+            {SESSION_USER, "User"},
+            {SESSION_MANAGER, "Manager"},
+            {SESSION_DEALER, "Dealer"},
+            {SESSION_ADMIN, "Admin"},
+            {SESSION_SYSTEM, "System"},
+            {SESSION_FIX, "FIX"},
+            {SESSION_CUSTOMER, "Customer"},
+            {SESSION_CRM_MANAGER, "CRM manager"},
+            {SESSION_CRM_ADMIN, "CRM admin"}};
+
+        JSONArray chart_data;
+        for (const auto& [type, count] : stats.by_session_type) {
+            const auto name = session_names.find(type);
+
+            JSONObject row;
+            row["type"]     = name != session_names.end() ? name->second : std::to_string(type);
+            row["sessions"] = JSONValue(static_cast<double>(count));
+
+            chart_data.emplace_back(row);
+        }
+
+        return chart_data;
+    }
+
+    JSONArray CreateConcurrentSessionsChartData(const ConnectionStats& stats) {
+        JSONArray chart_data;
+
+        for (size_t hour = 0; hour < stats.hourly_peak.size(); ++hour) {
+            std::ostringstream label;
+            label << std::setw(2) << std::setfill('0') << hour << ":00";
+
+            JSONObject row;
+            row["hour"]       = label.str();
+            row["concurrent"] = JSONValue(static_cast<double>(stats.hourly_peak[hour]));
+
+            chart_data.emplace_back(row);
+        }
+
+        return chart_data;
+    }
+
+    ActivityHeatmap CountActivityHeatmap(CompactLogSpan logs_vector, time_t day_from) {
+        constexpr int64_t seconds_per_day = 24 * 60 * 60;
+
+        // counts[тип][минута]: 0 - CLIENT, 1 - MANAGER, 2 - SYSTEM, 3 - прочие
+        std::array<std::array<uint32_t, ActivityHeatmap::MINUTES_PER_DAY>, 4> counts{};
+
+        for (const auto& log : logs_vector) {
+            const int64_t timestamp = log.time;
+
+            // Отрицательное смещение при приведении к беззнаковому тоже выходит за сутки
+            const auto offset = static_cast<uint64_t>(timestamp - day_from);
+            if (timestamp < 0 || offset >= static_cast<uint64_t>(seconds_per_day))
+                continue;
+
+            const std::string_view type = log.actor_type;
+            const size_t           kind = type == "CLIENT"    ? 0
+                                          : type == "MANAGER" ? 1
+                                          : type == "SYSTEM"  ? 2
+                                                              : 3;
+
+            counts[kind][offset / 60]++;
+        }
+
+        ActivityHeatmap heatmap;
+        heatmap.client  = counts[0];
+        heatmap.manager = counts[1];
+        heatmap.system  = counts[2];
+
+        for (int minute = 0; minute < ActivityHeatmap::MINUTES_PER_DAY; ++minute) {
+            heatmap.total[minute] =
+                counts[0][minute] + counts[1][minute] + counts[2][minute] + counts[3][minute];
+        }
+
+        return heatmap;
+    }
+
+    ast::Node CreateActivityHeatmapNode(const ActivityHeatmap& heatmap) {
+        constexpr int CELL   = 12;       // сторона ячейки, px
+        constexpr int PITCH  = CELL + 1; // шаг сетки с зазором в 1 px
+        constexpr int LEVELS = 8;        // градаций цвета для непустых минут
+
+        const uint32_t max_total = *std::max_element(heatmap.total.begin(), heatmap.total.end());
+
+        // Одна фигура на градацию: ячейки - подпути "M x y h12 v12 h-12 z" одного path
+        std::array<std::string, LEVELS + 1> shapes;
+        for (auto& shape : shapes) {
+            shape.reserve(ActivityHeatmap::MINUTES_PER_DAY * 4);
+        }
+
+        for (int index = 0; index < ActivityHeatmap::MINUTES_PER_DAY; ++index) {
+            const uint32_t total = heatmap.total[index];
+
+            // Градация 1..LEVELS пропорциональна числу сообщений за минуту, 0 - пустая минута
+            const int level = total == 0 ? 0
+                                         : 1 + static_cast<int>(uint64_t{total} * LEVELS /
+                                                                (uint64_t{max_total} + 1));
+
+            char cell[48];
+            std::snprintf(cell,
+                          sizeof(cell),
+                          "M%d %dh%dv%dh-%dz",
+                          index % 60 * PITCH,
+                          index / 60 * PITCH,
+                          CELL,
+                          CELL,
+                          CELL);
+            shapes[level] += cell;
+        }
+
+        std::vector<Node> paths;
+        for (int level = 0; level <= LEVELS; ++level) {
+            if (shapes[level].empty())
+                continue;
+
+            char fill[32] = "#F3F4F6";
+            if (level > 0) {
+                std::snprintf(fill,
+                              sizeof(fill),
+                              "rgba(208, 2, 27, %g)",
+                              TruncateDouble(0.08 + 0.92 * level / LEVELS, 3));
+            }
+            paths.push_back(path({}, props({{"d", std::move(shapes[level])}, {"fill", fill}})));
+        }
+
+        auto label_style = [](double width, double height) {
+            return JSONValue(JSONObject{{"width", JSONValue(width)},
+                                        {"height", JSONValue(height)},
+                                        {"fontSize", JSONValue("10px")},
+                                        {"lineHeight", JSONValue(std::to_string(PITCH) + "px")},
+                                        {"color", JSONValue("gray")}});
+        };
+
+        // Подписи: часы слева, минуты сверху через каждые 10
+        std::vector<Node> hour_labels;
+        for (int hour = 0; hour < 24; ++hour) {
+            char hour_label[8];
+            std::snprintf(hour_label, sizeof(hour_label), "%02d:00", hour);
+            hour_labels.push_back(
+                div({text(hour_label)}, props({{"style", label_style(36, PITCH)}})));
+        }
+
+        std::vector<Node> minute_labels = {div({}, props({{"style", label_style(36, PITCH)}}))};
+        for (int minute = 0; minute < 60; minute += 10) {
+            minute_labels.push_back(div({text(std::to_string(minute))},
+                                        props({{"style", label_style(10 * PITCH, PITCH)}})));
+        }
+
+        auto counts = [](const std::array<uint32_t, ActivityHeatmap::MINUTES_PER_DAY>& minutes) {
+            return JSONValue(JSONIntArray(minutes.begin(), minutes.end()));
+        };
+
+        // Счетчики по минутам - по одному числовому массиву на тип, для выгрузки и подсказок
+        Node grid = svg(std::move(paths),
+                        props({{"width", static_cast<double>(60 * PITCH)},
+                               {"height", static_cast<double>(24 * PITCH)},
+                               {"data-total", counts(heatmap.total)},
+                               {"data-client", counts(heatmap.client)},
+                               {"data-manager", counts(heatmap.manager)},
+                               {"data-system", counts(heatmap.system)}}));
+
+        const auto peak        = std::max_element(heatmap.total.begin(), heatmap.total.end());
+        const auto peak_minute = static_cast<int>(peak - heatmap.total.begin());
+
+        char peak_label[64] = "No messages";
+        if (max_total != 0) {
+            std::snprintf(peak_label,
+                          sizeof(peak_label),
+                          "Peak: %u messages at %02d:%02d",
+                          max_total,
+                          peak_minute / 60,
+                          peak_minute % 60);
+        }
+
+        auto row_style = JSONValue(JSONObject{{"display", JSONValue("flex")}});
+
+        return div({div(std::move(minute_labels), props({{"style", row_style}})),
+                    div({div(std::move(hour_labels)), std::move(grid)},
+                        props({{"style", row_style}})),
+                    p({text(peak_label)},
+                      props({{"style", JSONValue(JSONObject{{"color", JSONValue("gray")}})}}))});
+    }
+
+    JSONArray CreateTopFloodersChartData(CompactLogSpan             logs_vector,
+                                         std::pmr::memory_resource* resource) {
+        std::pmr::unordered_map<std::string_view, int> ip_counts(resource);
 
         // Подсчет количества логов по IP
         for (const auto& log : logs_vector) {
@@ -189,7 +542,8 @@ namespace utils {
         }
 
         // Перенос в вектор для сортировки
-        std::vector<std::pair<std::string, int>> sorted_ips(ip_counts.begin(), ip_counts.end());
+        std::pmr::vector<std::pair<std::string_view, int>> sorted_ips(
+            ip_counts.begin(), ip_counts.end(), resource);
 
         // Сортировка по убыванию
         std::sort(sorted_ips.begin(), sorted_ips.end(), [](const auto& a, const auto& b) {
@@ -218,7 +572,7 @@ namespace utils {
             percent = std::round(percent * 100.0) / 100.0;
 
             JSONObject item;
-            item["label"] = ip;
+            item["label"] = JSONValue(ip);
             item["value"] = percent;
 
             result.emplace_back(item);
@@ -239,42 +593,57 @@ namespace utils {
         return result;
     }
 
-    bool IsValidIpAddress(const std::string& ip_address) {
-        std::istringstream ss(ip_address);
-        std::string        token;
-        int                segments = 0;
+    bool IsValidIpAddress(std::string_view address) {
+        // Разбор без потоков и аллокаций: проверка идет на каждую строку недели
+        int                    segments = 0;
+        size_t                 position = 0;
+
+        while (position < address.size()) {
+            size_t end = address.find('.', position);
+            if (end == std::string_view::npos) {
+                end = address.size();
+            }
 
-        while (std::getline(ss, token, '.')) {
             // Проверка, что сегмент не пустой
-            if (token.empty())
+            if (end == position)
                 return false;
 
-            // Проверка, что сегмент состоит только из цифр
-            for (char c : token) {
-                if (!std::isdigit(c))
+            // Проверка, что сегмент состоит только из цифр и не больше 255
+            int num = 0;
+            for (size_t i = position; i < end; ++i) {
+                if (!std::isdigit(static_cast<unsigned char>(address[i])))
                     return false;
-            }
 
-            int num = std::stoi(token);
-            if (num < 0 || num > 255)
-                return false;
+                num = num * 10 + (address[i] - '0');
+                if (num > 255)
+                    return false;
+            }
 
             ++segments;
+            position = end + 1;
         }
 
         // Должно быть ровно 4 сегмента
         return segments == 4;
     }
 
-    std::string NormalizeLogTime(const std::string& time_string) {
+    std::string NormalizeLogTime(std::string_view time_string) {
+        // Обычная строка хоста - без потоков: 'T' меняется на пробел, 'Z' отбрасывается.
+        // Остальное (другие длины, секунда 60, несуществующие даты) разбирает std::get_time
+        if (IsCanonicalLogTime(time_string)) {
+            std::string normalized(time_string.substr(0, 19));
+            normalized[10] = ' ';
+            return normalized;
+        }
+
         std::tm tm = {};
 
-        std::istringstream in(time_string);
+        std::istringstream in{std::string(time_string)};
 
         in >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
 
         if (in.fail()) {
-            return time_string;
+            return std::string(time_string);
         }
 
         std::ostringstream out;
@@ -283,6 +652,59 @@ namespace utils {
         return out.str();
     }
 
+    int64_t ParseLogTimestamp(std::string_view time_string) {
+        // Фиксированный формат разбирается вручную: std::get_time слишком дорог на каждую строку
+        if (time_string.size() < 19)
+            return -1;
+
+        const char* s = time_string.data();
+
+        if (s[4] != '-' || s[7] != '-' || (s[10] != 'T' && s[10] != ' ') || s[13] != ':' ||
+            s[16] != ':')
+            return -1;
+
+        auto digits = [s](int pos, int count, int* out) {
+            int value = 0;
+            for (int i = pos; i < pos + count; ++i) {
+                if (s[i] < '0' || s[i] > '9')
+                    return false;
+                value = value * 10 + (s[i] - '0');
+            }
+            *out = value;
+            return true;
+        };
+
+        int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        if (!digits(0, 4, &year) || !digits(5, 2, &month) || !digits(8, 2, &day) ||
+            !digits(11, 2, &hour) || !digits(14, 2, &minute) || !digits(17, 2, &second))
+            return -1;
+
+        if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 ||
+            second > 60)
+            return -1;
+
+        // Количество дней от 1970-01-01 (алгоритм days_from_civil)
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t yoe = year - era * 400;
+        const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        const int64_t days = era * 146097 + doe - 719468;
+
+        return days * 86400 + hour * 3600 + minute * 60 + second;
+    }
+
+    std::string FormatLogTime(const int64_t timestamp) {
+        const time_t time = static_cast<time_t>(timestamp);
+        std::tm      tm{};
+        gmtime_r(&time, &tm);
+
+        char buffer[32];
+        const size_t size = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+
+        return std::string(buffer, size);
+    }
+
     std::string Trim(const std::string& str) {
         const auto begin = str.find_first_not_of(" \t");
         if (begin == std::string::npos)
@@ -3,18 +3,26 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory_resource>
 #include <rapidjson/document.h>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "ReportServerInterface.h"
 #include "ast/Ast.hpp"
+#include "classifiers/SeverityClassifier.h"
+#include "structures/CompactLog.h"
+#include "structures/ConnectionStats.h"
+#include "structures/DayUniques.h"
 #include "structures/ReportStructures.h"
 
 using namespace ast;
@@ -31,15 +39,49 @@ namespace utils {
 
     int CalculateTimestampForWeekAgo(const int timestamp);
 
-    std::string ExtractDate(const std::string& date);
+    std::string ExtractDate(std::string_view date);
 
-    JSONArray CreateServerLogsChartData(const std::vector<ReportServerLog>& logs_vector);
+    // day_uniques: попутно пополняются эскизы уникальных клиентов и IP по дням (кроме
+    // взятых из свертки), их оценки добавляются в точки графика
+    JSONArray CreateServerLogsChartData(CompactLogSpan logs_vector,
+                                        DailyUniques*  day_uniques = nullptr);
 
-    JSONArray CreateTopFloodersChartData(const std::vector<ReportServerLog>& logs_vector);
+    // Поля unique_clients / unique_ips в точках графика по дням, для которых есть эскизы
+    void AddDailyUniquesToChartData(const DailyUniques& day_uniques, JSONArray* chart_data);
 
-    bool IsValidIpAddress(const std::string& ip_address);
+    JSONArray CreateErrorsChartData(CompactLogSpan logs_vector);
 
-    std::string NormalizeLogTime(const std::string& time_string);
+    // Количество сообщений по важности за [from, to]
+    SeverityCounts CountSeverities(CompactLogSpan logs_vector, time_t from, time_t to);
+
+    JSONArray CreateConnectionTypesChartData(const ConnectionStats& stats);
+
+    JSONArray CreateSessionTypesChartData(const ConnectionStats& stats);
+
+    JSONArray CreateConcurrentSessionsChartData(const ConnectionStats& stats);
+
+    // Счетчики сообщений по минутам суток, начинающихся в day_from (UTC)
+    ActivityHeatmap CountActivityHeatmap(CompactLogSpan logs_vector, time_t day_from);
+
+    // Тепловая карта 24 x 60: строки - часы, ячейки - минуты. Одна svg: по path на градацию
+    // цвета, счетчики по минутам - числовыми массивами data-total / data-client / ...
+    ast::Node CreateActivityHeatmapNode(const ActivityHeatmap& heatmap);
+
+    // resource - память под временные счетчики (арена запроса)
+    JSONArray CreateTopFloodersChartData(
+        CompactLogSpan             logs_vector,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    bool IsValidIpAddress(std::string_view ip_address);
+
+    std::string NormalizeLogTime(std::string_view time_string);
+
+    // UTC-время лога ("YYYY-MM-DDTHH:MM:SSZ" или "YYYY-MM-DD HH:MM:SS") в UNIX-секунды,
+    // -1 при ошибке
+    int64_t ParseLogTimestamp(std::string_view time_string);
+
+    // UNIX-секунды в формат NormalizeLogTime ("YYYY-MM-DD HH:MM:SS", UTC)
+    std::string FormatLogTime(int64_t timestamp);
 
     std::string Trim(const std::string& str);
 
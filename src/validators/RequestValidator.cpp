@@ -292,6 +292,56 @@ ValidationResult RequestValidator::ValidateDaily(const rapidjson::Value& request
         return result;
     }
 
+    if (request.HasMember("filters") && !request["filters"].IsObject()) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'filters'";
+        return result;
+    }
+
+    if (request.HasMember("payload") &&
+        (!request["payload"].IsString() ||
+         (std::string(request["payload"].GetString()) != "rows" &&
+          std::string(request["payload"].GetString()) != "compact"))) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'payload'";
+        return result;
+    }
+
+    if (request.HasMember("deadline_ms") &&
+        (!request["deadline_ms"].IsInt64() || request["deadline_ms"].GetInt64() <= 0)) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'deadline_ms'";
+        return result;
+    }
+
+    CollapseOptions collapse_options;
+    if (!collapse::ParseCollapseOptions(request, &collapse_options)) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'collapse'";
+        return result;
+    }
+
+    SamplingOptions sampling_options;
+    if (!sampling::ParseSamplingOptions(request, &sampling_options)) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'sampling'";
+        return result;
+    }
+
+    ExportOptions export_options;
+    if (request.HasMember("export") &&
+        !exporters::ParseExportOptions(request, &export_options)) {
+        result.allowed = false;
+        result.code    = 400;
+        result.message = "ValidateDaily: invalid 'export'";
+        return result;
+    }
+
     result.allowed = true;
     result.code    = 200;
     result.message = "ValidateDaily: access granted";
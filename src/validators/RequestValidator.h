@@ -4,7 +4,10 @@
 #include <string>
 
 #include "ReportServerInterface.h"
+#include "collapse/LogCollapser.h"
+#include "exporters/LogExporter.h"
 #include "rapidjson/document.h"
+#include "sampling/Sampling.h"
 #include "structures/ReportType.h"
 #include "structures/ValidationResult.h"
 #include "utils/Utils.h"
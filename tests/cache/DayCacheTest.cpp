@@ -0,0 +1,91 @@
+// DayCache: вытеснение давно не использованных срезов сверх предела памяти и завершенных
+// дней, к которым не обращались дольше idle_ttl
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache/DayCache.h"
+#include "common/Check.h"
+#include "utils/Utils.h"
+
+namespace {
+    constexpr time_t DAY      = 86400;
+    constexpr time_t DAY_FROM = 1700006400; // 2023-11-15T00:00:00Z, день завершен
+
+    std::vector<ReportServerLog> DayLogs(time_t from) {
+        std::vector<ReportServerLog> logs(1000);
+        for (size_t i = 0; i < logs.size(); ++i) {
+            logs[i].time       = utils::FormatLogTime(from + static_cast<time_t>(i));
+            logs[i].actor_type = "CLIENT";
+            logs[i].actor_id   = std::to_string(i);
+            logs[i].action     = "LOGIN";
+            logs[i].status     = "RET_OK";
+            logs[i].source     = "10.0.0.1";
+            logs[i].detail     = "a detail line that does not fit into the string itself";
+        }
+        return logs;
+    }
+
+    std::shared_ptr<const LogSlice> StoreDay(DayCache& cache, int day) {
+        const time_t from = DAY_FROM + day * DAY;
+        return cache.Store(from, from + DAY - 1, DayLogs(from));
+    }
+
+    bool HasDay(DayCache& cache, int day) {
+        const time_t from = DAY_FROM + day * DAY;
+        return cache.Find(from, from + DAY - 1) != nullptr;
+    }
+
+    size_t DayBytes() {
+        DayCache cache;
+        return StoreDay(cache, 0)->MemoryUsage();
+    }
+
+    void TestMemoryBudget() {
+        const size_t day_bytes = DayBytes();
+        CHECK(day_bytes > 1000 * sizeof(ReportServerLog));
+
+        // Помещаются два дня: третий вытесняет тот, к которому дольше не обращались
+        DayCache cache({.directory = "", .memory_bytes = day_bytes * 2 + day_bytes / 2});
+        StoreDay(cache, 0);
+        StoreDay(cache, 1);
+        CHECK(HasDay(cache, 0));
+
+        StoreDay(cache, 2);
+        CHECK(HasDay(cache, 0));
+        CHECK(!HasDay(cache, 1));
+        CHECK(HasDay(cache, 2));
+    }
+
+    void TestSliceOverBudget() {
+        DayCache cache({.directory = "", .memory_bytes = DayBytes() / 2});
+
+        // Отчет получает срез, но кеш его не держит
+        const auto slice = StoreDay(cache, 0);
+        CHECK(slice != nullptr && slice->Size() == 1000);
+        CHECK(!HasDay(cache, 0));
+    }
+
+    void TestIdleTtl() {
+        DayCache cache({.directory = "", .idle_ttl = 1});
+        StoreDay(cache, 0);
+        CHECK(HasDay(cache, 0));
+
+        // Время кеша - секунды std::time: через 2 с день гарантированно простаивал дольше 1 с
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        CHECK(!HasDay(cache, 0));
+    }
+} // namespace
+
+int main() {
+    TestMemoryBudget();
+    TestSliceOverBudget();
+    TestIdleTtl();
+
+    std::printf("day cache ok\n");
+    return 0;
+}
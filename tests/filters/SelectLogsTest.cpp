@@ -0,0 +1,163 @@
+// SelectLogs с индексом токенов среза должен отбирать ровно те же строки, что и линейный
+// ApplyLogFilters по тем же логам: индекс только сужает кандидатов, результат решает
+// FilterProgram
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "cache/DayCache.h"
+#include "common/Check.h"
+#include "filters/LogFilters.h"
+#include "utils/Utils.h"
+
+namespace {
+    constexpr time_t DAY_FROM = 1700006400; // 2023-11-15T00:00:00Z
+    constexpr size_t ROWS     = 20000;
+
+    std::vector<ReportServerLog> GenerateLogs() {
+        static const char* actor_types[] = {"CLIENT", "SERVER", "ADMIN"};
+        static const char* actions[]     = {"LOGIN", "LOGOUT", "GET_REPORT", "SET_CONFIG"};
+        static const char* statuses[]    = {"RET_OK", "RET_ERR_TIMEOUT", "RET_ERR_ACCESS"};
+        static const char* words[]       = {"session", "opened", "closed", "timeout",
+                                            "user",    "quota",  "disk",   "retry-after",
+                                            "report",  "a.b.c",  "Error",  "error"};
+
+        std::mt19937                 random(42);
+        std::vector<ReportServerLog> logs;
+        logs.reserve(ROWS);
+
+        for (size_t i = 0; i < ROWS; ++i) {
+            ReportServerLog log;
+            log.time       = utils::FormatLogTime(DAY_FROM + static_cast<time_t>(i * 4));
+            log.actor_type = actor_types[random() % std::size(actor_types)];
+            log.actor_id   = std::to_string(1000 + random() % 500);
+            log.action     = actions[random() % std::size(actions)];
+            log.status     = statuses[random() % std::size(statuses)];
+            log.source =
+                "10.0." + std::to_string(random() % 4) + "." + std::to_string(random() % 250);
+
+            const size_t count = 1 + random() % 5;
+            for (size_t word = 0; word < count; ++word) {
+                log.detail += word == 0 ? "" : " ";
+                log.detail += words[random() % std::size(words)];
+            }
+            // Редкие токены - на них индекс действительно сужает выборку
+            if (i % 997 == 0) {
+                log.detail += " rare-" + std::to_string(i);
+            }
+            logs.push_back(std::move(log));
+        }
+        return logs;
+    }
+
+    LogFilter Filter(std::string column, SearchType search_type, std::vector<std::string> values) {
+        return {std::move(column), search_type, std::move(values)};
+    }
+
+    auto Fields(const ReportServerLog& log) {
+        return std::tie(log.time, log.actor_type, log.actor_id, log.action, log.status,
+                        log.source, log.detail);
+    }
+
+    void CheckSameRows(const std::vector<ReportServerLog>& logs,
+                       const LogSlice&                     slice,
+                       const std::vector<LogFilter>&       filters) {
+        std::vector<ReportServerLog> expected = logs;
+        filters::ApplyLogFilters(expected, filters);
+
+        const filters::Bitmap selected =
+            filters::SelectLogs(slice.Columns(), &slice.Index(), filters);
+
+        std::vector<size_t> rows;
+        selected.ForEach([&](size_t row) { rows.push_back(row); });
+
+        CHECK(rows.size() == expected.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            CHECK(Fields(logs[rows[i]]) == Fields(expected[i]));
+        }
+    }
+
+    // Не числа и значения за пределами time_t не сужают окно GetLogs
+    void CheckRejectedTimeValues() {
+        for (const char* value : {"nan", "inf", "-inf", "1e300", "-1e300"}) {
+            double number = 0.0;
+            CHECK(!filters::ParseTimeValue(value, &number));
+
+            const LogQuery query = filters::PlanLogQuery(
+                DAY_FROM, DAY_FROM + 86399,
+                {Filter("time", SearchType::Between, {value, value})}, false);
+            CHECK(query.from == DAY_FROM && query.to == DAY_FROM + 86399);
+        }
+    }
+
+    // search_type не строкой или неизвестный - ошибка запроса, а не молчаливый Like
+    void CheckInvalidSearchType() {
+        for (const char* config : {R"({"filters": {"detail": {"search_type": 5, "value": "x"}}})",
+                                   R"({"filters": {"detail": {"search_type": "lke", "value": "x"}}})"}) {
+            rapidjson::Document request;
+            request.Parse(config);
+
+            bool is_rejected = false;
+            try {
+                filters::ParseLogFilters(request);
+            } catch (const std::invalid_argument&) {
+                is_rejected = true;
+            }
+            CHECK(is_rejected);
+        }
+    }
+} // namespace
+
+int main() {
+    CheckRejectedTimeValues();
+    CheckInvalidSearchType();
+
+    const std::vector<ReportServerLog> logs = GenerateLogs();
+    const LogSlice slice(DAY_FROM, DAY_FROM + 86399, std::vector<ReportServerLog>(logs));
+
+    const std::vector<std::vector<LogFilter>> cases = {
+        {Filter("detail", SearchType::Like, {"timeout"})},
+        {Filter("detail", SearchType::Like, {"rare-1994"})},
+        {Filter("detail", SearchType::Like, {"rare-"})},
+        {Filter("detail", SearchType::Like, {"ime"})},
+        {Filter("detail", SearchType::Like, {"retry-after"})},
+        {Filter("detail", SearchType::Like, {"b.c"})},
+        {Filter("detail", SearchType::Like, {"error"})},
+        {Filter("detail", SearchType::Like, {"session opened"})},
+        {Filter("detail", SearchType::Equal, {"quota"})},
+        {Filter("detail", SearchType::NotEqual, {"quota"})},
+        {Filter("actor_id", SearchType::Like, {"1042"})},
+        {Filter("actor_id", SearchType::Equal, {"1042"})},
+        {Filter("actor_id", SearchType::Between, {"1100", "1200"})},
+        {Filter("actor_id", SearchType::Outside, {"1100", "1400"})},
+        {Filter("actor_id", SearchType::Above, {"1490"})},
+        {Filter("actor_id", SearchType::Select, {"1001", "1002", "1499"})},
+        {Filter("actor_id", SearchType::SelectExcept, {"1001", "1002"})},
+        {Filter("action", SearchType::Like, {"REPORT"})},
+        {Filter("action", SearchType::Select, {"LOGIN", "LOGOUT"})},
+        {Filter("status", SearchType::Equal, {"RET_ERR_TIMEOUT"})},
+        {Filter("source", SearchType::Like, {"10.0.3."})},
+        {Filter("source", SearchType::BelowOrEqual, {"10.0.1"})},
+        {Filter("actor_type", SearchType::Equal, {"ADMIN"})},
+        {Filter("time", SearchType::Between, {"2023-11-15 06:00:00", "2023-11-15 07:00:00"})},
+        {Filter("time", SearchType::AboveOrEqual, {"1700060000"})},
+        {Filter("time", SearchType::Like, {" 12:"})},
+        {Filter("detail", SearchType::Like, {"user"}),
+         Filter("action", SearchType::Equal, {"LOGIN"}),
+         Filter("actor_id", SearchType::Below, {"1250"})},
+        {Filter("detail", SearchType::Like, {"rare-"}), Filter("source", SearchType::Like, {"10.0"})},
+        {Filter("detail", SearchType::Like, {"no-such-token"})},
+    };
+
+    for (const auto& filters : cases) {
+        CheckSameRows(logs, slice, filters);
+    }
+
+    std::printf("%zu filter sets match\n", cases.size());
+    return 0;
+}
@@ -0,0 +1,294 @@
+// Формат снимка: запись и чтение без потерь, в том числе срезом DayCache над отображением,
+// и отказ открывать обрезанные и поврежденные файлы вместо чтения за пределами отображения
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "cache/DayCache.h"
+#include "common/Check.h"
+#include "snapshots/LogSnapshot.h"
+#include "snapshots/SnapshotFormat.h"
+
+namespace {
+    using namespace snapshots;
+    using namespace snapshots::format;
+
+    constexpr int64_t DAY_FROM   = 1700006400; // 2023-11-15T00:00:00Z
+    constexpr size_t  ROWS       = 1000;
+    constexpr size_t  BLOCK_ROWS = 256;
+
+    // Владелец строк для CompactLog
+    struct TestLog {
+        int64_t     time = 0;
+        std::string time_text;
+        std::string actor_type;
+        std::string actor_id;
+        std::string action;
+        std::string status;
+        std::string source;
+        std::string detail;
+
+        [[nodiscard]] CompactLog View() const {
+            return {time, time_text, actor_type, actor_id, action, status, source, detail};
+        }
+    };
+
+    std::vector<TestLog> MakeLogs() {
+        std::vector<TestLog> logs(ROWS);
+        for (size_t i = 0; i < ROWS; ++i) {
+            TestLog& log = logs[i];
+            char     buffer[HOST_TIME_SIZE];
+
+            log.time       = DAY_FROM + static_cast<int64_t>(i) * 60;
+            log.time_text  = std::string(FormatHostTime(log.time, buffer));
+            log.actor_type = i % 3 == 0 ? "SERVER" : "CLIENT";
+            log.actor_id   = std::to_string(1000 + i % 37);
+            log.action     = i % 2 == 0 ? "LOGIN" : "LOGOUT";
+            log.status     = i % 5 == 0 ? "RET_ERR_TIMEOUT" : "RET_OK";
+            log.source     = "10.0.0." + std::to_string(i % 7);
+            log.detail     = i % 11 == 0 ? "" : "detail, \"quoted\"\nline " + std::to_string(i);
+        }
+
+        // Третий блок хранит исходный текст времени, в том числе нераспознанного
+        logs[2 * BLOCK_ROWS + 3].time_text = "2023-11-15 08:15:00";
+        logs[2 * BLOCK_ROWS + 4].time      = -1;
+        logs[2 * BLOCK_ROWS + 4].time_text = "yesterday";
+        return logs;
+    }
+
+    void WriteLogs(const std::string& path, const std::vector<TestLog>& logs) {
+        LogSnapshotWriter writer(path, BLOCK_ROWS);
+        for (const TestLog& log : logs) {
+            writer.Add(log.View());
+        }
+        writer.Finish();
+    }
+
+    std::string ReadFile(const std::string& path) {
+        std::ifstream input(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+    }
+
+    void WriteFile(const std::string& path, const std::string& data) {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    bool Same(const CompactLog& left, const CompactLog& right) {
+        return left.time == right.time && left.time_text == right.time_text &&
+               left.actor_type == right.actor_type && left.actor_id == right.actor_id &&
+               left.action == right.action && left.status == right.status &&
+               left.source == right.source && left.detail == right.detail;
+    }
+
+    // Текст ошибки открытия; пустой - файл открылся
+    std::string OpenError(const std::string& path, bool is_verify) {
+        try {
+            static_cast<void>(LogSnapshot::Open(path, is_verify));
+        } catch (const std::runtime_error& error) {
+            return error.what();
+        }
+        return "";
+    }
+
+    bool Contains(const std::string& text, const char* part) {
+        return text.find(part) != std::string::npos;
+    }
+
+    // Разбор и правка раскладки в памяти
+    FileHeader Header(const std::string& data) {
+        FileHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        return header;
+    }
+
+    BlockEntry Block(const std::string& data, size_t index) {
+        BlockEntry entry;
+        std::memcpy(&entry, data.data() + Header(data).directory_offset + index * sizeof(entry),
+                    sizeof(entry));
+        return entry;
+    }
+
+    void SetBlock(std::string& data, size_t index, const BlockEntry& entry) {
+        std::memcpy(data.data() + Header(data).directory_offset + index * sizeof(entry), &entry,
+                    sizeof(entry));
+    }
+
+    // По значению: block часто временный (Column(Block(...), ...))
+    ColumnEntry Column(const BlockEntry& block, SnapshotColumn column) {
+        return block.columns[static_cast<size_t>(column)];
+    }
+
+    // Пересчет всех контрольных сумм: повреждение доходит до проверок границ и значений
+    void Reseal(std::string& data) {
+        FileHeader header = Header(data);
+
+        for (size_t i = 0; i < header.blocks; ++i) {
+            BlockEntry block = Block(data, i);
+            for (ColumnEntry& column : block.columns) {
+                if (column.encoding != Encoding::None) {
+                    column.checksum = Checksum(data.data() + column.offset, column.bytes);
+                }
+            }
+            SetBlock(data, i, block);
+        }
+
+        header.directory_checksum =
+            Checksum(data.data() + header.directory_offset, header.blocks * sizeof(BlockEntry));
+        header.header_checksum = Checksum(&header, offsetof(FileHeader, header_checksum));
+        std::memcpy(data.data(), &header, sizeof(header));
+    }
+
+    void TestRoundTrip(const std::string& path, const std::vector<TestLog>& logs) {
+        const LogSnapshot snapshot = LogSnapshot::Open(path);
+
+        CHECK(snapshot.Rows() == ROWS);
+        CHECK(snapshot.Blocks().size() == (ROWS + BLOCK_ROWS - 1) / BLOCK_ROWS);
+        CHECK(!snapshot.IsTimeOrdered()); // строка с -1
+        CHECK(!snapshot.Blocks()[0].HasTimeText());
+        CHECK(snapshot.Blocks()[2].HasTimeText());
+
+        size_t row = 0;
+        for (const SnapshotBlock& block : snapshot.Blocks()) {
+            for (size_t i = 0; i < block.Rows(); ++i, ++row) {
+                CompactLog log = block.Log(i);
+                if (!block.HasTimeText()) {
+                    log.time_text = logs[row].time_text; // канонический текст не хранится
+                }
+                CHECK(Same(log, logs[row].View()));
+            }
+        }
+        CHECK(row == ROWS);
+
+        const std::vector<ReportServerLog> copies = snapshot.ReadLogs();
+        CHECK(copies.size() == ROWS);
+        for (size_t i = 0; i < ROWS; ++i) {
+            CHECK(copies[i].time == logs[i].time_text && copies[i].detail == logs[i].detail);
+        }
+    }
+
+    // Срез DayCache над отображением: те же строки с текстом времени, без копирования
+    void TestSliceOverMapping(const std::string& path, const std::vector<TestLog>& logs) {
+        const LogSlice slice(DAY_FROM, DAY_FROM + 86399, LogSnapshot::Open(path));
+
+        const CompactLogSpan compact = slice.Compact();
+        CHECK(compact.size() == ROWS);
+        for (size_t i = 0; i < ROWS; ++i) {
+            CHECK(Same(compact[i], logs[i].View()));
+        }
+        CHECK(slice.Columns().Value(0, filters::LogColumn::Time) == logs[0].time_text);
+    }
+
+    void TestTruncated(const std::string& path, const std::string& bad) {
+        const std::string data = ReadFile(path);
+
+        for (const size_t size : {size_t{0}, sizeof(FileHeader) / 2, data.size() / 2,
+                                  data.size() - 1}) {
+            WriteFile(bad, data.substr(0, size));
+            CHECK(!OpenError(bad, false).empty());
+            CHECK(!OpenError(bad, true).empty());
+        }
+    }
+
+    void TestChecksumMismatch(const std::string& path, const std::string& bad) {
+        const std::string data = ReadFile(path);
+
+        // Байт значения detail: границы целы, расходится только сумма колонки
+        std::string column = data;
+        column[Column(Block(data, 1), SnapshotColumn::Detail).offset +
+               (BLOCK_ROWS + 1) * sizeof(uint64_t) + 2] ^= 0x20;
+        WriteFile(bad, column);
+        CHECK(Contains(OpenError(bad, true), "column checksum mismatch"));
+        CHECK(OpenError(bad, false).empty());
+
+        std::string header = data;
+        header[offsetof(FileHeader, rows)] ^= 1;
+        WriteFile(bad, header);
+        CHECK(Contains(OpenError(bad, false), "header checksum mismatch"));
+
+        std::string directory = data;
+        directory[Header(data).directory_offset + offsetof(BlockEntry, rows)] ^= 1;
+        WriteFile(bad, directory);
+        CHECK(Contains(OpenError(bad, false), "directory checksum mismatch"));
+    }
+
+    void TestBadOffsets(const std::string& path, const std::string& bad) {
+        const std::string data = ReadFile(path);
+
+        // Секция колонки за концом файла
+        std::string section = data;
+        BlockEntry  block   = Block(section, 0);
+        block.columns[static_cast<size_t>(SnapshotColumn::ActorId)].offset = section.size();
+        SetBlock(section, 0, block);
+        Reseal(section);
+        WriteFile(bad, section);
+        CHECK(Contains(OpenError(bad, false), "column is out of bounds"));
+
+        const uint64_t detail = Column(Block(data, 0), SnapshotColumn::Detail).offset;
+
+        // Последнее смещение строк за концом секции - проверяется и без полной проверки
+        std::string    end  = data;
+        const uint64_t huge = uint64_t{1} << 40;
+        std::memcpy(end.data() + detail + BLOCK_ROWS * sizeof(uint64_t), &huge, sizeof(huge));
+        Reseal(end);
+        WriteFile(bad, end);
+        CHECK(Contains(OpenError(bad, false), "column is truncated"));
+
+        // Убывающие смещения внутри секции
+        std::string order = data;
+        uint64_t    offsets[3];
+        std::memcpy(offsets, order.data() + detail, sizeof(offsets));
+        offsets[1] = offsets[2] + 1;
+        std::memcpy(order.data() + detail, offsets, sizeof(offsets));
+        Reseal(order);
+        WriteFile(bad, order);
+        CHECK(Contains(OpenError(bad, true), "column offsets are not ordered"));
+    }
+
+    void TestDictionaryCodes(const std::string& path, const std::string& bad) {
+        std::string data = ReadFile(path);
+
+        const ColumnEntry status = Column(Block(data, 1), SnapshotColumn::Status);
+        CHECK(status.distinct == 2);
+
+        const uint32_t code = status.distinct;
+        std::memcpy(data.data() + status.offset + 5 * sizeof(uint32_t), &code, sizeof(code));
+        Reseal(data);
+        WriteFile(bad, data);
+        CHECK(Contains(OpenError(bad, true), "dictionary codes are out of range"));
+    }
+} // namespace
+
+int main() {
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() /
+        ("daily_logs_snapshot_test-" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory);
+
+    const std::string path = (directory / "logs.dlsnap").string();
+    const std::string bad  = (directory / "bad.dlsnap").string();
+
+    const std::vector<TestLog> logs = MakeLogs();
+    WriteLogs(path, logs);
+
+    TestRoundTrip(path, logs);
+    TestSliceOverMapping(path, logs);
+    TestTruncated(path, bad);
+    TestChecksumMismatch(path, bad);
+    TestBadOffsets(path, bad);
+    TestDictionaryCodes(path, bad);
+
+    std::filesystem::remove_all(directory);
+
+    std::printf("snapshot format ok\n");
+    return 0;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/LogFiles.h"
+#include "common/StubServer.h"
+#include "snapshots/LogSnapshot.h"
+
+// Хост, отдающий логи из файла генератора (NDJSON или снимок). Упорядоченный по времени
+// снимок обслуживается прямо из отображения: строки копируются только в ответ GetLogs.
+// Остальное загружается в память и сортируется по времени один раз. GetLogs - двоичный
+// поиск по окну, type - точное совпадение actor_type, filter - подстрока в любом поле
+// (так ли ищет filter настоящий хост, не подтверждено - см. filters::HostFilterFromEnvironment)
+class FileServer : public StubServer {
+public:
+    explicit FileServer(const std::string& path) {
+        if (snapshots::IsSnapshotFile(path)) {
+            snapshots::LogSnapshot snapshot = snapshots::LogSnapshot::Open(path);
+            if (snapshot.IsTimeOrdered()) {
+                _snapshot.emplace(std::move(snapshot));
+                return;
+            }
+            _logs = snapshot.ReadLogs();
+        } else {
+            _logs = logfiles::ReadLogFile(path);
+        }
+
+        _times.reserve(_logs.size());
+        for (const auto& log : _logs) {
+            _times.push_back(logfiles::ParseHostTime(log.time));
+        }
+
+        if (!std::is_sorted(_times.begin(), _times.end())) {
+            std::vector<size_t> order(_logs.size());
+            for (size_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+                return _times[a] < _times[b];
+            });
+
+            std::vector<ReportServerLog> logs;
+            std::vector<int64_t>         times;
+            logs.reserve(_logs.size());
+            times.reserve(_times.size());
+            for (const size_t i : order) {
+                logs.push_back(std::move(_logs[i]));
+                times.push_back(_times[i]);
+            }
+            _logs.swap(logs);
+            _times.swap(times);
+        }
+    }
+
+    int GetLogs(time_t                        from,
+                time_t                        to,
+                const std::string&            type,
+                const std::string&            filter,
+                std::vector<ReportServerLog>* logs) override {
+        if (_snapshot)
+            return GetSnapshotLogs(from, to, type, filter, logs);
+
+        const auto begin = std::lower_bound(_times.begin(), _times.end(), from);
+        const auto end   = std::upper_bound(begin, _times.end(), to);
+
+        for (auto it = begin; it != end; ++it) {
+            const ReportServerLog& log = _logs[it - _times.begin()];
+            if (!type.empty() && log.actor_type != type)
+                continue;
+            if (!filter.empty() && !Contains(log, filter))
+                continue;
+            logs->push_back(log);
+        }
+        return 0;
+    }
+
+    [[nodiscard]] size_t Size() const {
+        return _snapshot ? static_cast<size_t>(_snapshot->Rows()) : _logs.size();
+    }
+
+private:
+    std::optional<snapshots::LogSnapshot> _snapshot;
+    std::vector<ReportServerLog>          _logs;
+    std::vector<int64_t>                  _times;
+
+    int GetSnapshotLogs(time_t                        from,
+                        time_t                        to,
+                        const std::string&            type,
+                        const std::string&            filter,
+                        std::vector<ReportServerLog>* logs) const {
+        for (const snapshots::SnapshotBlock& block : _snapshot->Blocks()) {
+            if (block.MaxTime() < from || block.MinTime() > to)
+                continue;
+
+            // type сравнивается по коду словаря блока
+            const snapshots::SnapshotDictionary& actor_types = block.ActorType();
+            uint32_t                             type_code   = actor_types.Size();
+            for (uint32_t code = 0; code < actor_types.Size() && !type.empty(); ++code) {
+                if (actor_types.Entry(code) == type) {
+                    type_code = code;
+                }
+            }
+            if (!type.empty() && type_code == actor_types.Size())
+                continue;
+
+            const auto times = block.Times();
+            const auto begin = std::lower_bound(times.begin(), times.end(), from);
+            const auto end   = std::upper_bound(begin, times.end(), to);
+
+            for (auto it = begin; it != end; ++it) {
+                const size_t row = static_cast<size_t>(it - times.begin());
+                if (!type.empty() && actor_types.Code(row) != type_code)
+                    continue;
+                if (!filter.empty() && !Contains(block, row, filter))
+                    continue;
+                logs->push_back(block.ToReportServerLog(row));
+            }
+        }
+        return 0;
+    }
+
+    static bool Contains(const snapshots::SnapshotBlock& block,
+                         size_t                          row,
+                         const std::string&              filter) {
+        char                   buffer[snapshots::HOST_TIME_SIZE];
+        const CompactLog       log  = block.Log(row);
+        const std::string_view time = block.HasTimeText()
+                                          ? log.time_text
+                                          : snapshots::FormatHostTime(log.time, buffer);
+
+        for (const std::string_view field :
+             {time, log.actor_type, log.actor_id, log.action, log.status, log.source, log.detail}) {
+            if (field.find(filter) != std::string_view::npos)
+                return true;
+        }
+        return false;
+    }
+
+    static bool Contains(const ReportServerLog& log, const std::string& filter) {
+        for (const std::string* field : {&log.time,
+                                         &log.actor_type,
+                                         &log.actor_id,
+                                         &log.action,
+                                         &log.status,
+                                         &log.source,
+                                         &log.detail}) {
+            if (field->find(filter) != std::string::npos)
+                return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <rapidjson/document.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "snapshots/LogSnapshot.h"
+#include "structures/CompactLog.h"
+
+// Файлы логов для инструментов: генератор пишет, хосты-заглушки читают.
+//
+// NDJSON - по объекту на строку с полями ReportServerLog.
+//
+// Снимок - колоночный формат snapshots::LogSnapshot: его же читает дисковый кеш дней
+namespace logfiles {
+    // Буфер записи: fwrite крупными кусками
+    inline constexpr size_t WRITE_BUFFER_BYTES = 1 << 20;
+
+    // Строка без владения: генератор собирает поля из заранее подготовленных пулов,
+    // time_text - "YYYY-MM-DDTHH:MM:SSZ"
+    using LogRowView = CompactLog;
+
+    // Время в формате хоста: "YYYY-MM-DDTHH:MM:SSZ"
+    inline std::string FormatHostTime(int64_t timestamp) {
+        const time_t time = static_cast<time_t>(timestamp);
+        std::tm      tm{};
+        gmtime_r(&time, &tm);
+
+        char         buffer[32];
+        const size_t size = std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return std::string(buffer, size);
+    }
+
+    // Обратное к FormatHostTime; допускается и пробел вместо 'T'. -1 - не время
+    inline int64_t ParseHostTime(std::string_view text) {
+        if (text.size() < 19 || text[4] != '-' || text[7] != '-' ||
+            (text[10] != 'T' && text[10] != ' ') || text[13] != ':' || text[16] != ':')
+            return -1;
+
+        auto number = [text](size_t pos, size_t count) {
+            int64_t value = 0;
+            for (size_t i = pos; i < pos + count; ++i) {
+                if (text[i] < '0' || text[i] > '9')
+                    return int64_t{-1};
+                value = value * 10 + (text[i] - '0');
+            }
+            return value;
+        };
+
+        const int64_t year   = number(0, 4);
+        const int64_t month  = number(5, 2);
+        const int64_t day    = number(8, 2);
+        const int64_t hour   = number(11, 2);
+        const int64_t minute = number(14, 2);
+        const int64_t second = number(17, 2);
+        if (year < 0 || month < 1 || month > 12 || day < 1 || hour < 0 || minute < 0 ||
+            second < 0)
+            return -1;
+
+        // Дни от 1970-01-01 по пролептическому григорианскому календарю
+        const int64_t shifted_year = month <= 2 ? year - 1 : year;
+        const int64_t era          = shifted_year / 400;
+        const int64_t year_of_era  = shifted_year - era * 400;
+        const int64_t day_of_year  = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t day_of_era =
+            year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        const int64_t days = era * 146097 + day_of_era - 719468;
+
+        return days * 86400 + hour * 3600 + minute * 60 + second;
+    }
+
+    struct FileCloser {
+        void operator()(std::FILE* file) const { std::fclose(file); }
+    };
+
+    using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+    inline FilePtr OpenFile(const std::string& path, const char* mode) {
+        FilePtr file(std::fopen(path.c_str(), mode));
+        if (!file)
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        return file;
+    }
+
+    class BufferedWriter {
+    public:
+        explicit BufferedWriter(const std::string& path) : _file(OpenFile(path, "wb")) {
+            _buffer.reserve(WRITE_BUFFER_BYTES + 4096);
+        }
+
+        ~BufferedWriter() {
+            if (_file) {
+                std::fwrite(_buffer.data(), 1, _buffer.size(), _file.get());
+            }
+        }
+
+        void Append(std::string_view bytes) {
+            _buffer.append(bytes);
+            if (_buffer.size() >= WRITE_BUFFER_BYTES) {
+                Flush();
+            }
+        }
+
+        void Flush() {
+            if (std::fwrite(_buffer.data(), 1, _buffer.size(), _file.get()) != _buffer.size())
+                throw std::runtime_error("write failed");
+            _buffer.clear();
+        }
+
+        [[nodiscard]] std::FILE* File() { return _file.get(); }
+
+    protected:
+        FilePtr     _file;
+        std::string _buffer;
+    };
+
+    class NdjsonWriter : public BufferedWriter {
+    public:
+        using BufferedWriter::BufferedWriter;
+
+        void Write(const LogRowView& row) {
+            _line.clear();
+            _line += "{\"time\":\"";
+            _line += row.time_text;
+            AppendField("actor_type", row.actor_type);
+            AppendField("actor_id", row.actor_id);
+            AppendField("action", row.action);
+            AppendField("status", row.status);
+            AppendField("source", row.source);
+            AppendField("detail", row.detail);
+            _line += "\"}\n";
+            Append(_line);
+        }
+
+    private:
+        std::string _line;
+
+        void AppendField(std::string_view name, std::string_view value) {
+            _line += "\",\"";
+            _line += name;
+            _line += "\":\"";
+            for (const char c : value) {
+                if (c == '"' || c == '\\') {
+                    _line += '\\';
+                    _line += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    _line += escaped;
+                } else {
+                    _line += c;
+                }
+            }
+        }
+    };
+
+    namespace detail {
+        inline std::string StringMember(const rapidjson::Value& object, const char* name) {
+            const auto member = object.FindMember(name);
+            return member != object.MemberEnd() && member->value.IsString()
+                       ? std::string(member->value.GetString(), member->value.GetStringLength())
+                       : std::string();
+        }
+
+        inline void ReadNdjson(std::FILE* file, std::vector<ReportServerLog>* logs) {
+            std::string line;
+            char        chunk[64 * 1024];
+            size_t      line_number = 0;
+
+            auto parse_line = [&]() {
+                ++line_number;
+                if (line.empty())
+                    return;
+
+                rapidjson::Document document;
+                document.Parse(line.data(), line.size());
+                if (document.HasParseError() || !document.IsObject())
+                    throw std::runtime_error("invalid NDJSON at line " +
+                                             std::to_string(line_number));
+
+                ReportServerLog log;
+                log.time       = StringMember(document, "time");
+                log.actor_type = StringMember(document, "actor_type");
+                log.actor_id   = StringMember(document, "actor_id");
+                log.action     = StringMember(document, "action");
+                log.status     = StringMember(document, "status");
+                log.source     = StringMember(document, "source");
+                log.detail     = StringMember(document, "detail");
+                logs->push_back(std::move(log));
+                line.clear();
+            };
+
+            while (std::fgets(chunk, sizeof(chunk), file) != nullptr) {
+                line += chunk;
+                if (!line.empty() && line.back() == '\n') {
+                    line.pop_back();
+                    parse_line();
+                }
+            }
+            parse_line();
+        }
+    } // namespace detail
+
+    // Формат определяется по началу файла; ошибки - std::runtime_error
+    inline std::vector<ReportServerLog> ReadLogFile(const std::string& path) {
+        FilePtr file = OpenFile(path, "rb");
+
+        if (snapshots::IsSnapshotFile(path))
+            return snapshots::LogSnapshot::Open(path).ReadLogs();
+
+        std::vector<ReportServerLog> logs;
+        detail::ReadNdjson(file.get(), &logs);
+        return logs;
+    }
+} // namespace logfiles
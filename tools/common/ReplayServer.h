@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <rapidjson/document.h>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/LogFiles.h"
+#include "common/StubServer.h"
+#include "snapshots/LogSnapshot.h"
+
+// Хост, воспроизводящий запись capture::CaptureWriter: GetLogs с теми же аргументами, что
+// при записи, получает те же строки и код. Повторы вызова с одинаковыми аргументами
+// отдаются по кругу в порядке записи, поэтому отчет можно выполнить много раз. Вызов без
+// пары в записи возвращает пустой ответ и считается в Misses
+class ReplayServer : public StubServer {
+public:
+    // manifest_path - capture-*.json; снимок ищется рядом с ним
+    explicit ReplayServer(const std::string& manifest_path) {
+        const rapidjson::Document manifest = ReadManifest(manifest_path);
+
+        const size_t      slash     = manifest_path.find_last_of('/');
+        const std::string directory = slash == std::string::npos
+                                          ? std::string(".")
+                                          : manifest_path.substr(0, slash);
+        _snapshot.emplace(snapshots::LogSnapshot::Open(
+            directory + "/" + manifest["snapshot"].GetString()));
+
+        uint64_t block_start = 0;
+        for (const snapshots::SnapshotBlock& block : _snapshot->Blocks()) {
+            _block_starts.push_back(block_start);
+            block_start += block.Rows();
+        }
+
+        _request.CopyFrom(manifest["request"], _request.GetAllocator());
+
+        for (const auto& call : manifest["calls"].GetArray()) {
+            const CallKey key{call["from"].GetInt64(),
+                              call["to"].GetInt64(),
+                              call["type"].GetString(),
+                              call["filter"].GetString()};
+            const RecordedCall recorded{call["result"].GetInt(),
+                                        call["first_row"].GetUint64(),
+                                        call["rows"].GetUint64()};
+            if (recorded.first_row + recorded.rows > _snapshot->Rows())
+                throw std::runtime_error(manifest_path + ": call rows are out of the snapshot");
+
+            _calls[key].push_back(recorded);
+            ++_calls_count;
+        }
+    }
+
+    int GetLogs(time_t                        from,
+                time_t                        to,
+                const std::string&            type,
+                const std::string&            filter,
+                std::vector<ReportServerLog>* logs) override {
+        RecordedCall recorded{};
+        {
+            std::lock_guard lock(_mutex);
+
+            const auto it = _calls.find(CallKey{from, to, type, filter});
+            if (it == _calls.end()) {
+                ++_misses;
+                return 0;
+            }
+
+            size_t& cursor = _cursors[it->first];
+            recorded       = it->second[cursor];
+            cursor         = (cursor + 1) % it->second.size();
+        }
+
+        logs->reserve(logs->size() + recorded.rows);
+        for (uint64_t row = recorded.first_row; row < recorded.first_row + recorded.rows; ++row) {
+            const size_t block = static_cast<size_t>(
+                std::upper_bound(_block_starts.begin(), _block_starts.end(), row) -
+                _block_starts.begin() - 1);
+            logs->push_back(
+                _snapshot->Blocks()[block].ToReportServerLog(row - _block_starts[block]));
+        }
+        return recorded.result;
+    }
+
+    // Записанный запрос; __access обезличен
+    [[nodiscard]] const rapidjson::Document& Request() const { return _request; }
+
+    [[nodiscard]] size_t Size() const { return static_cast<size_t>(_snapshot->Rows()); }
+    [[nodiscard]] size_t Calls() const { return _calls_count; }
+
+    [[nodiscard]] size_t Misses() const {
+        std::lock_guard lock(_mutex);
+        return _misses;
+    }
+
+private:
+    using CallKey = std::tuple<int64_t, int64_t, std::string, std::string>;
+
+    struct RecordedCall {
+        int      result    = 0;
+        uint64_t first_row = 0;
+        uint64_t rows      = 0;
+    };
+
+    std::optional<snapshots::LogSnapshot> _snapshot;
+    std::vector<uint64_t>                 _block_starts;
+    rapidjson::Document                   _request;
+
+    std::map<CallKey, std::vector<RecordedCall>> _calls;
+    size_t                                       _calls_count = 0;
+
+    mutable std::mutex        _mutex;
+    std::map<CallKey, size_t> _cursors;
+    size_t                    _misses = 0;
+
+    static rapidjson::Document ReadManifest(const std::string& path) {
+        logfiles::FilePtr file = logfiles::OpenFile(path, "rb");
+
+        std::string text;
+        char        chunk[64 * 1024];
+        size_t      read = 0;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file.get())) > 0) {
+            text.append(chunk, read);
+        }
+
+        rapidjson::Document manifest;
+        manifest.Parse(text.c_str());
+        if (manifest.HasParseError() || !manifest.IsObject() ||
+            !manifest.HasMember("snapshot") || !manifest["snapshot"].IsString() ||
+            !manifest.HasMember("request") || !manifest.HasMember("calls") ||
+            !manifest["calls"].IsArray())
+            throw std::runtime_error(path + ": not a capture manifest");
+        return manifest;
+    }
+};
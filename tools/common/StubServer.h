@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ReportServerInterface.h"
+
+// Основа хостов для инструментов: все методы, кроме GetLogs, возвращают 0 без данных
+class StubServer : public ReportServerInterface {
+public:
+    int GetAccountsByGroup(const std::string&, std::vector<ReportAccountRecord>*) override {
+        return 0;
+    }
+    int GetAccountByLogin(int, ReportAccountRecord*) override { return 0; }
+    int GetAccountBalanceByLogin(int, ReportMarginLevel*) override { return 0; }
+    int GetMarginLevelByGroup(const std::string&, std::vector<ReportMarginLevel>*) override {
+        return 0;
+    }
+    int GetAccountsEquitiesByGroup(time_t,
+                                   time_t,
+                                   const std::string&,
+                                   std::vector<ReportEquityRecord>*) override {
+        return 0;
+    }
+    int GetAccountsEquitiesByLogin(time_t, time_t, int, std::vector<ReportEquityRecord>*) override {
+        return 0;
+    }
+
+    int GetOpenTradesByLogin(int, std::vector<ReportTradeRecord>*) override { return 0; }
+    int GetPendingTradesByLogin(int, std::vector<ReportTradeRecord>*) override { return 0; }
+    int GetOpenTradesByMagic(int, std::vector<ReportTradeRecord>*) override { return 0; }
+    int GetOpenTradeByOrder(int, ReportTradeRecord*) override { return 0; }
+    int GetOpenTradeByGwUUID(const std::string&, ReportTradeRecord*) override { return 0; }
+    int GetCloseTradeByGwUUID(const std::string&, ReportTradeRecord*) override { return 0; }
+    int GetOpenTradeByGwOrder(const std::string&, ReportTradeRecord*) override { return 0; }
+    int GetCloseTradeByGwOrder(const std::string&, ReportTradeRecord*) override { return 0; }
+    int GetCloseTradesByLogin(int, std::vector<ReportTradeRecord>*) override { return 0; }
+    int GetCloseTradesByGroup(const std::string&,
+                              time_t,
+                              time_t,
+                              std::vector<ReportTradeRecord>*) override {
+        return 0;
+    }
+    int GetPendingTradesByGroup(const std::string&,
+                                time_t,
+                                time_t,
+                                std::vector<ReportTradeRecord>*) override {
+        return 0;
+    }
+    int GetOpenTradesByGroup(const std::string&,
+                             time_t,
+                             time_t,
+                             std::vector<ReportTradeRecord>*) override {
+        return 0;
+    }
+    int GetAllOpenTrades(std::vector<ReportTradeRecord>*) override { return 0; }
+    int GetTransactionsByGroup(const std::string&,
+                               time_t,
+                               time_t,
+                               std::vector<ReportTradeRecord>*) override {
+        return 0;
+    }
+    int GetTransactionsByLogin(int, time_t, time_t, std::vector<ReportTradeRecord>*) override {
+        return 0;
+    }
+
+    int CalculateCommission(const ReportTradeRecord&, double*) override { return 0; }
+    int CalculateSwap(const ReportTradeRecord&, double*) override { return 0; }
+    int CalculateProfit(const ReportTradeRecord&, double*) override { return 0; }
+    int CalculateMargin(const ReportTradeRecord&, double*) override { return 0; }
+    int CalculateConvertRateByCurrency(const std::string&,
+                                       const std::string&,
+                                       int,
+                                       double*) override {
+        return 0;
+    }
+
+    int GetSymbol(const std::string&, ReportSymbolRecord*) override { return 0; }
+    int MatchWildCardGroup(const std::string&, const std::string&) override { return 0; }
+    int GetGroup(const std::string&, ReportGroupRecord*) override { return 0; }
+    int GetAllGroups(std::vector<ReportGroupRecord>*) override { return 0; }
+
+    int GetCandles(const std::string&,
+                   const std::string&,
+                   time_t,
+                   time_t,
+                   std::vector<ReportCandleRecord>*) override {
+        return 0;
+    }
+};
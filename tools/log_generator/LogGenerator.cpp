@@ -0,0 +1,671 @@
+// Генератор синтетических логов хоста для нагрузочных тестов и бенчмарков.
+//
+// Строки идут в порядке времени, минута за минутой: у каждого типа участника свой средний
+// поток (строк в час) с суточным ритмом, участники и IP выбираются по закону Ципфа, поверх
+// идут всплески флуда одного клиента. Результат определяется только параметрами и seed.
+//
+//   log_generator [--ndjson PATH] [--snapshot PATH] [--start UNIX] [--days N] [--rows N]
+//                 [--client-rate N] [--manager-rate N] [--system-rate N]
+//                 [--clients N] [--managers N] [--ips N] [--zipf S]
+//                 [--error-ratio R] [--floods-per-day N] [--flood-rows N] [--seed N]
+//
+// --rows пересчитывает rate так, чтобы ожидаемый объем был N строк. Нужен хотя бы один
+// из --ndjson / --snapshot; оба пишутся за один проход. --snapshot - колоночный снимок
+// snapshots::LogSnapshot, его же читают FileServer и дисковый кеш дней.
+// В сборке Release - около миллиона строк в секунду на оба формата
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/LogFiles.h"
+#include "snapshots/LogSnapshot.h"
+
+namespace {
+    constexpr int64_t SECONDS_PER_MINUTE = 60;
+    constexpr int64_t MINUTES_PER_DAY    = 24 * 60;
+    constexpr int64_t MINUTES_PER_WEEK   = 7 * MINUTES_PER_DAY;
+    constexpr double  PI                 = 3.14159265358979323846;
+
+    struct GeneratorOptions {
+        std::string ndjson_path;
+        std::string snapshot_path;
+        int64_t     start          = 1699401600; // неделя перед 2023-11-15, как в fetch_demo
+        int64_t     days           = 8;
+        double      rows           = 0; // 0 - объем задают rate
+        double      client_rate    = 20000;
+        double      manager_rate   = 600;
+        double      system_rate    = 3000;
+        uint32_t    clients        = 50000;
+        uint32_t    managers       = 40;
+        uint32_t    ips            = 30000;
+        double      zipf           = 1.1;
+        double      error_ratio    = 0.03;
+        double      floods_per_day = 3;
+        double      flood_rows     = 20000;
+        uint64_t    seed           = 1;
+    };
+
+    // xoshiro256**: собственный генератор, чтобы результат не зависел от стандартной
+    // библиотеки (распределения std:: между реализациями различаются)
+    class Random {
+    public:
+        explicit Random(uint64_t seed) {
+            for (auto& word : _state) {
+                seed += 0x9E3779B97F4A7C15ULL;
+                word = Mix(seed);
+            }
+        }
+
+        static uint64_t Mix(uint64_t value) {
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+            return value ^ (value >> 31);
+        }
+
+        uint64_t Next() {
+            const uint64_t result = Rotate(_state[1] * 5, 7) * 9;
+            const uint64_t t      = _state[1] << 17;
+
+            _state[2] ^= _state[0];
+            _state[3] ^= _state[1];
+            _state[1] ^= _state[2];
+            _state[0] ^= _state[3];
+            _state[2] ^= t;
+            _state[3] = Rotate(_state[3], 45);
+            return result;
+        }
+
+        // [0, 1)
+        double Uniform() { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+
+        // [0, bound)
+        uint32_t Below(uint32_t bound) {
+            return static_cast<uint32_t>((static_cast<unsigned __int128>(Next()) * bound) >> 64);
+        }
+
+        double Normal() {
+            const double u = 1.0 - Uniform();
+            const double v = Uniform();
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * v);
+        }
+
+        // Для больших средних - нормальное приближение
+        uint32_t Poisson(double mean) {
+            if (mean <= 0)
+                return 0;
+
+            if (mean > 30) {
+                const double value = std::round(mean + std::sqrt(mean) * Normal());
+                return value > 0 ? static_cast<uint32_t>(value) : 0;
+            }
+
+            const double limit   = std::exp(-mean);
+            double       product = Uniform();
+            uint32_t     count   = 0;
+            while (product > limit) {
+                product *= Uniform();
+                ++count;
+            }
+            return count;
+        }
+
+    private:
+        std::array<uint64_t, 4> _state{};
+
+        static uint64_t Rotate(uint64_t value, int shift) {
+            return (value << shift) | (value >> (64 - shift));
+        }
+    };
+
+    // Выбор по таблице псевдонимов (Vose): O(1) на выборку при любом числе вариантов
+    class AliasTable {
+    public:
+        explicit AliasTable(const std::vector<double>& weights)
+            : _probability(weights.size()), _alias(weights.size()) {
+            double total = 0;
+            for (const double weight : weights) {
+                total += weight;
+            }
+
+            std::vector<double>   scaled(weights.size());
+            std::vector<uint32_t> small;
+            std::vector<uint32_t> large;
+            for (uint32_t i = 0; i < weights.size(); ++i) {
+                scaled[i] = weights[i] * static_cast<double>(weights.size()) / total;
+                (scaled[i] < 1.0 ? small : large).push_back(i);
+            }
+
+            while (!small.empty() && !large.empty()) {
+                const uint32_t less = small.back();
+                const uint32_t more = large.back();
+                small.pop_back();
+
+                _probability[less] = scaled[less];
+                _alias[less]       = more;
+
+                scaled[more] += scaled[less] - 1.0;
+                if (scaled[more] < 1.0) {
+                    large.pop_back();
+                    small.push_back(more);
+                }
+            }
+            for (const uint32_t i : large) {
+                _probability[i] = 1.0;
+            }
+            for (const uint32_t i : small) {
+                _probability[i] = 1.0;
+            }
+        }
+
+        static AliasTable Zipf(uint32_t count, double exponent) {
+            std::vector<double> weights(count);
+            for (uint32_t rank = 0; rank < count; ++rank) {
+                weights[rank] = 1.0 / std::pow(rank + 1.0, exponent);
+            }
+            return AliasTable(weights);
+        }
+
+        uint32_t Sample(Random& random) const {
+            const uint32_t column = random.Below(static_cast<uint32_t>(_probability.size()));
+            return random.Uniform() < _probability[column] ? column : _alias[column];
+        }
+
+    private:
+        std::vector<double>   _probability;
+        std::vector<uint32_t> _alias;
+    };
+
+    struct WeightedValue {
+        std::string_view value;
+        double           weight;
+    };
+
+    // Небольшой словарь значений с весами
+    class Choice {
+    public:
+        explicit Choice(std::vector<WeightedValue> values)
+            : _values(std::move(values)), _table(Weights(_values)) {}
+
+        std::string_view Sample(Random& random) const {
+            return _values[_table.Sample(random)].value;
+        }
+
+    private:
+        std::vector<WeightedValue> _values;
+        AliasTable                 _table;
+
+        static std::vector<double> Weights(const std::vector<WeightedValue>& values) {
+            std::vector<double> weights;
+            weights.reserve(values.size());
+            for (const auto& value : values) {
+                weights.push_back(value.weight);
+            }
+            return weights;
+        }
+    };
+
+    enum class Actor : uint8_t { Client, Manager, System, Flood };
+
+    constexpr std::string_view ACTOR_TYPES[] = {"CLIENT", "MANAGER", "SYSTEM", "CLIENT"};
+
+    const Choice CLIENT_ACTIONS({{"login", 10},
+                                 {"logout", 9},
+                                 {"order_open", 25},
+                                 {"order_close", 20},
+                                 {"order_modify", 14},
+                                 {"quote_request", 18},
+                                 {"history_request", 3.5},
+                                 {"password_change", 0.5}});
+
+    const Choice MANAGER_ACTIONS({{"login", 5},
+                                  {"logout", 5},
+                                  {"account_update", 30},
+                                  {"balance_operation", 20},
+                                  {"group_change", 5},
+                                  {"report_request", 20},
+                                  {"order_modify", 15}});
+
+    const Choice SYSTEM_ACTIONS({{"gateway_heartbeat", 35},
+                                 {"datafeed_sync", 30},
+                                 {"session_timeout", 25},
+                                 {"backup", 5},
+                                 {"config_reload", 3},
+                                 {"plugin_load", 2}});
+
+    const Choice FLOOD_ACTIONS({{"quote_request", 70}, {"login", 30}});
+
+    const Choice NORMAL_STATUSES({{"RET_OK", 80}, {"RET_OK_NONE", 10}, {"RET_TRADE_ACCEPTED", 10}});
+
+    const Choice FAILED_STATUSES({{"RET_TIMEOUT", 25},
+                                  {"RET_TOO_FREQUENT", 15},
+                                  {"RET_TRADE_REQUOTE", 15},
+                                  {"RET_ERROR", 20},
+                                  {"invalid", 10},
+                                  {"denied", 10},
+                                  {"RET_TECH_PROBLEM", 2.5},
+                                  {"RET_ERR_NETWORK", 1.5},
+                                  {"RET_NO_CONNECT", 1}});
+
+    const Choice FLOOD_STATUSES({{"RET_TOO_FREQUENT", 60}, {"RET_OK", 40}});
+
+    const Choice SYSTEM_SOURCES(
+        {{"core", 40}, {"datafeed", 30}, {"gateway", 20}, {"backup", 5}, {"scheduler", 5}});
+
+    const Choice TERMINALS({{"desktop", 35},
+                            {"android", 25},
+                            {"iphone", 20},
+                            {"web", 12},
+                            {"rest", 5},
+                            {"fix", 2},
+                            {"tcp", 1}});
+
+    constexpr std::string_view DETAIL_WORDS[] = {
+        "order",   "symbol",   "EURUSD",  "volume",  "price",   "request", "account", "group",
+        "margin",  "balance",  "ticket",  "session", "quote",   "server",  "timeout", "retry",
+        "gateway", "position", "closed",  "opened",  "updated", "limit",   "stop",    "deal",
+        "XAUUSD",  "GBPJPY",   "leverage", "equity", "history", "report",  "sync",    "queue"};
+
+    // Суточный ритм типа участника на каждую минуту недели; среднее по неделе - 1
+    std::vector<double> WeeklyProfile(Actor actor) {
+        std::vector<double> profile(MINUTES_PER_WEEK);
+        double              total = 0;
+
+        for (int64_t minute = 0; minute < MINUTES_PER_WEEK; ++minute) {
+            const double hour = static_cast<double>(minute % MINUTES_PER_DAY) / 60.0;
+            // Минута недели считается от 1970-01-01, четверга; 0 - воскресенье
+            const int64_t weekday    = (minute / MINUTES_PER_DAY + 4) % 7;
+            const bool    is_weekend = weekday == 0 || weekday == 6;
+
+            double factor = 1.0;
+            switch (actor) {
+                case Actor::Client:
+                    factor = (1.0 + 0.7 * std::cos(2.0 * PI * (hour - 14.0) / 24.0)) *
+                             (is_weekend ? 0.55 : 1.0);
+                    break;
+                case Actor::Manager:
+                    factor = hour >= 8 && hour < 19 && !is_weekend ? 1.0 : 0.08;
+                    break;
+                case Actor::System:
+                    factor = hour >= 3 && hour < 4 ? 4.0 : 1.0; // ночное обслуживание
+                    break;
+                case Actor::Flood:
+                    break;
+            }
+
+            profile[minute] = factor;
+            total += factor;
+        }
+
+        const double mean = total / static_cast<double>(MINUTES_PER_WEEK);
+        for (double& factor : profile) {
+            factor /= mean;
+        }
+        return profile;
+    }
+
+    struct Flood {
+        int64_t  first_minute    = 0;
+        int64_t  minutes         = 0;
+        double   rows_per_minute = 0;
+        uint32_t client          = 0;
+        uint32_t ip              = 0;
+    };
+
+    // Ожидаемый объем при заданных rate
+    double ExpectedRows(const GeneratorOptions& options) {
+        const double days = static_cast<double>(options.days);
+        return days * 24 * (options.client_rate + options.manager_rate + options.system_rate) +
+               days * options.floods_per_day * options.flood_rows;
+    }
+
+    // Минута генерации: секунда строки и ее источник (для флуда - номер всплеска)
+    struct PendingRow {
+        uint8_t  second;
+        Actor    actor;
+        uint32_t flood;
+
+        bool operator<(const PendingRow& other) const { return second < other.second; }
+    };
+
+    class LogGenerator {
+    public:
+        explicit LogGenerator(const GeneratorOptions& options)
+            : _options(options), _random(options.seed),
+              _clients(AliasTable::Zipf(options.clients, options.zipf)),
+              _managers(AliasTable::Zipf(options.managers, options.zipf)),
+              _ips(AliasTable::Zipf(options.ips, options.zipf)) {
+            _profiles = {WeeklyProfile(Actor::Client),
+                         WeeklyProfile(Actor::Manager),
+                         WeeklyProfile(Actor::System)};
+
+            for (uint32_t i = 0; i < options.clients; ++i) {
+                _client_ids.push_back(std::to_string(100000 + i));
+            }
+            for (uint32_t i = 0; i < options.managers; ++i) {
+                _manager_ids.push_back(std::to_string(1 + i));
+            }
+            for (uint32_t i = 0; i < options.ips; ++i) {
+                _ip_addresses.push_back(IpAddress(i));
+            }
+
+            // Текст для detail: длинная строка из слов, detail - ее кусок со случайного места
+            while (_corpus.size() < 256 * 1024) {
+                if (!_corpus.empty()) {
+                    _corpus += ' ';
+                }
+                _corpus += DETAIL_WORDS[_random.Below(std::size(DETAIL_WORDS))];
+                if (_random.Below(4) == 0) {
+                    _corpus += '=';
+                    _corpus += std::to_string(_random.Below(100000));
+                }
+            }
+
+            PlanFloods();
+        }
+
+        template <typename Sink>
+        uint64_t Run(Sink&& sink) {
+            const std::array<double, 3> rates_per_minute = {_options.client_rate / 60,
+                                                            _options.manager_rate / 60,
+                                                            _options.system_rate / 60};
+
+            std::vector<PendingRow> pending;
+            uint64_t                rows = 0;
+
+            for (int64_t minute = 0; minute < _options.days * MINUTES_PER_DAY; ++minute) {
+                const int64_t minute_start = _options.start + minute * SECONDS_PER_MINUTE;
+                const int64_t week_minute =
+                    (minute_start / SECONDS_PER_MINUTE) % MINUTES_PER_WEEK;
+
+                pending.clear();
+                for (size_t actor = 0; actor < rates_per_minute.size(); ++actor) {
+                    const uint32_t count =
+                        _random.Poisson(rates_per_minute[actor] * _profiles[actor][week_minute]);
+                    for (uint32_t i = 0; i < count; ++i) {
+                        pending.push_back({static_cast<uint8_t>(_random.Below(60)),
+                                           static_cast<Actor>(actor),
+                                           0});
+                    }
+                }
+
+                for (uint32_t flood = 0; flood < _floods.size(); ++flood) {
+                    const Flood& burst = _floods[flood];
+                    if (minute < burst.first_minute || minute >= burst.first_minute + burst.minutes)
+                        continue;
+
+                    const uint32_t count = _random.Poisson(burst.rows_per_minute);
+                    for (uint32_t i = 0; i < count; ++i) {
+                        pending.push_back(
+                            {static_cast<uint8_t>(_random.Below(60)), Actor::Flood, flood});
+                    }
+                }
+
+                std::stable_sort(pending.begin(), pending.end());
+
+                // Префикс "YYYY-MM-DDTHH:MM:" общий для минуты
+                std::string time_text = logfiles::FormatHostTime(minute_start);
+                for (const PendingRow& row : pending) {
+                    time_text[17] = static_cast<char>('0' + row.second / 10);
+                    time_text[18] = static_cast<char>('0' + row.second % 10);
+
+                    sink(MakeRow(minute_start + row.second, time_text, row));
+                    ++rows;
+                }
+            }
+
+            return rows;
+        }
+
+    private:
+        GeneratorOptions _options;
+        Random           _random;
+
+        AliasTable _clients;
+        AliasTable _managers;
+        AliasTable _ips;
+
+        std::array<std::vector<double>, 3> _profiles;
+
+        std::vector<std::string> _client_ids;
+        std::vector<std::string> _manager_ids;
+        std::vector<std::string> _ip_addresses;
+        std::string              _corpus;
+        std::vector<Flood>       _floods;
+
+        std::string _detail; // собирается заново для каждой строки
+
+        static std::string IpAddress(uint32_t index) {
+            const uint64_t hash = Random::Mix(index + 0x5BD1E995ULL);
+
+            uint32_t first = 1 + static_cast<uint32_t>(hash % 223);
+            if (first == 10 || first == 127) {
+                ++first;
+            }
+            return std::to_string(first) + "." + std::to_string((hash >> 8) & 0xFF) + "." +
+                   std::to_string((hash >> 16) & 0xFF) + "." +
+                   std::to_string(1 + (hash >> 24) % 254);
+        }
+
+        void PlanFloods() {
+            for (int64_t day = 0; day < _options.days; ++day) {
+                const uint32_t count = _random.Poisson(_options.floods_per_day);
+                for (uint32_t i = 0; i < count; ++i) {
+                    Flood flood;
+                    flood.minutes      = 1 + _random.Below(10);
+                    flood.first_minute = day * MINUTES_PER_DAY +
+                                         _random.Below(MINUTES_PER_DAY - flood.minutes);
+                    flood.rows_per_minute = _options.flood_rows * (0.5 + _random.Uniform()) /
+                                            static_cast<double>(flood.minutes);
+                    // Флудит обычно не самый активный клиент
+                    flood.client = _random.Below(_options.clients);
+                    flood.ip     = _random.Below(_options.ips);
+                    _floods.push_back(flood);
+                }
+            }
+        }
+
+        // Клиент чаще всего заходит со "своего" адреса
+        uint32_t ClientIp(uint32_t client) {
+            if (_random.Below(100) < 85)
+                return static_cast<uint32_t>(Random::Mix(client) % _options.ips);
+            return _ips.Sample(_random);
+        }
+
+        // Длина - логнормальная: медиана около 60 символов, хвост до нескольких килобайт
+        void BuildDetail(std::string_view action, std::string_view prefix) {
+            const double length = std::exp(std::log(60.0) + 0.8 * _random.Normal());
+            const size_t filler = std::clamp<size_t>(static_cast<size_t>(length), 8, 4000);
+
+            _detail.clear();
+            _detail += prefix;
+            if (action == "login") {
+                _detail += "via ";
+                _detail += TERMINALS.Sample(_random);
+                _detail += " build ";
+                _detail += std::to_string(4000 + _random.Below(200));
+                _detail += ' ';
+            }
+
+            const size_t offset = _random.Below(static_cast<uint32_t>(_corpus.size() - filler));
+            _detail += std::string_view(_corpus).substr(offset, filler);
+        }
+
+        logfiles::LogRowView MakeRow(int64_t           time,
+                                     std::string_view  time_text,
+                                     const PendingRow& row) {
+            logfiles::LogRowView log;
+            log.time       = time;
+            log.time_text  = time_text;
+            log.actor_type = ACTOR_TYPES[static_cast<size_t>(row.actor)];
+
+            const bool is_failed = _random.Uniform() < _options.error_ratio;
+
+            switch (row.actor) {
+                case Actor::Client: {
+                    const uint32_t client = _clients.Sample(_random);
+                    log.actor_id          = _client_ids[client];
+                    log.action            = CLIENT_ACTIONS.Sample(_random);
+                    log.source            = _ip_addresses[ClientIp(client)];
+                    break;
+                }
+                case Actor::Manager:
+                    log.actor_id = _manager_ids[_managers.Sample(_random)];
+                    log.action   = MANAGER_ACTIONS.Sample(_random);
+                    log.source   = _ip_addresses[_ips.Sample(_random)];
+                    break;
+                case Actor::System:
+                    log.source   = SYSTEM_SOURCES.Sample(_random);
+                    log.actor_id = log.source;
+                    log.action   = SYSTEM_ACTIONS.Sample(_random);
+                    break;
+                case Actor::Flood: {
+                    const Flood& flood = _floods[row.flood];
+                    log.actor_id       = _client_ids[flood.client];
+                    log.action         = FLOOD_ACTIONS.Sample(_random);
+                    log.status         = FLOOD_STATUSES.Sample(_random);
+                    log.source         = _ip_addresses[flood.ip];
+                    BuildDetail(log.action, "rate limit: ");
+                    log.detail = _detail;
+                    return log;
+                }
+            }
+
+            log.status = is_failed ? FAILED_STATUSES.Sample(_random)
+                                   : NORMAL_STATUSES.Sample(_random);
+            BuildDetail(log.action, "");
+            log.detail = _detail;
+            return log;
+        }
+    };
+
+    void PrintUsage() {
+        std::fprintf(stderr,
+                     "usage: log_generator [--ndjson PATH] [--snapshot PATH] [--start UNIX]\n"
+                     "                     [--days N] [--rows N] [--client-rate N]\n"
+                     "                     [--manager-rate N] [--system-rate N] [--clients N]\n"
+                     "                     [--managers N] [--ips N] [--zipf S]\n"
+                     "                     [--error-ratio R] [--floods-per-day N]\n"
+                     "                     [--flood-rows N] [--seed N]\n");
+    }
+
+    // false - неизвестный ключ или ключ без значения
+    bool ParseOptions(int argc, char** argv, GeneratorOptions* options) {
+        for (int i = 1; i < argc; i += 2) {
+            if (i + 1 >= argc)
+                return false;
+
+            const std::string_view name  = argv[i];
+            const char*            value = argv[i + 1];
+
+            if (name == "--ndjson") {
+                options->ndjson_path = value;
+            } else if (name == "--snapshot") {
+                options->snapshot_path = value;
+            } else if (name == "--start") {
+                options->start = std::strtoll(value, nullptr, 10);
+            } else if (name == "--days") {
+                options->days = std::max<int64_t>(std::strtoll(value, nullptr, 10), 1);
+            } else if (name == "--rows") {
+                options->rows = std::strtod(value, nullptr);
+            } else if (name == "--client-rate") {
+                options->client_rate = std::strtod(value, nullptr);
+            } else if (name == "--manager-rate") {
+                options->manager_rate = std::strtod(value, nullptr);
+            } else if (name == "--system-rate") {
+                options->system_rate = std::strtod(value, nullptr);
+            } else if (name == "--clients") {
+                options->clients = std::max<uint32_t>(std::strtoul(value, nullptr, 10), 1);
+            } else if (name == "--managers") {
+                options->managers = std::max<uint32_t>(std::strtoul(value, nullptr, 10), 1);
+            } else if (name == "--ips") {
+                options->ips = std::max<uint32_t>(std::strtoul(value, nullptr, 10), 1);
+            } else if (name == "--zipf") {
+                options->zipf = std::strtod(value, nullptr);
+            } else if (name == "--error-ratio") {
+                options->error_ratio = std::clamp(std::strtod(value, nullptr), 0.0, 1.0);
+            } else if (name == "--floods-per-day") {
+                options->floods_per_day = std::strtod(value, nullptr);
+            } else if (name == "--flood-rows") {
+                options->flood_rows = std::strtod(value, nullptr);
+            } else if (name == "--seed") {
+                options->seed = std::strtoull(value, nullptr, 10);
+            } else {
+                return false;
+            }
+        }
+
+        return !options->ndjson_path.empty() || !options->snapshot_path.empty();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    if (!ParseOptions(argc, argv, &options)) {
+        PrintUsage();
+        return 2;
+    }
+
+    // --rows: все потоки масштабируются одинаково, пропорции типов сохраняются
+    if (options.rows > 0) {
+        const double scale = options.rows / ExpectedRows(options);
+        options.client_rate *= scale;
+        options.manager_rate *= scale;
+        options.system_rate *= scale;
+        options.flood_rows *= scale;
+    }
+
+    try {
+        std::optional<logfiles::NdjsonWriter>        ndjson;
+        std::optional<snapshots::LogSnapshotWriter> snapshot;
+        if (!options.ndjson_path.empty()) {
+            ndjson.emplace(options.ndjson_path);
+        }
+        if (!options.snapshot_path.empty()) {
+            snapshot.emplace(options.snapshot_path);
+        }
+
+        const auto started = std::chrono::steady_clock::now();
+
+        LogGenerator   generator(options);
+        const uint64_t rows = generator.Run([&](const logfiles::LogRowView& row) {
+            if (ndjson) {
+                ndjson->Write(row);
+            }
+            if (snapshot) {
+                snapshot->Add(row);
+            }
+        });
+
+        if (ndjson) {
+            ndjson->Flush();
+        }
+        if (snapshot) {
+            snapshot->Finish();
+        }
+
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::printf("%llu rows over %lld days in %.1f s (%.0f rows/s)\n",
+                    static_cast<unsigned long long>(rows),
+                    static_cast<long long>(options.days),
+                    seconds,
+                    static_cast<double>(rows) / seconds);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "log_generator: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+// Запуск собранного плагина без торгового сервера: libDailyLogsReport.so загружается через
+// dlopen, хостом служит FileServer поверх файла log_generator, запрос выполняется N раз.
+// Выводятся распределение времени CreateReport, размер ответа и пиковый RSS.
+//
+//   report_runner (--logs PATH | --capture PATH) [--plugin PATH]
+//                 [--request JSON | --request-file PATH]
+//                 [--iterations N] [--warmup N] [--destroy-each] [--output PATH]
+//
+// --capture воспроизводит запись DAILY_LOGS_CAPTURE_DIR (capture-*.json): хостом служит
+// ReplayServer с записанными ответами GetLogs, запрос по умолчанию - записанный
+//
+// Под профилировщиком: perf record -g report_runner ..., heaptrack report_runner ...
+// Плагин не выгружается до выхода, чтобы профилировщики символизировали его адреса
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <memory>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <vector>
+
+#include "ReportServerInterface.h"
+#include "common/FileServer.h"
+#include "common/LogFiles.h"
+#include "common/ReplayServer.h"
+
+#ifndef DAILY_LOGS_PLUGIN_PATH
+#define DAILY_LOGS_PLUGIN_PATH "libDailyLogsReport.so"
+#endif
+
+namespace {
+    // Точки входа плагина, как их объявляет PluginInterface.h
+    using GetReportApiVersionFunction = int (*)();
+    using DestroyReportFunction       = void (*)();
+
+    using ReportFunction = void (*)(rapidjson::Value&                   request,
+                                    rapidjson::Value&                   response,
+                                    rapidjson::Document::AllocatorType& allocator,
+                                    ReportServerInterface*              server);
+
+    struct RunnerOptions {
+        std::string plugin_path = DAILY_LOGS_PLUGIN_PATH;
+        std::string logs_path;
+        std::string capture_path;
+        std::string request = R"({"from":1700006400,"to":1700092799})";
+        std::string output_path;
+        size_t      iterations      = 10;
+        size_t      warmup          = 1;
+        bool        is_destroy_each = false; // холодный старт: DestroyReport после каждого
+        bool        is_request_set  = false; // иначе с --capture - записанный запрос
+    };
+
+    struct Plugin {
+        GetReportApiVersionFunction get_api_version = nullptr;
+        ReportFunction              about           = nullptr;
+        ReportFunction              create          = nullptr;
+        DestroyReportFunction       destroy         = nullptr;
+    };
+
+    template <typename Function>
+    Function Resolve(void* library, const char* name) {
+        void* symbol = dlsym(library, name);
+        if (symbol == nullptr)
+            throw std::runtime_error(std::string("missing symbol ") + name);
+        return reinterpret_cast<Function>(symbol);
+    }
+
+    Plugin LoadPlugin(const std::string& path) {
+        void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (library == nullptr)
+            throw std::runtime_error(dlerror());
+
+        Plugin plugin;
+        plugin.get_api_version = Resolve<GetReportApiVersionFunction>(library,
+                                                                      "GetReportApiVersion");
+        plugin.about   = Resolve<ReportFunction>(library, "AboutReport");
+        plugin.create  = Resolve<ReportFunction>(library, "CreateReport");
+        plugin.destroy = Resolve<DestroyReportFunction>(library, "DestroyReport");
+        return plugin;
+    }
+
+    std::string Serialize(const rapidjson::Value& value) {
+        rapidjson::StringBuffer                    buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        value.Accept(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    // Пиковый RSS процесса; в Linux ru_maxrss - в килобайтах
+    long PeakRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    double Percentile(const std::vector<double>& sorted, double fraction) {
+        const size_t rank = static_cast<size_t>(fraction * static_cast<double>(sorted.size()));
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    void PrintUsage() {
+        std::fprintf(stderr,
+                     "usage: report_runner (--logs PATH | --capture PATH) [--plugin PATH]\n"
+                     "                     [--request JSON | --request-file PATH]\n"
+                     "                     [--iterations N] [--warmup N] [--destroy-each]\n"
+                     "                     [--output PATH]\n");
+    }
+
+    std::string ReadFile(const std::string& path) {
+        logfiles::FilePtr file = logfiles::OpenFile(path, "rb");
+
+        std::string text;
+        char        chunk[64 * 1024];
+        size_t      read = 0;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file.get())) > 0) {
+            text.append(chunk, read);
+        }
+        return text;
+    }
+
+    // false - неизвестный ключ или ключ без значения
+    bool ParseOptions(int argc, char** argv, RunnerOptions* options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view name = argv[i];
+
+            if (name == "--destroy-each") {
+                options->is_destroy_each = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+                return false;
+            const char* value = argv[++i];
+
+            if (name == "--plugin") {
+                options->plugin_path = value;
+            } else if (name == "--logs") {
+                options->logs_path = value;
+            } else if (name == "--capture") {
+                options->capture_path = value;
+            } else if (name == "--request") {
+                options->request        = value;
+                options->is_request_set = true;
+            } else if (name == "--request-file") {
+                options->request        = ReadFile(value);
+                options->is_request_set = true;
+            } else if (name == "--iterations") {
+                options->iterations = std::max<size_t>(std::strtoul(value, nullptr, 10), 1);
+            } else if (name == "--warmup") {
+                options->warmup = std::strtoul(value, nullptr, 10);
+            } else if (name == "--output") {
+                options->output_path = value;
+            } else {
+                return false;
+            }
+        }
+
+        return options->logs_path.empty() != options->capture_path.empty();
+    }
+
+    int Run(const RunnerOptions& options) {
+        const long rss_before_logs = PeakRssKb();
+
+        const auto loading = std::chrono::steady_clock::now();
+
+        std::unique_ptr<StubServer> server;
+        ReplayServer*               replay       = nullptr;
+        size_t                      rows         = 0;
+        std::string                 request_text = options.request;
+        if (!options.capture_path.empty()) {
+            auto replay_server = std::make_unique<ReplayServer>(options.capture_path);
+            replay             = replay_server.get();
+            rows               = replay->Size();
+            if (!options.is_request_set) {
+                request_text = Serialize(replay->Request());
+            }
+            std::printf("capture: %zu GetLogs calls\n", replay->Calls());
+            server = std::move(replay_server);
+        } else {
+            auto file_server = std::make_unique<FileServer>(options.logs_path);
+            rows             = file_server->Size();
+            server           = std::move(file_server);
+        }
+
+        std::printf("logs: %zu rows loaded in %.2f s, peak RSS %ld MB\n",
+                    rows,
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - loading)
+                        .count(),
+                    PeakRssKb() / 1024);
+
+        const Plugin plugin = LoadPlugin(options.plugin_path);
+
+        rapidjson::Document request;
+        request.Parse(request_text.c_str());
+        if (request.HasParseError() || !request.IsObject())
+            throw std::runtime_error("request is not a JSON object");
+
+        {
+            rapidjson::Document about;
+            about.SetObject();
+            plugin.about(request, about, about.GetAllocator(), server.get());
+            std::printf("plugin: %s, API %d\n",
+                        about.HasMember("name") ? about["name"].GetString() : "?",
+                        plugin.get_api_version());
+        }
+
+        std::vector<double> latencies_ms;
+        size_t              response_bytes = 0;
+        size_t              partial        = 0;
+        std::string         last_response;
+
+        for (size_t i = 0; i < options.warmup + options.iterations; ++i) {
+            rapidjson::Document response;
+            response.SetObject();
+
+            const auto started = std::chrono::steady_clock::now();
+            plugin.create(request, response, response.GetAllocator(), server.get());
+            const double milliseconds = std::chrono::duration<double, std::milli>(
+                                            std::chrono::steady_clock::now() - started)
+                                            .count();
+
+            if (options.is_destroy_each) {
+                plugin.destroy();
+            }
+
+            if (i < options.warmup)
+                continue;
+
+            latencies_ms.push_back(milliseconds);
+            last_response  = Serialize(response);
+            response_bytes = last_response.size();
+            partial += response.HasMember("partial") ? 1 : 0;
+        }
+
+        plugin.destroy();
+
+        std::vector<double> sorted = latencies_ms;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0;
+        for (const double latency : sorted) {
+            total += latency;
+        }
+
+        std::printf("CreateReport x%zu (warmup %zu%s): min %.2f  p50 %.2f  p90 %.2f  p99 %.2f  "
+                    "max %.2f  mean %.2f ms\n",
+                    sorted.size(),
+                    options.warmup,
+                    options.is_destroy_each ? ", DestroyReport each" : "",
+                    sorted.front(),
+                    Percentile(sorted, 0.5),
+                    Percentile(sorted, 0.9),
+                    Percentile(sorted, 0.99),
+                    sorted.back(),
+                    total / static_cast<double>(sorted.size()));
+        std::printf("response: %zu bytes, partial %zu of %zu\n",
+                    response_bytes,
+                    partial,
+                    sorted.size());
+        std::printf("peak RSS: %ld MB (%ld MB before loading logs)\n",
+                    PeakRssKb() / 1024,
+                    rss_before_logs / 1024);
+        if (replay != nullptr) {
+            std::printf("replay: %zu GetLogs calls not in the capture\n", replay->Misses());
+        }
+
+        if (!options.output_path.empty()) {
+            logfiles::FilePtr output = logfiles::OpenFile(options.output_path, "wb");
+            std::fwrite(last_response.data(), 1, last_response.size(), output.get());
+        }
+
+        return 0;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        RunnerOptions options;
+        if (!ParseOptions(argc, argv, &options)) {
+            PrintUsage();
+            return 2;
+        }
+        return Run(options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "report_runner: %s\n", e.what());
+        return 1;
+    }
+}